@@ -0,0 +1,219 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engine/audiokernels.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cfenv>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+using Fooyin::Audio::Kernels::Level;
+
+constexpr int Channels = 2;
+constexpr int Frames   = 4096;
+constexpr auto Samples = static_cast<size_t>(Channels * Frames);
+
+std::vector<float> randomSamples()
+{
+    std::mt19937 gen{42};
+    std::uniform_real_distribution<float> dist{-1.0F, 1.0F};
+
+    std::vector<float> samples(Samples);
+    std::ranges::generate(samples, [&]() { return dist(gen); });
+    return samples;
+}
+
+// The per-sample implementations the kernels replaced
+void legacyInterleave(uint8_t** in, std::byte* out, int channels, int frames, int bps)
+{
+    for(int i{0}; i < frames; ++i) {
+        for(int ch{0}; ch < channels; ++ch) {
+            const auto inOffset  = i * bps;
+            const auto outOffset = (i * channels + ch) * bps;
+            std::memmove(out + outOffset, in[ch] + inOffset, bps);
+        }
+    }
+}
+
+void legacyFloatToS16(const std::byte* in, std::byte* out, size_t count)
+{
+    for(size_t i{0}; i < count; ++i) {
+        float inSample;
+        std::memcpy(&inSample, in + (i * sizeof(float)), sizeof(float));
+
+        const int prevRoundingMode = std::fegetround();
+        std::fesetround(FE_TONEAREST);
+        int intSample = static_cast<int>(std::lrint(inSample * 0x8000));
+        intSample     = std::clamp(intSample, -32768, 32767);
+        std::fesetround(prevRoundingMode);
+
+        const auto outSample = static_cast<int16_t>(intSample);
+        std::memcpy(out + (i * sizeof(int16_t)), &outSample, sizeof(int16_t));
+    }
+}
+
+template <typename T>
+void legacyAdjustVolume(std::byte* data, size_t bytes, double volume)
+{
+    for(size_t i{0}; i < bytes; i += sizeof(T)) {
+        T sample;
+        std::memcpy(&sample, data + i, sizeof(T));
+        sample *= volume;
+        std::memcpy(data + i, &sample, sizeof(T));
+    }
+}
+
+void setLevel(benchmark::State& state)
+{
+    Fooyin::Audio::Kernels::setLevel(static_cast<Level>(state.range(0)));
+    if(Fooyin::Audio::Kernels::level() != static_cast<Level>(state.range(0))) {
+        state.SkipWithError("Instruction set not supported");
+    }
+}
+
+void BM_InterleaveLegacy(benchmark::State& state)
+{
+    std::vector<float> left  = randomSamples();
+    std::vector<float> right = randomSamples();
+    std::vector<std::byte> out(Samples * sizeof(float));
+    std::array<uint8_t*, 2> planes{reinterpret_cast<uint8_t*>(left.data()), reinterpret_cast<uint8_t*>(right.data())};
+
+    for(auto _ : state) {
+        legacyInterleave(planes.data(), out.data(), Channels, Frames, sizeof(float));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * Frames);
+}
+
+void BM_Interleave(benchmark::State& state)
+{
+    setLevel(state);
+
+    std::vector<float> left  = randomSamples();
+    std::vector<float> right = randomSamples();
+    std::vector<std::byte> out(Samples * sizeof(float));
+    std::array<const uint8_t*, 2> planes{reinterpret_cast<const uint8_t*>(left.data()),
+                                         reinterpret_cast<const uint8_t*>(right.data())};
+
+    for(auto _ : state) {
+        Fooyin::Audio::Kernels::interleave(planes.data(), out.data(), Channels, Frames, sizeof(float));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * Frames);
+}
+
+void BM_FloatToS16Legacy(benchmark::State& state)
+{
+    const std::vector<float> in = randomSamples();
+    std::vector<int16_t> out(Samples);
+
+    for(auto _ : state) {
+        legacyFloatToS16(reinterpret_cast<const std::byte*>(in.data()), reinterpret_cast<std::byte*>(out.data()),
+                         Samples);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Samples));
+}
+
+void BM_FloatToS16(benchmark::State& state)
+{
+    setLevel(state);
+
+    const std::vector<float> in = randomSamples();
+    std::vector<int16_t> out(Samples);
+
+    for(auto _ : state) {
+        Fooyin::Audio::Kernels::floatToS16(in.data(), out.data(), Samples);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Samples));
+}
+
+void BM_ScaleS16Legacy(benchmark::State& state)
+{
+    std::vector<int16_t> data(Samples, 12345);
+
+    for(auto _ : state) {
+        legacyAdjustVolume<int16_t>(reinterpret_cast<std::byte*>(data.data()), Samples * sizeof(int16_t), 0.999);
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Samples));
+}
+
+void BM_ScaleS16(benchmark::State& state)
+{
+    setLevel(state);
+
+    std::vector<int16_t> data(Samples, 12345);
+
+    for(auto _ : state) {
+        Fooyin::Audio::Kernels::scaleS16(data.data(), Samples, 0.999F);
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Samples));
+}
+
+void BM_ScaleFloatLegacy(benchmark::State& state)
+{
+    std::vector<float> data = randomSamples();
+
+    for(auto _ : state) {
+        legacyAdjustVolume<float>(reinterpret_cast<std::byte*>(data.data()), Samples * sizeof(float), 0.999);
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Samples));
+}
+
+void BM_ScaleFloat(benchmark::State& state)
+{
+    setLevel(state);
+
+    std::vector<float> data = randomSamples();
+
+    for(auto _ : state) {
+        Fooyin::Audio::Kernels::scaleFloat(data.data(), Samples, 0.999F);
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * Samples));
+}
+
+void levelArgs(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgName("level");
+    for(const Level level : {Level::Scalar, Level::SSE2, Level::AVX2}) {
+        bench->Arg(static_cast<int64_t>(level));
+    }
+}
+} // namespace
+
+BENCHMARK(BM_InterleaveLegacy);
+BENCHMARK(BM_Interleave)->Apply(levelArgs);
+BENCHMARK(BM_FloatToS16Legacy);
+BENCHMARK(BM_FloatToS16)->Apply(levelArgs);
+BENCHMARK(BM_ScaleS16Legacy);
+BENCHMARK(BM_ScaleS16)->Apply(levelArgs);
+BENCHMARK(BM_ScaleFloatLegacy);
+BENCHMARK(BM_ScaleFloat)->Apply(levelArgs);
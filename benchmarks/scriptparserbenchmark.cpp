@@ -0,0 +1,114 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/scripting/scriptparser.h>
+#include <core/track.h>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+
+#ifdef __GLIBC__
+// Counts every heap allocation in the process, including those made by Qt containers,
+// by interposing the C allocator and forwarding to glibc's implementation.
+namespace {
+std::atomic<uint64_t> allocationCount{0};
+} // namespace
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+
+#define FOOYIN_COUNT_ALLOCATIONS
+#endif
+
+namespace {
+// Scripts shaped like the default playlist columns and grouping
+constexpr auto Scripts = std::to_array<const char*>({
+    "%title%",
+    "$num(%track%,2). %title%",
+    "[%albumartist% - ]%album%[ (%year%)]",
+    "$if2(%albumartist%,%artist%) - $if(%disc%,Disc %disc% - )$num(%track%,2)",
+    "$upper($left(%album%,1))$lower($right(%album%,5))",
+});
+
+Fooyin::Track syntheticTrack()
+{
+    Fooyin::Track track{QStringLiteral("/music/Artist/Album/01.flac")};
+    track.setTitle(QStringLiteral("Title"));
+    track.setArtists({QStringLiteral("Artist")});
+    track.setAlbumArtists({QStringLiteral("Album Artist")});
+    track.setAlbum(QStringLiteral("Album Name"));
+    track.setTrackNumber(1);
+    track.setDiscNumber(1);
+    track.setDate(QStringLiteral("2001"));
+    return track;
+}
+
+void BM_EvaluateScript(benchmark::State& state)
+{
+    Fooyin::ScriptParser parser;
+    const auto script = parser.parse(QString::fromLatin1(Scripts.at(static_cast<size_t>(state.range(0)))));
+    const auto track  = syntheticTrack();
+
+    // Warm up per-thread scratch storage, which is only allocated once
+    benchmark::DoNotOptimize(parser.evaluate(script, track));
+
+#ifdef FOOYIN_COUNT_ALLOCATIONS
+    const uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+#endif
+
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(parser.evaluate(script, track));
+    }
+
+#ifdef FOOYIN_COUNT_ALLOCATIONS
+    const uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    state.counters["allocs/eval"]
+        = benchmark::Counter(static_cast<double>(allocations) / static_cast<double>(state.iterations()));
+#endif
+
+    state.SetLabel(Scripts.at(static_cast<size_t>(state.range(0))));
+    state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(BM_EvaluateScript)->DenseRange(0, static_cast<int>(Scripts.size()) - 1);
@@ -0,0 +1,87 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "database/database.h"
+#include "database/dbschema.h"
+#include "database/trackdatabase.h"
+
+#include <core/track.h>
+#include <utils/database/dbconnectionhandler.h>
+#include <utils/database/dbconnectionpool.h>
+#include <utils/database/dbconnectionprovider.h>
+
+#include <QTemporaryDir>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+Fooyin::TrackList newTracks(int count)
+{
+    Fooyin::TrackList tracks;
+    tracks.reserve(count);
+
+    for(int i{0}; i < count; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/Artist %1/Album %2/%3.flac").arg(i / 100).arg(i / 10).arg(i)};
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setArtists({QStringLiteral("Artist %1").arg(i / 100)});
+        track.setAlbum(QStringLiteral("Album %1").arg(i / 10));
+        track.setTrackNumber(i % 10 + 1);
+        track.setDuration(180000);
+        track.setLibraryId(1);
+        track.generateHash();
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+// Stores tracks which aren't in the database yet, as after scanning a new library
+void BM_StoreNewTracks(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    int run{0};
+
+    for(auto _ : state) {
+        state.PauseTiming();
+
+        const Fooyin::DbConnection::DbParams params{.type     = QStringLiteral("QSQLITE"),
+                                                    .filePath = dir.filePath(QStringLiteral("%1.db").arg(run))};
+        auto dbPool = Fooyin::DbConnectionPool::create(params, QStringLiteral("bench-%1").arg(run++));
+
+        const Fooyin::DbConnectionHandler connectionHandler{dbPool};
+        const Fooyin::DbConnectionProvider dbProvider{dbPool};
+
+        Fooyin::DbSchema schema{dbProvider};
+        schema.upgradeDatabase(Fooyin::Database::CurrentSchemaVersion, QStringLiteral("://dbschema.xml"));
+
+        Fooyin::TrackDatabase trackDatabase;
+        trackDatabase.initialise(dbProvider);
+
+        Fooyin::TrackList tracks = newTracks(static_cast<int>(state.range(0)));
+
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(trackDatabase.storeTracks(tracks));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(BM_StoreNewTracks)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,93 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/library/tracksort.h>
+#include <core/track.h>
+
+#include <QCollator>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+// Sort strings shaped like the default library sort: artist, album, disc and track
+Fooyin::TrackList syntheticTracks(int count)
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> artistDist{0, count / 100};
+    std::uniform_int_distribution<int> albumDist{0, 9};
+    std::uniform_int_distribution<int> trackDist{1, 20};
+
+    Fooyin::TrackList tracks;
+    tracks.reserve(count);
+
+    for(int i{0}; i < count; ++i) {
+        Fooyin::Track track{QStringLiteral("/music/%1.flac").arg(i)};
+        track.setSort(QStringLiteral("Artist %1 - Album %2 - 1 - %3 - Title")
+                          .arg(artistDist(gen))
+                          .arg(albumDist(gen))
+                          .arg(trackDist(gen)));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+// The comparison based sort replaced by collation keys
+Fooyin::TrackList legacySortTracks(const Fooyin::TrackList& tracks)
+{
+    Fooyin::TrackList sortedTracks{tracks};
+
+    QCollator collator;
+    collator.setNumericMode(true);
+
+    std::ranges::sort(sortedTracks, [&collator](const Fooyin::Track& lhs, const Fooyin::Track& rhs) {
+        return collator.compare(lhs.sort(), rhs.sort()) < 0;
+    });
+
+    return sortedTracks;
+}
+
+void BM_LegacySortTracks(benchmark::State& state)
+{
+    const auto tracks = syntheticTracks(static_cast<int>(state.range(0)));
+
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(legacySortTracks(tracks));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SortTracks(benchmark::State& state)
+{
+    const auto tracks = syntheticTracks(static_cast<int>(state.range(0)));
+
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(Fooyin::Sorting::sortTracks(tracks));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(BM_LegacySortTracks)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortTracks)->Arg(100000)->Arg(500000)->Arg(1000000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,93 @@
+/*
+ * Fooyin
+ * Copyright © 2023, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "library/trackstore.h"
+
+#include <core/track.h>
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <random>
+#include <unistd.h>
+
+namespace {
+// Resident set size in MiB, read from /proc
+double residentMemory()
+{
+    std::ifstream statm{"/proc/self/statm"};
+    long pages{0};
+    long resident{0};
+    statm >> pages >> resident;
+    return static_cast<double>(resident) * static_cast<double>(::sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+// Each string is built separately, as when read from tags or the database
+Fooyin::TrackList syntheticTracks(int count)
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> artistDist{0, count / 100};
+    std::uniform_int_distribution<int> albumDist{0, 9};
+    std::uniform_int_distribution<int> genreDist{0, 49};
+
+    Fooyin::TrackList tracks;
+    tracks.reserve(count);
+
+    for(int i{0}; i < count; ++i) {
+        const int artist = artistDist(gen);
+        const int album  = albumDist(gen);
+
+        Fooyin::Track track{QStringLiteral("/music/Artist %1/Album %2/%3.flac").arg(artist).arg(album).arg(i)};
+        track.setId(i);
+        track.setTitle(QStringLiteral("Title %1").arg(i));
+        track.setArtists({QStringLiteral("Artist %1").arg(artist)});
+        track.setAlbumArtists({QStringLiteral("Artist %1").arg(artist)});
+        track.setAlbum(QStringLiteral("Album %1 by Artist %2").arg(album).arg(artist));
+        track.setGenres({QStringLiteral("Genre %1").arg(genreDist(gen))});
+        track.setDate(QStringLiteral("%1").arg(1970 + (artist % 50)));
+        track.addExtraTag(QStringLiteral("LABEL"), QStringLiteral("Label %1").arg(artist % 200));
+        tracks.push_back(track);
+    }
+
+    return tracks;
+}
+
+// Reports memory used by the tracks as loaded, and once stored in the library
+void BM_TrackStoreMemory(benchmark::State& state)
+{
+    for(auto _ : state) {
+        const double baseline = residentMemory();
+
+        auto tracks = std::make_unique<Fooyin::TrackList>(syntheticTracks(static_cast<int>(state.range(0))));
+        const double loaded = residentMemory();
+
+        auto store = std::make_unique<Fooyin::TrackStore>();
+        store->setTracks(*tracks);
+        tracks.reset();
+        const double stored = residentMemory();
+
+        state.counters["loaded_mib"] = loaded - baseline;
+        state.counters["stored_mib"] = stored - baseline;
+
+        benchmark::DoNotOptimize(store->size());
+    }
+}
+} // namespace
+
+BENCHMARK(BM_TrackStoreMemory)->Arg(1000000)->Iterations(1)->Unit(benchmark::kMillisecond);
@@ -20,6 +20,7 @@ function (fooyin_print_summary)
   message(STATUS "Options:")
   message(STATUS "  BUILD_SHARED_LIBS     : ${BUILD_SHARED_LIBS}")
   message(STATUS "  BUILD_TESTING         : ${BUILD_TESTING}")
+  message(STATUS "  BUILD_BENCHMARKS      : ${BUILD_BENCHMARKS}")
   message(STATUS "  BUILD_PLUGINS         : ${BUILD_PLUGINS}")
   message(STATUS "  BUILD_TRANSLATIONS    : ${BUILD_TRANSLATIONS}")
   message(STATUS "  BUILD_CCACHE          : ${BUILD_CCACHE}")
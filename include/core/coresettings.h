@@ -41,6 +41,10 @@ enum CoreSettings : uint32_t
     GaplessPlayback     = 10 | Type::Bool,
     Language            = 11 | Type::String,
     BufferLength        = 12 | Type::Int,
+    ReplayGainMode      = 13 | Type::Int,
+    ReplayGainPreAmp    = 14 | Type::Double,
+    ReplayGainNoClip    = 15 | Type::Bool,
+    PreloadTime         = 16 | Type::Int,
 };
 Q_ENUM_NS(CoreSettings)
 } // namespace Fooyin::Settings::Core
@@ -67,6 +67,13 @@ public:
     void fillRemainingWithSilence();
     void adjustVolumeOfSamples(double volume);
 
+    /*!
+     * Returns the total number of heap allocations made for buffer data.
+     * @note storage of released buffers is recycled, so this should stay
+     * constant during steady-state playback.
+     */
+    [[nodiscard]] static uint64_t allocationCount();
+
 private:
     struct Private;
     QExplicitlySharedDataPointer<Private> p;
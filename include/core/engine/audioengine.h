@@ -43,6 +43,13 @@ enum TrackStatus
     InvalidTrack
 };
 
+enum class ReplayGainType
+{
+    Disabled,
+    Track,
+    Album
+};
+
 class FYCORE_EXPORT AudioEngine : public QObject
 {
     Q_OBJECT
@@ -55,7 +62,12 @@ public:
     virtual void seek(uint64_t pos) = 0;
 
     virtual void changeTrack(const Track& track) = 0;
-    virtual void setState(PlaybackState state)   = 0;
+    /*!
+     * Opens and starts decoding @p track ahead of time, as it's expected to follow the current track.
+     * If the formats match, it will be played without a gap once the current track ends.
+     */
+    virtual void prepareNextTrack(const Track& track) = 0;
+    virtual void setState(PlaybackState state)        = 0;
 
     virtual void play()  = 0;
     virtual void pause() = 0;
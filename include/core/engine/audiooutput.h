@@ -24,6 +24,8 @@
 
 #include <QString>
 
+#include <functional>
+
 namespace Fooyin {
 struct OutputState
 {
@@ -40,6 +42,13 @@ struct OutputDevice
 
 using OutputDevices = std::vector<OutputDevice>;
 
+/*!
+ * Fills @p data with up to @p frames of rendered audio, padding any shortfall with silence.
+ * @returns the number of frames of audio written (excluding padding).
+ * @note this is safe to call from a real-time thread; it never blocks or allocates.
+ */
+using AudioSource = std::function<int(std::byte* data, int frames)>;
+
 /*!
  * An abstract interface for an audio output driver.
  */
@@ -71,6 +80,15 @@ public:
     /** Returns the current driver device being used for playback. */
     virtual QString device() const = 0;
 
+    /*!
+     *  Returns @c true if the driver requests audio from its own thread using the source
+     *  set with @fn setAudioSource, rather than having audio pushed to it with @fn write.
+     */
+    virtual bool pullsAudio() const
+    {
+        return false;
+    }
+
     /*!
      *  Returns @c true if the driver can handle volume changes internally.
      *  @note if @c false, a soft-volume will be applied to the samples when required.
@@ -100,10 +118,22 @@ public:
      * Writes the audio data contained in the @p buffer to the audio driver.
      * @note this will only be called if @fn initialised returns @c true.
      * @note this may be called before @fn start to prefill the buffer.
+     * @note this will never be called if @fn pullsAudio returns @c true.
      * @returns the number of samples written.
      */
-    virtual int write(const AudioBuffer& buffer) = 0;
-    virtual void setPaused(bool pause)           = 0;
+    virtual int write(const AudioBuffer& /*buffer*/)
+    {
+        return 0;
+    }
+
+    /*!
+     * Sets the @p source the driver should read audio from once started.
+     * @note this will only be called if @fn pullsAudio returns @c true.
+     * @note this will be called after @fn init and before @fn start.
+     */
+    virtual void setAudioSource(const AudioSource& /*source*/) { }
+
+    virtual void setPaused(bool pause) = 0;
 
     /*!
      * Set's the volume of the audio driver.
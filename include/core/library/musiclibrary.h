@@ -73,6 +73,13 @@ public:
     /** Scans all tracks in all libraries */
     virtual void rescanAll() = 0;
 
+    /*!
+     * Scans all tracks in all libraries, reading every file.
+     * A normal rescan skips directories which are unchanged since the last scan, so this is needed
+     * to pick up files edited in place by other programs while fooyin wasn't running.
+     */
+    virtual void rescanAllFull() = 0;
+
     /** Scans the tracks in @p library */
     virtual ScanRequest rescan(const LibraryInfo& library) = 0;
 
@@ -86,9 +93,18 @@ public:
     /** Returns all tracks for all libraries */
     [[nodiscard]] virtual TrackList tracks() const = 0;
 
+    /** Returns the track with @p id, or an invalid track if not found */
+    [[nodiscard]] virtual Track trackForId(int id) const = 0;
+
     /** Returns a TrackList containing each track (if) found with an id from @p ids  */
     [[nodiscard]] virtual TrackList tracksForIds(const TrackIds& ids) const = 0;
 
+    /** Returns a TrackList containing every track with a hash from @p hashes */
+    [[nodiscard]] virtual TrackList tracksForHashes(const QStringList& hashes) const = 0;
+
+    /** Returns a TrackList containing each track (if) found with a filepath from @p filepaths */
+    [[nodiscard]] virtual TrackList tracksForFilepaths(const QStringList& filepaths) const = 0;
+
     /** Updates the metdata in the database for @p tracks and writes metdata to files  */
     virtual void updateTrackMetadata(const TrackList& tracks) = 0;
 
@@ -88,6 +88,8 @@ public:
     void changeCurrentTrack(const PlaylistTrack& track);
     void updateCurrentTrackPlaylist(const Id& playlistId);
     void updateCurrentTrackIndex(int index);
+    /** Lets the engine prepare @p track, which is expected to be played after the current track. */
+    void preloadNextTrack(const Track& track);
 
     [[nodiscard]] PlaybackQueue playbackQueue() const;
 
@@ -116,6 +118,7 @@ signals:
     void positionMoved(uint64_t ms);
 
     void currentTrackChanged(const Track& track);
+    void nextTrackPreloading(const Track& track);
     void playlistTrackChanged(const PlaylistTrack& track);
     void trackPlayed(const Track& track);
 
@@ -26,6 +26,8 @@
 
 #include <QObject>
 
+#include <optional>
+
 namespace Fooyin {
 /*!
  * Represents a list of tracks for playback.
@@ -106,6 +108,7 @@ public:
 
 private:
     friend class PlaylistHandler;
+    friend class PlaylistDatabase;
 
     static std::unique_ptr<Playlist> create(const QString& name);
     static std::unique_ptr<Playlist> create(int dbId, const QString& name, int index);
@@ -120,9 +123,24 @@ private:
     void appendTracks(const TrackList& tracks);
     std::vector<int> removeTracks(const std::vector<int>& indexes);
 
+    /*!
+     * Replaces each track with the track of the same id in @p tracks, in place.
+     * @returns the sorted indexes of the tracks replaced.
+     */
+    std::vector<int> updateTracks(const TrackList& tracks);
+    /** Returns the sorted indexes of any tracks with the same id as one of @p tracks. */
+    [[nodiscard]] std::vector<int> indexesOfTracks(const TrackList& tracks) const;
+
     /** Removes all tracks, including all shuffle order history */
     void clear();
 
+    /*!
+     * Returns the ids of the tracks as last saved to or loaded from the database, so only
+     * changes since need to be saved. Returns std::nullopt if they aren't known.
+     */
+    [[nodiscard]] const std::optional<std::vector<int>>& savedTrackIds() const;
+    void setSavedTrackIds(std::optional<std::vector<int>> trackIds);
+
     struct Private;
     std::unique_ptr<Private> p;
 };
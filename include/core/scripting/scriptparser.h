@@ -35,11 +35,19 @@ struct ScriptError
 };
 using ErrorList = std::vector<ScriptError>;
 
+struct CompiledScript;
+
 struct ParsedScript
 {
     QString input;
     ExpressionList expressions;
     ErrorList errors;
+    /*!
+     * The expressions with variables and functions resolved against the registry of the
+     * parser which produced them. Shared between copies, and only valid for parsers using
+     * the same type of registry.
+     */
+    std::shared_ptr<const CompiledScript> program;
 
     [[nodiscard]] bool isValid() const
     {
@@ -47,6 +55,34 @@ struct ParsedScript
     }
 };
 
+/*!
+ * Holds the results of sub-expressions evaluated for a single track, so those
+ * shared between scripts are only evaluated once.
+ * Must be cleared before evaluating scripts for a different track.
+ */
+class FYCORE_EXPORT ScriptCache
+{
+public:
+    ScriptCache();
+    ~ScriptCache();
+
+    void clear();
+
+private:
+    friend class ScriptParser;
+
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+/*!
+ * Parses and evaluates scripts.
+ * Parsing is not thread-safe, but once parsed, a ParsedScript can be evaluated by
+ * any number of threads at once using the const evaluate overloads, as long as the
+ * registry doesn't hold per-evaluation state. A ScriptCache must not be shared between threads.
+ *
+ * Sub-expressions which don't depend on a track, such as $add(1,2), are evaluated once when parsed.
+ */
 class FYCORE_EXPORT ScriptParser
 {
 public:
@@ -59,13 +95,17 @@ public:
     ParsedScript parse(const QString& input, const TrackList& tracks);
 
     QString evaluate(const QString& input);
-    QString evaluate(const ParsedScript& input);
+    QString evaluate(const ParsedScript& input) const;
 
     QString evaluate(const QString& input, const Track& track);
-    QString evaluate(const ParsedScript& input, const Track& track);
+    QString evaluate(const ParsedScript& input, const Track& track) const;
+
+    /** Evaluates @p input for @p track, reusing sub-expression results from @p cache where possible. */
+    QString evaluate(const QString& input, const Track& track, ScriptCache& cache);
+    QString evaluate(const ParsedScript& input, const Track& track, ScriptCache& cache) const;
 
     QString evaluate(const QString& input, const TrackList& tracks);
-    QString evaluate(const ParsedScript& input, const TrackList& tracks);
+    QString evaluate(const ParsedScript& input, const TrackList& tracks) const;
 
     void clearCache();
 
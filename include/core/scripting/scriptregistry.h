@@ -27,10 +27,28 @@
 #include <QObject>
 
 namespace Fooyin {
+struct ScriptFunction;
+
 class FYCORE_EXPORT ScriptRegistry
 {
 public:
-    using FuncRet = std::variant<int, uint64_t, QString, QStringList>;
+    using FuncRet        = std::variant<int, uint64_t, QString, QStringList>;
+    using TrackValueFunc = FuncRet (*)(const Track&);
+
+    /*!
+     * A variable resolved when a script is parsed, so it can be read without looking it up by name.
+     * Neither set means the variable must be looked up through value() each time.
+     */
+    struct ResolvedVariable
+    {
+        TrackValueFunc accessor{nullptr};
+        QString extraTag;
+
+        [[nodiscard]] bool isValid() const
+        {
+            return accessor || !extraTag.isEmpty();
+        }
+    };
 
     ScriptRegistry();
     virtual ~ScriptRegistry();
@@ -45,6 +63,17 @@ public:
 
     virtual void setValue(const QString& var, const FuncRet& value, Track& track);
 
+    /*!
+     * Resolves @p var for direct access.
+     * @note subclasses which provide their own variables must return an invalid ResolvedVariable for them.
+     */
+    virtual ResolvedVariable resolveVariable(const QString& var) const;
+    /** Returns the function named @p func, or nullptr if not found. */
+    const ScriptFunction* resolveFunction(const QString& func) const;
+
+    ScriptResult value(const ResolvedVariable& var, const Track& track) const;
+    ScriptResult function(const ScriptFunction* func, const ScriptValueList& args) const;
+
 protected:
     template <typename NewCntr, typename Cntr>
     NewCntr containerCast(const Cntr& from) const
@@ -25,6 +25,8 @@
 #include <QSharedDataPointer>
 
 namespace Fooyin {
+class StringPool;
+
 /*!
  * Represents a music track and it's associated metadata.
  * Metadata which is not explicitly handled is accessed using Track::extraTags.
@@ -180,6 +182,12 @@ public:
     void setSort(const QString& sort);
     void clearWasModified();
 
+    /*!
+     * Replaces metadata commonly repeated across tracks (artists, album, genres etc.)
+     * with the equal strings held by @p pool, so they're only stored once.
+     */
+    void shareStrings(StringPool& pool);
+
     static QStringList supportedFileExtensions();
     static QStringList supportedMimeTypes();
 
@@ -113,6 +113,7 @@ constexpr auto LayoutEditing   = "View.LayoutEditing";
 constexpr auto QuickSetup      = "View.QuickSetup";
 constexpr auto About           = "Help.About";
 constexpr auto Rescan          = "Library.Rescan";
+constexpr auto RescanFull      = "Library.RescanFull";
 constexpr auto Stop            = "Playback.Stop";
 constexpr auto PlayPause       = "Playback.PlayPause";
 constexpr auto Next            = "Playback.Next";
@@ -21,7 +21,12 @@
 
 #include "fyutils_export.h"
 
+#include "dbquery.h"
+
 #include <QSqlDatabase>
+#include <QStringList>
+
+#include <unordered_map>
 
 namespace Fooyin {
 class FYUTILS_EXPORT DbConnection
@@ -33,6 +38,11 @@ public:
         QString connectOptions;
         QString hostName;
         QString filePath;
+        /*!
+         * Pragmas, such as "journal_mode = WAL", set on each connection opened by a DbConnectionPool.
+         * Foreign keys are always enabled.
+         */
+        QStringList pragmas;
     };
 
     DbConnection(const DbParams& params, const QString& connectionName);
@@ -51,7 +61,15 @@ public:
 
     [[nodiscard]] QSqlDatabase db() const;
 
+    /*!
+     * Returns a query for @p statement which is only prepared the first time it's used on this connection.
+     * Each statement is kept until the connection is closed, so this should only be used for fixed statements.
+     * @note if the cached query is still in use, a separately prepared query is returned.
+     */
+    DbQuery cachedQuery(const QString& statement);
+
 private:
     QString m_name;
+    std::unordered_map<QString, std::shared_ptr<QSqlQuery>> m_queries;
 };
 } // namespace Fooyin
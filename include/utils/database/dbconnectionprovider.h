@@ -31,8 +31,12 @@ public:
     explicit DbConnectionProvider(DbConnectionPoolPtr pool);
 
     [[nodiscard]] QSqlDatabase db() const;
+    /** Returns a query for @p statement from the cache of this thread's connection. */
+    [[nodiscard]] DbQuery cachedQuery(const QString& statement) const;
 
 private:
+    [[nodiscard]] DbConnection* threadConnection() const;
+
     DbConnectionPoolPtr m_connectionPool;
 };
 } // namespace Fooyin
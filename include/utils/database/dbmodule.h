@@ -37,6 +37,15 @@ public:
         return m_dbProvider.db();
     }
 
+    /*!
+     * Returns a query for @p statement which is prepared once per connection and reused after.
+     * Only use for statements which don't vary, as each one is kept until the connection closes.
+     */
+    [[nodiscard]] DbQuery cachedQuery(const QString& statement) const
+    {
+        return m_dbProvider.cachedQuery(statement);
+    }
+
 private:
     DbConnectionProvider m_dbProvider;
 };
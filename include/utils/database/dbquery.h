@@ -23,6 +23,9 @@
 
 #include <QSqlQuery>
 
+#include <memory>
+#include <optional>
+
 namespace Fooyin {
 class FYUTILS_EXPORT DbQuery
 {
@@ -39,6 +42,8 @@ public:
     DbQuery();
     DbQuery(const QSqlDatabase& database, const QString& statement);
 
+    ~DbQuery();
+
     DbQuery(const DbQuery& other)       = delete;
     DbQuery(DbQuery&& other)            = default;
     DbQuery& operator=(DbQuery&& other) = default;
@@ -47,6 +52,8 @@ public:
     [[nodiscard]] QSqlError lastError() const;
 
     void bindValue(const QString& placeholder, const QVariant& value);
+    /** Binds @p value to the next positional (?) placeholder. */
+    void addBindValue(const QVariant& value);
     [[nodiscard]] QString executedQuery() const;
     bool exec();
 
@@ -56,7 +63,16 @@ public:
     [[nodiscard]] QVariant value(int index) const;
 
 private:
-    QSqlQuery m_query;
+    friend class DbConnection;
+
+    explicit DbQuery(std::shared_ptr<QSqlQuery> cachedQuery);
+
+    [[nodiscard]] QSqlQuery& query();
+    [[nodiscard]] const QSqlQuery& query() const;
+
+    // Exactly one of these is set: uncached queries are owned, cached ones are shared with the connection
+    std::optional<QSqlQuery> m_query;
+    std::shared_ptr<QSqlQuery> m_cachedQuery;
     Status m_status;
 };
 } // namespace Fooyin
@@ -0,0 +1,125 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * A list of values which keeps their running totals, so a value can be changed
+ * and the sum of any prefix found in O(log n).
+ */
+template <typename T>
+class FenwickTree
+{
+public:
+    /** Replaces all values, rebuilding the tree in O(n). */
+    void assign(std::vector<T> values)
+    {
+        m_values = std::move(values);
+        m_tree.assign(m_values.size() + 1, T{});
+
+        for(size_t i{1}; i < m_tree.size(); ++i) {
+            m_tree[i] += m_values[i - 1];
+            const size_t parent = i + lowestBit(i);
+            if(parent < m_tree.size()) {
+                m_tree[parent] += m_tree[i];
+            }
+        }
+    }
+
+    void clear()
+    {
+        m_values.clear();
+        m_tree.clear();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return m_values.empty();
+    }
+
+    [[nodiscard]] int size() const
+    {
+        return static_cast<int>(m_values.size());
+    }
+
+    [[nodiscard]] T value(int index) const
+    {
+        return m_values.at(index);
+    }
+
+    void set(int index, T value)
+    {
+        const T delta   = value - m_values.at(index);
+        m_values[index] = value;
+
+        for(auto i = static_cast<size_t>(index) + 1; i < m_tree.size(); i += lowestBit(i)) {
+            m_tree[i] += delta;
+        }
+    }
+
+    /** Returns the sum of the first @p count values. */
+    [[nodiscard]] T prefixSum(int count) const
+    {
+        T sum{};
+        for(auto i = static_cast<size_t>(std::clamp(count, 0, size())); i > 0; i -= lowestBit(i)) {
+            sum += m_tree[i];
+        }
+        return sum;
+    }
+
+    [[nodiscard]] T total() const
+    {
+        return prefixSum(size());
+    }
+
+    /**
+     * Returns the index of the first value whose running total is greater than @p sum,
+     * or size() if there is none. With values laid end to end, this is the one covering @p sum.
+     * @note values must not be negative.
+     */
+    [[nodiscard]] int upperBound(T sum) const
+    {
+        size_t pos{0};
+
+        for(size_t step = std::bit_floor(m_values.size()); step > 0; step >>= 1) {
+            const size_t next = pos + step;
+            if(next < m_tree.size() && m_tree[next] <= sum) {
+                pos = next;
+                sum -= m_tree[next];
+            }
+        }
+
+        return static_cast<int>(pos);
+    }
+
+private:
+    static size_t lowestBit(size_t i)
+    {
+        return i & (~i + 1);
+    }
+
+    std::vector<T> m_values;
+    std::vector<T> m_tree;
+};
+} // namespace Fooyin
@@ -0,0 +1,53 @@
+/*
+ * Fooyin
+ * Copyright © 2023, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fyutils_export.h"
+
+#include <QSet>
+#include <QStringList>
+
+namespace Fooyin {
+/*!
+ * Deduplicates strings which are repeated across many objects.
+ * Interned strings share their data, so each distinct value is only stored once.
+ */
+class FYUTILS_EXPORT StringPool
+{
+public:
+    /** Returns a string equal to @p str, sharing its data with any previously interned equal string. */
+    QString intern(const QString& str);
+    /** Returns a list equal to @p strings, with the list and each of its strings shared. */
+    QStringList intern(const QStringList& strings);
+
+    /*!
+     * Removes strings and lists which are no longer used outside the pool.
+     * The pool only ever grows otherwise, so call this once values may have been replaced or removed.
+     */
+    void prune();
+
+    [[nodiscard]] size_t size() const;
+    void clear();
+
+private:
+    QSet<QString> m_strings;
+    QSet<QStringList> m_lists;
+};
+} // namespace Fooyin
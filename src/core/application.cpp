@@ -60,7 +60,7 @@ struct Application::Private
         : settingsManager{new SettingsManager(Core::settingsPath(), parent)}
         , coreSettings{settingsManager}
         , translations{settingsManager}
-        , database{new Database(parent)}
+        , database{new Database(settingsManager, parent)}
         , playerController{new PlayerController(settingsManager, parent)}
         , engine{playerController, settingsManager}
         , libraryManager{new LibraryManager(database->connectionPool(), settingsManager, parent)}
@@ -26,26 +26,85 @@
 #include <utils/paths.h>
 #include <utils/settings/settingsmanager.h>
 
+#include <QDebug>
 #include <QFileInfo>
 
-const auto CurrentSchemaVersion = 4;
+// Performance profile applied to each connection.
+// Each value can be overridden by setting the matching key in the settings file.
+constexpr auto JournalModeKey  = "Database/JournalMode";
+constexpr auto SynchronousKey  = "Database/Synchronous";
+constexpr auto MmapSizeKey     = "Database/MmapSize";
+constexpr auto CacheSizeKiBKey = "Database/CacheSizeKiB";
+
+constexpr auto DefaultJournalMode    = "WAL";
+constexpr auto DefaultSynchronous    = "NORMAL";
+constexpr qint64 DefaultMmapSize     = 256LL * 1024 * 1024;
+constexpr qint64 DefaultCacheSizeKiB = 16LL * 1024;
 
 namespace {
-Fooyin::DbConnection::DbParams dbConnectionParams()
+QString pragmaMode(Fooyin::SettingsManager* settings, const char* key, const char* defaultMode,
+                   const QStringList& allowedModes)
+{
+    const QString mode = settings->fileValue(QString::fromLatin1(key)).toString().toUpper();
+    if(mode.isEmpty()) {
+        return QString::fromLatin1(defaultMode);
+    }
+    if(!allowedModes.contains(mode)) {
+        qWarning() << "[DB] Ignoring invalid value for" << key << ":" << mode;
+        return QString::fromLatin1(defaultMode);
+    }
+    return mode;
+}
+
+qint64 pragmaSize(Fooyin::SettingsManager* settings, const char* key, qint64 defaultSize)
+{
+    const QVariant value = settings->fileValue(QString::fromLatin1(key));
+    if(!value.isValid()) {
+        return defaultSize;
+    }
+
+    bool ok{false};
+    const qint64 size = value.toLongLong(&ok);
+    if(!ok || size < 0) {
+        qWarning() << "[DB] Ignoring invalid value for" << key << ":" << value;
+        return defaultSize;
+    }
+    return size;
+}
+
+Fooyin::DbConnection::DbParams dbConnectionParams(Fooyin::SettingsManager* settings)
 {
     Fooyin::DbConnection::DbParams params;
     params.type           = QStringLiteral("QSQLITE");
     params.connectOptions = QStringLiteral("QSQLITE_OPEN_URI");
     params.filePath       = Fooyin::Utils::sharePath() + QStringLiteral("/fooyin.db");
 
+    // Write-ahead logging lets the library be scanned and read at the same time, and with it
+    // synchronous = NORMAL is still safe from corruption, only losing the last commits on power loss
+    const QString journalMode
+        = pragmaMode(settings, JournalModeKey, DefaultJournalMode,
+                     {QStringLiteral("DELETE"), QStringLiteral("TRUNCATE"), QStringLiteral("PERSIST"),
+                      QStringLiteral("MEMORY"), QStringLiteral("WAL"), QStringLiteral("OFF")});
+    const QString synchronous = pragmaMode(
+        settings, SynchronousKey, DefaultSynchronous,
+        {QStringLiteral("OFF"), QStringLiteral("NORMAL"), QStringLiteral("FULL"), QStringLiteral("EXTRA")});
+    const qint64 mmapSize     = pragmaSize(settings, MmapSizeKey, DefaultMmapSize);
+    const qint64 cacheSizeKiB = pragmaSize(settings, CacheSizeKiBKey, DefaultCacheSizeKiB);
+
+    params.pragmas = {QStringLiteral("journal_mode = %1").arg(journalMode),
+                      QStringLiteral("synchronous = %1").arg(synchronous),
+                      QStringLiteral("temp_store = MEMORY"),
+                      QStringLiteral("mmap_size = %1").arg(mmapSize),
+                      QStringLiteral("cache_size = -%1").arg(cacheSizeKiB)};
+
     return params;
 }
 } // namespace
 
 namespace Fooyin {
-Database::Database(QObject* parent)
+Database::Database(SettingsManager* settings, QObject* parent)
     : QObject{parent}
-    , m_dbPool(DbConnectionPool::create(dbConnectionParams(), QStringLiteral("fooyin")))
+    , m_dbPool(DbConnectionPool::create(dbConnectionParams(settings), QStringLiteral("fooyin")))
     , m_connectionHandler{m_dbPool}
     , m_status{Status::Ok}
 {
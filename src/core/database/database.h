@@ -25,6 +25,8 @@
 #include <QObject>
 
 namespace Fooyin {
+class SettingsManager;
+
 class Database : public QObject
 {
     Q_OBJECT
@@ -39,7 +41,14 @@ public:
         ConnectionError,
     };
 
-    explicit Database(QObject* parent = nullptr);
+    static constexpr int CurrentSchemaVersion = 6;
+
+    /*!
+     * Opens the database using the default performance profile, any part of which can be
+     * overridden in the settings file under the "Database" group (JournalMode, Synchronous,
+     * MmapSize in bytes and CacheSizeKiB).
+     */
+    explicit Database(SettingsManager* settings, QObject* parent = nullptr);
 
     [[nodiscard]] DbConnectionPoolPtr connectionPool() const;
 
@@ -20,6 +20,7 @@
 #include "librarydatabase.h"
 
 #include <utils/database/dbquery.h>
+#include <utils/database/dbtransaction.h>
 
 namespace Fooyin {
 bool LibraryDatabase::getAllLibraries(LibraryInfoMap& libraries)
@@ -43,6 +44,114 @@ bool LibraryDatabase::getAllLibraries(LibraryInfoMap& libraries)
     return true;
 }
 
+bool LibraryDatabase::getDirectories(int libraryId, LibraryDirectoryMap& directories)
+{
+    const QString statement
+        = QStringLiteral("SELECT Path, ModifiedDate, Inode FROM LibraryDirectories WHERE LibraryID = :id;");
+
+    DbQuery query{db(), statement};
+
+    query.bindValue(QStringLiteral(":id"), libraryId);
+
+    if(!query.exec()) {
+        return false;
+    }
+
+    while(query.next()) {
+        const QString path = query.value(0).toString();
+
+        LibraryDirectory directory;
+        directory.modifiedTime = query.value(1).toULongLong();
+        directory.inode        = query.value(2).toULongLong();
+
+        directories.emplace(path, directory);
+    }
+
+    return true;
+}
+
+bool LibraryDatabase::storeDirectories(int libraryId, const LibraryDirectoryMap& directories)
+{
+    if(libraryId < 0) {
+        return false;
+    }
+
+    DbTransaction transaction{db()};
+
+    if(!transaction) {
+        return false;
+    }
+
+    DbQuery removeQuery{db(), QStringLiteral("DELETE FROM LibraryDirectories WHERE LibraryID = :id;")};
+    removeQuery.bindValue(QStringLiteral(":id"), libraryId);
+
+    if(!removeQuery.exec()) {
+        return false;
+    }
+
+    const QString statement = QStringLiteral("INSERT INTO LibraryDirectories (LibraryID, Path, ModifiedDate, Inode) "
+                                             "VALUES (:id, :path, :modified, :inode);");
+
+    DbQuery query{db(), statement};
+
+    for(const auto& [path, directory] : directories) {
+        query.bindValue(QStringLiteral(":id"), libraryId);
+        query.bindValue(QStringLiteral(":path"), path);
+        query.bindValue(QStringLiteral(":modified"), static_cast<quint64>(directory.modifiedTime));
+        query.bindValue(QStringLiteral(":inode"), static_cast<quint64>(directory.inode));
+
+        if(!query.exec()) {
+            return false;
+        }
+    }
+
+    return transaction.commit();
+}
+
+bool LibraryDatabase::updateDirectories(int libraryId, const QString& root, const LibraryDirectoryMap& directories)
+{
+    if(libraryId < 0 || root.isEmpty()) {
+        return false;
+    }
+
+    DbTransaction transaction{db()};
+
+    if(!transaction) {
+        return false;
+    }
+
+    // Subdirectories sort between "root/" and "root0" ('0' follows '/'), which unlike LIKE
+    // isn't affected by wildcards in the path and can use the primary key
+    DbQuery removeQuery{db(), QStringLiteral("DELETE FROM LibraryDirectories WHERE LibraryID = :id AND "
+                                             "(Path = :root OR (Path >= :first AND Path < :last));")};
+    removeQuery.bindValue(QStringLiteral(":id"), libraryId);
+    removeQuery.bindValue(QStringLiteral(":root"), root);
+    removeQuery.bindValue(QStringLiteral(":first"), QString{root + u'/'});
+    removeQuery.bindValue(QStringLiteral(":last"), QString{root + u'0'});
+
+    if(!removeQuery.exec()) {
+        return false;
+    }
+
+    const QString statement = QStringLiteral("INSERT INTO LibraryDirectories (LibraryID, Path, ModifiedDate, Inode) "
+                                             "VALUES (:id, :path, :modified, :inode);");
+
+    DbQuery query{db(), statement};
+
+    for(const auto& [path, directory] : directories) {
+        query.bindValue(QStringLiteral(":id"), libraryId);
+        query.bindValue(QStringLiteral(":path"), path);
+        query.bindValue(QStringLiteral(":modified"), static_cast<quint64>(directory.modifiedTime));
+        query.bindValue(QStringLiteral(":inode"), static_cast<quint64>(directory.inode));
+
+        if(!query.exec()) {
+            return false;
+        }
+    }
+
+    return transaction.commit();
+}
+
 int LibraryDatabase::insertLibrary(const QString& path, const QString& name)
 {
     if(name.isEmpty() || path.isEmpty()) {
@@ -23,12 +23,36 @@
 
 #include <utils/database/dbmodule.h>
 
+#include <QString>
+
+#include <unordered_map>
+
 namespace Fooyin {
+/*!
+ * The state of a library directory when it was last scanned.
+ * A directory's modified time only changes when entries are added, removed or renamed,
+ * so a directory with the same stamp can be skipped without listing it.
+ */
+struct LibraryDirectory
+{
+    uint64_t modifiedTime{0};
+    uint64_t inode{0};
+
+    bool operator==(const LibraryDirectory& other) const = default;
+};
+using LibraryDirectoryMap = std::unordered_map<QString, LibraryDirectory>;
+
 class LibraryDatabase : public DbModule
 {
 public:
     bool getAllLibraries(LibraryInfoMap& libraries);
 
+    bool getDirectories(int libraryId, LibraryDirectoryMap& directories);
+    /** Replaces the stored directory index of the library with @p libraryId. */
+    bool storeDirectories(int libraryId, const LibraryDirectoryMap& directories);
+    /** Replaces the part of the stored directory index at or below @p root with @p directories. */
+    bool updateDirectories(int libraryId, const QString& root, const LibraryDirectoryMap& directories);
+
     int insertLibrary(const QString& path, const QString& name);
 
     bool removeLibrary(int id);
@@ -19,9 +19,47 @@
 
 #include "playlistdatabase.h"
 
+#include "playlisttracksdiff.h"
+
 #include <utils/database/dbquery.h>
 #include <utils/database/dbtransaction.h>
 
+#include <QDebug>
+
+#include <algorithm>
+#include <utility>
+
+// SQLite's lowest default limit on the number of bound values in a statement
+constexpr size_t MaxBoundValues = 999;
+// PlaylistID, TrackID and TrackIndex
+constexpr size_t PlaylistTrackValues = 3;
+constexpr size_t TracksPerInsert     = MaxBoundValues / PlaylistTrackValues;
+
+namespace {
+QString insertPlaylistTracksStatement(size_t count)
+{
+    QStringList rows;
+    rows.fill(QStringLiteral("(?,?,?)"), static_cast<qsizetype>(count));
+
+    return QStringLiteral("INSERT INTO PlaylistTracks (PlaylistID, TrackID, TrackIndex) VALUES %1;")
+        .arg(rows.join(u','));
+}
+
+std::vector<int> playlistTrackIds(const Fooyin::TrackList& tracks)
+{
+    std::vector<int> trackIds;
+    trackIds.reserve(tracks.size());
+
+    for(const auto& track : tracks) {
+        if(track.isValid() && track.isInDatabase()) {
+            trackIds.push_back(track.id());
+        }
+    }
+
+    return trackIds;
+}
+} // namespace
+
 namespace Fooyin {
 std::vector<PlaylistInfo> PlaylistDatabase::getAllPlaylists()
 {
@@ -49,7 +87,7 @@ std::vector<PlaylistInfo> PlaylistDatabase::getAllPlaylists()
     return playlists;
 }
 
-TrackList PlaylistDatabase::getPlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks)
+TrackList PlaylistDatabase::getPlaylistTracks(Playlist& playlist, const TrackIdMap& tracks)
 {
     return populatePlaylistTracks(playlist, tracks);
 }
@@ -75,31 +113,20 @@ int PlaylistDatabase::insertPlaylist(const QString& name, int index)
 
 bool PlaylistDatabase::savePlaylist(Playlist& playlist)
 {
-    bool updated{false};
-
-    if(playlist.modified()) {
-        const auto statement
-            = QStringLiteral("UPDATE Playlists SET Name = :name, PlaylistIndex = :index WHERE PlaylistID = :id;");
-
-        DbQuery query{db(), statement};
-
-        query.bindValue(QStringLiteral(":name"), playlist.name());
-        query.bindValue(QStringLiteral(":index"), playlist.index());
-        query.bindValue(QStringLiteral(":id"), playlist.dbId());
+    DbTransaction transaction{db()};
 
-        updated = query.exec();
+    if(!transaction) {
+        return false;
     }
 
-    if(playlist.tracksModified()) {
-        updated = insertPlaylistTracks(playlist.dbId(), playlist.tracks());
-    }
+    const bool saved = savePlaylistChanges(playlist);
 
-    if(updated) {
-        playlist.resetFlags();
-        return true;
+    if(!transaction.commit()) {
+        playlist.setSavedTrackIds({});
+        return false;
     }
 
-    return false;
+    return saved;
 }
 
 bool PlaylistDatabase::saveModifiedPlaylists(const PlaylistList& playlists)
@@ -107,10 +134,17 @@ bool PlaylistDatabase::saveModifiedPlaylists(const PlaylistList& playlists)
     DbTransaction transaction{db()};
 
     for(const auto& playlist : playlists) {
-        savePlaylist(*playlist);
+        savePlaylistChanges(*playlist);
     }
 
-    return transaction.commit();
+    if(!transaction.commit()) {
+        for(const auto& playlist : playlists) {
+            playlist->setSavedTrackIds({});
+        }
+        return false;
+    }
+
+    return true;
 }
 
 bool PlaylistDatabase::removePlaylist(int id)
@@ -123,6 +157,35 @@ bool PlaylistDatabase::removePlaylist(int id)
     return query.exec();
 }
 
+bool PlaylistDatabase::savePlaylistChanges(Playlist& playlist)
+{
+    bool updated{false};
+
+    if(playlist.modified()) {
+        const auto statement
+            = QStringLiteral("UPDATE Playlists SET Name = :name, PlaylistIndex = :index WHERE PlaylistID = :id;");
+
+        DbQuery query{db(), statement};
+
+        query.bindValue(QStringLiteral(":name"), playlist.name());
+        query.bindValue(QStringLiteral(":index"), playlist.index());
+        query.bindValue(QStringLiteral(":id"), playlist.dbId());
+
+        updated = query.exec();
+    }
+
+    if(playlist.tracksModified()) {
+        updated = savePlaylistTracks(playlist);
+    }
+
+    if(updated) {
+        playlist.resetFlags();
+        return true;
+    }
+
+    return false;
+}
+
 bool PlaylistDatabase::renamePlaylist(int id, const QString& name)
 {
     if(name.isEmpty()) {
@@ -138,50 +201,149 @@ bool PlaylistDatabase::renamePlaylist(int id, const QString& name)
     return query.exec();
 }
 
-bool PlaylistDatabase::insertPlaylistTrack(int playlistId, const Track& track, int index)
+bool PlaylistDatabase::savePlaylistTracks(Playlist& playlist)
 {
-    const QString statement = QStringLiteral(
-        "INSERT INTO PlaylistTracks (PlaylistID, TrackID, TrackIndex) VALUES (:playlistId, :trackId, :index);");
+    const int playlistId = playlist.dbId();
+    if(playlistId < 0) {
+        return false;
+    }
 
-    DbQuery query{db(), statement};
-    query.bindValue(QStringLiteral(":playlistId"), playlistId);
-    query.bindValue(QStringLiteral(":trackId"), track.id());
-    query.bindValue(QStringLiteral(":index"), index);
+    std::vector<int> trackIds = playlistTrackIds(playlist.tracks());
+
+    bool saved{false};
+
+    const auto& savedTrackIds = playlist.savedTrackIds();
+    if(savedTrackIds) {
+        const PlaylistTracksDiff diff{*savedTrackIds, trackIds};
+        // Each changed row is updated by its own statement, whereas a rewrite only takes one statement
+        // per batch of rows, so rewrite once the update would need more than a quarter of the rows
+        const size_t rewriteStatements = 1 + (trackIds.size() + TracksPerInsert - 1) / TracksPerInsert;
+        const size_t maxStatements     = std::max(rewriteStatements, trackIds.size() / 4);
+        if(diff.statementCount(*savedTrackIds, trackIds, TracksPerInsert) <= maxStatements) {
+            saved = updatePlaylistTracks(playlistId, *savedTrackIds, trackIds);
+            if(!saved) {
+                qWarning() << "[DB] Stored tracks of playlist" << playlistId
+                           << "don't match the last save; rewriting the playlist";
+                saved = replacePlaylistTracks(playlistId, trackIds);
+            }
+        }
+        else {
+            saved = replacePlaylistTracks(playlistId, trackIds);
+        }
+    }
+    else {
+        saved = replacePlaylistTracks(playlistId, trackIds);
+    }
 
-    return query.exec();
+    // If a save failed part way through, the rows can't be trusted to match either list
+    playlist.setSavedTrackIds(saved ? std::make_optional(std::move(trackIds)) : std::nullopt);
+
+    return saved;
 }
 
-bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const TrackList& tracks)
+bool PlaylistDatabase::updatePlaylistTracks(int playlistId, const std::vector<int>& savedIds,
+                                            const std::vector<int>& trackIds)
 {
-    if(playlistId < 0) {
-        return false;
+    const PlaylistTracksDiff diff{savedIds, trackIds};
+
+    // Rows in both
+    for(size_t i{diff.first}; i < diff.replacedEnd(); ++i) {
+        if(savedIds.at(i) == trackIds.at(i)) {
+            continue;
+        }
+
+        DbQuery query = cachedQuery(QStringLiteral(
+            "UPDATE PlaylistTracks SET TrackID = ? WHERE PlaylistID = ? AND TrackIndex = ?;"));
+        query.addBindValue(trackIds.at(i));
+        query.addBindValue(playlistId);
+        query.addBindValue(static_cast<int>(i));
+
+        // A missing row means the stored tracks don't match savedIds
+        if(!query.exec() || query.numRowsAffected() != 1) {
+            return false;
+        }
     }
 
-    // Remove current playlist tracks
+    if(diff.savedEnd == diff.currentEnd) {
+        return true;
+    }
+
+    if(diff.savedEnd > diff.currentEnd) {
+        DbQuery query = cachedQuery(QStringLiteral(
+            "DELETE FROM PlaylistTracks WHERE PlaylistID = ? AND TrackIndex >= ? AND TrackIndex < ?;"));
+        query.addBindValue(playlistId);
+        query.addBindValue(static_cast<int>(diff.currentEnd));
+        query.addBindValue(static_cast<int>(diff.savedEnd));
+
+        if(!query.exec() || std::cmp_not_equal(query.numRowsAffected(), diff.savedEnd - diff.currentEnd)) {
+            return false;
+        }
+    }
+
+    if(diff.savedEnd < savedIds.size()) {
+        // Shift the unchanged rows at the end into place
+        DbQuery query = cachedQuery(QStringLiteral(
+            "UPDATE PlaylistTracks SET TrackIndex = TrackIndex + ? WHERE PlaylistID = ? AND TrackIndex >= ?;"));
+        query.addBindValue(static_cast<int>(diff.currentEnd) - static_cast<int>(diff.savedEnd));
+        query.addBindValue(playlistId);
+        query.addBindValue(static_cast<int>(diff.savedEnd));
+
+        if(!query.exec() || std::cmp_not_equal(query.numRowsAffected(), savedIds.size() - diff.savedEnd)) {
+            return false;
+        }
+    }
+
+    if(diff.currentEnd > diff.savedEnd) {
+        return insertPlaylistTracks(playlistId, trackIds, diff.savedEnd, diff.currentEnd - diff.savedEnd);
+    }
+
+    return true;
+}
+
+bool PlaylistDatabase::replacePlaylistTracks(int playlistId, const std::vector<int>& trackIds)
+{
     const auto statement = QStringLiteral("DELETE FROM PlaylistTracks WHERE PlaylistID = :id;");
 
-    DbQuery query{db(), statement};
+    DbQuery query = cachedQuery(statement);
     query.bindValue(QStringLiteral(":id"), playlistId);
 
     if(!query.exec()) {
         return false;
     }
 
-    for(int i{0}; const auto& track : tracks) {
-        if(track.isValid() && track.isInDatabase()) {
-            if(!insertPlaylistTrack(playlistId, track, i++)) {
-                return false;
-            }
+    return insertPlaylistTracks(playlistId, trackIds, 0, trackIds.size());
+}
+
+bool PlaylistDatabase::insertPlaylistTracks(int playlistId, const std::vector<int>& trackIds, size_t first,
+                                            size_t count)
+{
+    for(size_t batchStart{first}; batchStart < first + count; batchStart += TracksPerInsert) {
+        const size_t batchEnd = std::min(batchStart + TracksPerInsert, first + count);
+
+        const size_t batchCount = batchEnd - batchStart;
+        const QString statement = insertPlaylistTracksStatement(batchCount);
+
+        // Only full batches are cached, as the size of the remainder differs with each call
+        DbQuery query = batchCount == TracksPerInsert ? cachedQuery(statement) : DbQuery{db(), statement};
+
+        for(size_t i{batchStart}; i < batchEnd; ++i) {
+            query.addBindValue(playlistId);
+            query.addBindValue(trackIds.at(i));
+            query.addBindValue(static_cast<int>(i));
+        }
+
+        if(!query.exec()) {
+            return false;
         }
     }
 
     return true;
 }
 
-TrackList PlaylistDatabase::populatePlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks)
+TrackList PlaylistDatabase::populatePlaylistTracks(Playlist& playlist, const TrackIdMap& tracks)
 {
-    const auto statement
-        = QStringLiteral("SELECT TrackID FROM PlaylistTracks WHERE PlaylistID=:playlistId ORDER BY TrackIndex;");
+    const auto statement = QStringLiteral(
+        "SELECT TrackID, TrackIndex FROM PlaylistTracks WHERE PlaylistID=:playlistId ORDER BY TrackIndex;");
 
     DbQuery query{db(), statement};
     query.bindValue(QStringLiteral(":playlistId"), playlist.dbId());
@@ -191,14 +353,22 @@ TrackList PlaylistDatabase::populatePlaylistTracks(const Playlist& playlist, con
     }
 
     TrackList playlistTracks;
+    std::vector<int> savedIds;
+    bool indexesMatch{true};
 
     while(query.next()) {
         const int trackId = query.value(0).toInt();
         if(tracks.contains(trackId)) {
             playlistTracks.push_back(tracks.at(trackId));
         }
+
+        // Changes are saved by position, so the rows must be numbered from 0 without gaps
+        indexesMatch = indexesMatch && std::cmp_equal(query.value(1).toInt(), savedIds.size());
+        savedIds.push_back(trackId);
     }
 
+    playlist.setSavedTrackIds(indexesMatch ? std::make_optional(std::move(savedIds)) : std::nullopt);
+
     return playlistTracks;
 }
 } // namespace Fooyin
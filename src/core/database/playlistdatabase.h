@@ -35,18 +35,26 @@ class PlaylistDatabase : public DbModule
 {
 public:
     std::vector<PlaylistInfo> getAllPlaylists();
-    TrackList getPlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks);
+    /** Returns the tracks of @p playlist found in @p tracks, and records the tracks saved for it. */
+    TrackList getPlaylistTracks(Playlist& playlist, const TrackIdMap& tracks);
 
     int insertPlaylist(const QString& name, int index);
 
+    /*!
+     * Saves changes to @p playlist. If its tracks were last saved or loaded by this database, only
+     * the rows which differ are written, unless so many have changed it's cheaper to rewrite them all.
+     */
     bool savePlaylist(Playlist& playlist);
     bool saveModifiedPlaylists(const PlaylistList& playlists);
     bool removePlaylist(int id);
     bool renamePlaylist(int id, const QString& name);
 
 private:
-    bool insertPlaylistTrack(int playlistId, const Fooyin::Track& track, int index);
-    bool insertPlaylistTracks(int playlistId, const TrackList& tracks);
-    TrackList populatePlaylistTracks(const Playlist& playlist, const TrackIdMap& tracks);
+    bool savePlaylistChanges(Playlist& playlist);
+    bool savePlaylistTracks(Playlist& playlist);
+    bool updatePlaylistTracks(int playlistId, const std::vector<int>& savedIds, const std::vector<int>& trackIds);
+    bool replacePlaylistTracks(int playlistId, const std::vector<int>& trackIds);
+    bool insertPlaylistTracks(int playlistId, const std::vector<int>& trackIds, size_t first, size_t count);
+    TrackList populatePlaylistTracks(Playlist& playlist, const TrackIdMap& tracks);
 };
 } // namespace Fooyin
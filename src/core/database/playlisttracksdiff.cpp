@@ -0,0 +1,78 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "playlisttracksdiff.h"
+
+#include <algorithm>
+
+namespace Fooyin {
+PlaylistTracksDiff::PlaylistTracksDiff(const std::vector<int>& savedIds, const std::vector<int>& currentIds)
+{
+    const size_t commonSize = std::min(savedIds.size(), currentIds.size());
+
+    while(first < commonSize && savedIds.at(first) == currentIds.at(first)) {
+        ++first;
+    }
+
+    // The suffix can't overlap the prefix, otherwise repeated tracks would be counted twice
+    size_t suffix{0};
+    while(suffix < commonSize - first
+          && savedIds.at(savedIds.size() - suffix - 1) == currentIds.at(currentIds.size() - suffix - 1)) {
+        ++suffix;
+    }
+
+    savedEnd   = savedIds.size() - suffix;
+    currentEnd = currentIds.size() - suffix;
+}
+
+size_t PlaylistTracksDiff::replacedEnd() const
+{
+    return std::min(savedEnd, currentEnd);
+}
+
+size_t PlaylistTracksDiff::statementCount(const std::vector<int>& savedIds, const std::vector<int>& currentIds,
+                                          size_t tracksPerInsert) const
+{
+    size_t statements{0};
+
+    for(size_t i{first}; i < replacedEnd(); ++i) {
+        if(savedIds.at(i) != currentIds.at(i)) {
+            ++statements;
+        }
+    }
+
+    if(savedEnd == currentEnd) {
+        return statements;
+    }
+
+    if(savedEnd > currentEnd) {
+        // Removed rows are deleted together
+        ++statements;
+    }
+    if(savedEnd < savedIds.size()) {
+        // The unchanged rows at the end are shifted together
+        ++statements;
+    }
+    if(currentEnd > savedEnd) {
+        statements += (currentEnd - savedEnd + tracksPerInsert - 1) / tracksPerInsert;
+    }
+
+    return statements;
+}
+} // namespace Fooyin
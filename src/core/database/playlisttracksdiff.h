@@ -0,0 +1,51 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * The rows which differ between the saved and current tracks of a playlist.
+ * Rows before @c first and from @c savedEnd (@c currentEnd) are unchanged, although
+ * the rows after the changed range need to be shifted if the number of tracks has changed.
+ */
+struct FYCORE_EXPORT PlaylistTracksDiff
+{
+    size_t first{0};
+    size_t savedEnd{0};
+    size_t currentEnd{0};
+
+    PlaylistTracksDiff(const std::vector<int>& savedIds, const std::vector<int>& currentIds);
+
+    /** End of the range of rows which exist in both lists and are updated in place. */
+    [[nodiscard]] size_t replacedEnd() const;
+
+    /*!
+     * Returns the number of statements needed to apply the diff, where each changed row is
+     * updated individually and new rows are inserted @p tracksPerInsert at a time.
+     */
+    [[nodiscard]] size_t statementCount(const std::vector<int>& savedIds, const std::vector<int>& currentIds,
+                                        size_t tracksPerInsert) const;
+};
+} // namespace Fooyin
@@ -27,7 +27,10 @@
 
 #include <QFileInfo>
 
-using BindingsMap = std::map<QString, QVariant>;
+// SQLite's lowest default limit on the number of bound values in a statement
+constexpr size_t MaxBoundValues = 999;
+// Settings row holding TrackDatabase::revision
+constexpr auto RevisionKey = "TrackRevision";
 
 namespace {
 QString fetchTrackColumns()
@@ -67,35 +70,81 @@ QString fetchTrackColumns()
     return columns;
 }
 
-BindingsMap trackBindings(const Fooyin::Track& track)
+// Columns written when storing a track, in the order values are bound by bindTrackValues
+const QStringList& storedTrackColumns()
 {
-    return {{QStringLiteral(":filePath"), Fooyin::Utils::File::cleanPath(track.filepath())},
-            {QStringLiteral(":title"), track.title()},
-            {QStringLiteral(":trackNumber"), track.trackNumber()},
-            {QStringLiteral(":trackTotal"), track.trackTotal()},
-            {QStringLiteral(":artists"), track.artists()},
-            {QStringLiteral(":albumArtist"), track.albumArtists()},
-            {QStringLiteral(":album"), track.album()},
-            {QStringLiteral(":discNumber"), track.discNumber()},
-            {QStringLiteral(":discTotal"), track.discTotal()},
-            {QStringLiteral(":date"), track.date()},
-            {QStringLiteral(":composer"), track.composer()},
-            {QStringLiteral(":performer"), track.performer()},
-            {QStringLiteral(":genres"), track.genres()},
-            {QStringLiteral(":comment"), track.comment()},
-            {QStringLiteral(":duration"), QVariant::fromValue(track.duration())},
-            {QStringLiteral(":fileSize"), QVariant::fromValue(track.fileSize())},
-            {QStringLiteral(":bitRate"), track.bitrate()},
-            {QStringLiteral(":sampleRate"), track.sampleRate()},
-            {QStringLiteral(":channels"), track.channels()},
-            {QStringLiteral(":extraTags"), track.serialiseExtrasTags()},
-            {QStringLiteral(":type"), static_cast<int>(track.type())},
-            {QStringLiteral(":modifiedDate"), QVariant::fromValue(track.modifiedTime())},
-            {QStringLiteral(":trackHash"), track.hash()},
-            {QStringLiteral(":libraryID"), track.libraryId()}};
+    static const QStringList columns
+        = {QStringLiteral("FilePath"),     QStringLiteral("Title"),      QStringLiteral("TrackNumber"),
+           QStringLiteral("TrackTotal"),   QStringLiteral("Artists"),    QStringLiteral("AlbumArtist"),
+           QStringLiteral("Album"),        QStringLiteral("DiscNumber"), QStringLiteral("DiscTotal"),
+           QStringLiteral("Date"),         QStringLiteral("Composer"),   QStringLiteral("Performer"),
+           QStringLiteral("Genres"),       QStringLiteral("Comment"),    QStringLiteral("Duration"),
+           QStringLiteral("FileSize"),     QStringLiteral("BitRate"),    QStringLiteral("SampleRate"),
+           QStringLiteral("Channels"),     QStringLiteral("ExtraTags"),  QStringLiteral("Type"),
+           QStringLiteral("ModifiedDate"), QStringLiteral("TrackHash"),  QStringLiteral("LibraryID")};
+
+    return columns;
+}
+
+void bindTrackValues(Fooyin::DbQuery& query, const Fooyin::Track& track)
+{
+    query.addBindValue(Fooyin::Utils::File::cleanPath(track.filepath()));
+    query.addBindValue(track.title());
+    query.addBindValue(track.trackNumber());
+    query.addBindValue(track.trackTotal());
+    query.addBindValue(track.artists());
+    query.addBindValue(track.albumArtists());
+    query.addBindValue(track.album());
+    query.addBindValue(track.discNumber());
+    query.addBindValue(track.discTotal());
+    query.addBindValue(track.date());
+    query.addBindValue(track.composer());
+    query.addBindValue(track.performer());
+    query.addBindValue(track.genres());
+    query.addBindValue(track.comment());
+    query.addBindValue(QVariant::fromValue(track.duration()));
+    query.addBindValue(QVariant::fromValue(track.fileSize()));
+    query.addBindValue(track.bitrate());
+    query.addBindValue(track.sampleRate());
+    query.addBindValue(track.channels());
+    query.addBindValue(track.serialiseExtrasTags());
+    query.addBindValue(static_cast<int>(track.type()));
+    query.addBindValue(QVariant::fromValue(track.modifiedTime()));
+    query.addBindValue(track.hash());
+    query.addBindValue(track.libraryId());
+}
+
+QString insertTracksStatement(size_t count)
+{
+    const QStringList& columns = storedTrackColumns();
+
+    QStringList placeholders;
+    placeholders.fill(QStringLiteral("?"), columns.size());
+    const QString row = QStringLiteral("(%1)").arg(placeholders.join(u','));
+
+    QStringList rows;
+    rows.fill(row, static_cast<qsizetype>(count));
+
+    return QStringLiteral("INSERT INTO Tracks (%1) VALUES %2;").arg(columns.join(u','), rows.join(u','));
 }
 
-Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
+// Insert as many tracks as SQLite allows in each statement
+size_t tracksPerInsert()
+{
+    return MaxBoundValues / static_cast<size_t>(storedTrackColumns().size());
+}
+
+QString updateTrackStatement()
+{
+    QStringList assignments;
+    for(const QString& column : storedTrackColumns()) {
+        assignments.emplace_back(column + QStringLiteral(" = ?"));
+    }
+
+    return QStringLiteral("UPDATE Tracks SET %1 WHERE TrackID = ?;").arg(assignments.join(u','));
+}
+
+Fooyin::Track readToTrack(const Fooyin::DbQuery& q, bool checkExists = true)
 {
     Fooyin::Track track;
 
@@ -131,7 +180,9 @@ Fooyin::Track readToTrack(const Fooyin::DbQuery& q)
     track.setPlayCount(q.value(29).toInt());
 
     track.generateHash();
-    track.setIsEnabled(QFileInfo::exists(track.filepath()));
+    if(checkExists) {
+        track.setIsEnabled(QFileInfo::exists(track.filepath()));
+    }
 
     return track;
 }
@@ -150,15 +201,38 @@ bool TrackDatabase::storeTracks(TrackList& tracks)
         return false;
     }
 
+    std::vector<Track*> newTracks;
+
     for(auto& track : tracks) {
         if(track.id() >= 0) {
-            updateTrack(track);
+            updateTrackValues(track);
         }
         else {
-            insertTrack(track);
+            newTracks.push_back(&track);
+        }
+    }
+
+    const size_t batchSize = tracksPerInsert();
+    const std::span<Track*> tracksToInsert{newTracks};
+
+    for(size_t i{0}; i < tracksToInsert.size(); i += batchSize) {
+        const auto batch = tracksToInsert.subspan(i, std::min(batchSize, tracksToInsert.size() - i));
+        if(!insertTracks(batch)) {
+            // A single conflicting track fails the whole batch, so insert individually to keep the rest
+            for(Track*& track : batch) {
+                insertTracks({&track, 1});
+            }
+        }
+    }
+
+    for(const Track* track : newTracks) {
+        if(track->id() >= 0) {
+            insertOrUpdateStats(*track);
         }
     }
 
+    increaseRevision();
+
     return transaction.commit();
 }
 
@@ -225,8 +299,9 @@ TrackList TrackDatabase::getAllTracks() const
         tracks.reserve(numRows);
     }
 
+    // Checking every file would delay loading, so tracks are assumed to exist until checked afterwards
     while(q.next()) {
-        tracks.emplace_back(readToTrack(q));
+        tracks.emplace_back(readToTrack(q, false));
     }
 
     return tracks;
@@ -256,48 +331,13 @@ TrackList TrackDatabase::tracksByHash(const QString& hash) const
 
 bool TrackDatabase::updateTrack(const Track& track)
 {
-    if(track.id() < 0) {
-        qDebug() << QStringLiteral("Cannot update track %1 (Invalid ID)").arg(track.filepath());
-        return false;
-    }
-
-    const auto statement = QStringLiteral("UPDATE TRACKS SET "
-                                          "FilePath = :filePath,"
-                                          "Title = :title, "
-                                          "TrackNumber = :trackNumber,"
-                                          "TrackTotal = :trackTotal,"
-                                          "Artists = :artists,"
-                                          "AlbumArtist = :albumArtist,"
-                                          "Album = :album,"
-                                          "DiscNumber = :discNumber,"
-                                          "DiscTotal = :discTotal,"
-                                          "Date = :date,"
-                                          "Composer = :composer,"
-                                          "Performer = :performer,"
-                                          "Genres = :genres,"
-                                          "Comment = :comment,"
-                                          "Duration = :duration,"
-                                          "FileSize = :fileSize,"
-                                          "BitRate = :bitRate,"
-                                          "SampleRate = :sampleRate,"
-                                          "Channels = :channels,"
-                                          "ExtraTags = :extraTags,"
-                                          "Type = :type,"
-                                          "ModifiedDate = :modifiedDate,"
-                                          "TrackHash = :trackHash,"
-                                          "LibraryID = :libraryID"
-                                          " WHERE TrackID = :trackId;");
-
-    DbQuery query{db(), statement};
-
-    query.bindValue(QStringLiteral(":trackId"), track.id());
+    DbTransaction transaction{db()};
 
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
+    if(!transaction) {
+        return false;
     }
 
-    return query.exec();
+    return updateTrackValues(track) && increaseRevision() && transaction.commit();
 }
 
 bool TrackDatabase::updateTrackStats(const TrackList& tracks)
@@ -312,6 +352,8 @@ bool TrackDatabase::updateTrackStats(const TrackList& tracks)
         }
     }
 
+    increaseRevision();
+
     return success && transaction.commit();
 }
 
@@ -341,6 +383,8 @@ bool TrackDatabase::deleteTracks(const TrackList& tracks)
     const int fileCount = static_cast<int>(
         std::count_if(tracks.cbegin(), tracks.cend(), [this](const Track& track) { return deleteTrack(track.id()); }));
 
+    increaseRevision();
+
     const auto success = transaction.commit();
 
     return (success && (fileCount == static_cast<int>(tracks.size())));
@@ -348,6 +392,12 @@ bool TrackDatabase::deleteTracks(const TrackList& tracks)
 
 std::set<int> TrackDatabase::deleteLibraryTracks(int libraryId)
 {
+    DbTransaction transaction{db()};
+
+    if(!transaction) {
+        return {};
+    }
+
     std::set<int> tracksToRemove;
 
     {
@@ -387,7 +437,7 @@ std::set<int> TrackDatabase::deleteLibraryTracks(int libraryId)
     query.bindValue(QStringLiteral(":nonLibraryId"), QStringLiteral("-1"));
     query.bindValue(QStringLiteral(":libraryId"), libraryId);
 
-    if(!query.exec()) {
+    if(!query.exec() || !increaseRevision() || !transaction.commit()) {
         return {};
     }
 
@@ -396,9 +446,14 @@ std::set<int> TrackDatabase::deleteLibraryTracks(int libraryId)
 
 void TrackDatabase::cleanupTracks()
 {
+    DbTransaction transaction{db()};
+
     removeUnmanagedTracks();
     markUnusedStatsForDelete();
     deleteExpiredStats();
+    increaseRevision();
+
+    transaction.commit();
 }
 
 void TrackDatabase::dropViews(const QSqlDatabase& db)
@@ -454,6 +509,21 @@ void TrackDatabase::insertViews(const QSqlDatabase& db)
     query.exec();
 }
 
+uint64_t TrackDatabase::revision() const
+{
+    const auto statement = QStringLiteral("SELECT Value FROM Settings WHERE Name = :name;");
+
+    DbQuery query{db(), statement};
+
+    query.bindValue(QStringLiteral(":name"), QString::fromLatin1(RevisionKey));
+
+    if(query.exec() && query.next()) {
+        return query.value(0).toULongLong();
+    }
+
+    return 0;
+}
+
 int TrackDatabase::trackCount() const
 {
     const auto statement = QStringLiteral("SELECT COUNT(*) FROM Tracks;");
@@ -471,75 +541,57 @@ int TrackDatabase::trackCount() const
     return -1;
 }
 
-bool TrackDatabase::insertTrack(Track& track) const
+bool TrackDatabase::updateTrackValues(const Track& track) const
 {
-    const auto statement = QStringLiteral("INSERT INTO Tracks ("
-                                          "FilePath,"
-                                          "Title,"
-                                          "TrackNumber,"
-                                          "TrackTotal,"
-                                          "Artists,"
-                                          "AlbumArtist,"
-                                          "Album,"
-                                          "DiscNumber,"
-                                          "DiscTotal,"
-                                          "Date,"
-                                          "Composer,"
-                                          "Performer,"
-                                          "Genres,"
-                                          "Comment,"
-                                          "Duration,"
-                                          "FileSize,"
-                                          "BitRate,"
-                                          "SampleRate,"
-                                          "Channels,"
-                                          "ExtraTags,"
-                                          "Type,"
-                                          "ModifiedDate,"
-                                          "TrackHash,"
-                                          "LibraryID"
-                                          ") "
-                                          "VALUES ("
-                                          ":filePath,"
-                                          ":title, "
-                                          ":trackNumber,"
-                                          ":trackTotal,"
-                                          ":artists,"
-                                          ":albumArtist,"
-                                          ":album,"
-                                          ":discNumber,"
-                                          ":discTotal,"
-                                          ":date, "
-                                          ":composer,"
-                                          ":performer,"
-                                          ":genres,"
-                                          ":comment,"
-                                          ":duration,"
-                                          ":fileSize,"
-                                          ":bitRate,"
-                                          ":sampleRate,"
-                                          ":channels,"
-                                          ":extraTags, "
-                                          ":type,"
-                                          ":modifiedDate,"
-                                          ":trackHash,"
-                                          ":libraryID"
-                                          ");");
+    if(track.id() < 0) {
+        qDebug() << QStringLiteral("Cannot update track %1 (Invalid ID)").arg(track.filepath());
+        return false;
+    }
 
-    DbQuery query{db(), statement};
+    static const QString statement = updateTrackStatement();
+
+    DbQuery query = cachedQuery(statement);
+
+    bindTrackValues(query, track);
+    query.addBindValue(track.id());
+
+    return query.exec();
+}
+
+bool TrackDatabase::increaseRevision() const
+{
+    static const QString statement
+        = QStringLiteral("INSERT INTO Settings (Name, Value) VALUES ('%1', 1) ON CONFLICT(Name) DO UPDATE SET Value "
+                         "= CAST(Value AS INTEGER) + 1;")
+              .arg(QString::fromLatin1(RevisionKey));
+
+    DbQuery query = cachedQuery(statement);
 
-    const auto bindings = trackBindings(track);
-    for(const auto& [name, value] : bindings) {
-        query.bindValue(name, value);
+    return query.exec();
+}
+
+bool TrackDatabase::insertTracks(std::span<Track*> tracks) const
+{
+    const QString statement = insertTracksStatement(tracks.size());
+
+    // Only full batches are cached, as the size of the remainder differs with each call
+    DbQuery query = tracks.size() == tracksPerInsert() ? cachedQuery(statement) : DbQuery{db(), statement};
+
+    for(const Track* track : tracks) {
+        bindTrackValues(query, *track);
     }
 
     if(!query.exec()) {
         return false;
     }
 
-    track.setId(query.lastInsertId().toInt());
+    // Rows inserted by a single statement into an AUTOINCREMENT table are given consecutive ids
+    int id = query.lastInsertId().toInt() - static_cast<int>(tracks.size()) + 1;
+    for(Track* track : tracks) {
+        track->setId(id++);
+    }
 
-    return insertOrUpdateStats(track);
+    return true;
 }
 
 bool TrackDatabase::insertOrUpdateStats(const Track& track) const
@@ -558,7 +610,7 @@ bool TrackDatabase::insertOrUpdateStats(const Track& track) const
         const auto statement = QStringLiteral("SELECT AddedDate, FirstPlayed, LastPlayed, PlayCount, Rating FROM "
                                               "TrackStats WHERE TrackHash = :trackHash;");
 
-        DbQuery query{db(), statement};
+        DbQuery query = cachedQuery(statement);
 
         query.bindValue(QStringLiteral(":trackHash"), track.hash());
 
@@ -614,7 +666,7 @@ bool TrackDatabase::insertOrUpdateStats(const Track& track) const
         "INSERT OR REPLACE INTO TrackStats (TrackHash, AddedDate, FirstPlayed, LastPlayed, PlayCount) VALUES "
         "(:trackHash, :addedDate, :firstPlayed, :lastPlayed, :playCount);");
 
-    DbQuery query{db(), statement};
+    DbQuery query = cachedQuery(statement);
 
     query.bindValue(QStringLiteral(":trackHash"), track.hash());
     query.bindValue(QStringLiteral(":addedDate"), QVariant::fromValue(added));
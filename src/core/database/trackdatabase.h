@@ -22,7 +22,9 @@
 #include <core/trackfwd.h>
 #include <utils/database/dbmodule.h>
 
+#include <cstdint>
 #include <set>
+#include <span>
 
 namespace Fooyin {
 class TrackDatabase : public DbModule
@@ -44,12 +46,20 @@ public:
 
     void cleanupTracks();
 
+    [[nodiscard]] int trackCount() const;
+    /*!
+     * Returns a counter which is increased in the same transaction as every write to tracks or their stats,
+     * so a copy of the tracks can tell whether it still matches the database.
+     */
+    [[nodiscard]] uint64_t revision() const;
+
     static void dropViews(const QSqlDatabase& db);
     static void insertViews(const QSqlDatabase& db);
 
 private:
-    int trackCount() const;
-    bool insertTrack(Track& track) const;
+    bool updateTrackValues(const Track& track) const;
+    bool increaseRevision() const;
+    bool insertTracks(std::span<Track*> tracks) const;
     bool insertOrUpdateStats(const Track& track) const;
     void removeUnmanagedTracks() const;
     void markUnusedStatsForDelete() const;
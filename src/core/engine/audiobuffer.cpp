@@ -19,11 +19,114 @@
 
 #include <core/engine/audiobuffer.h>
 
+#include "audiokernels.h"
+
 #include <QDebug>
 
+#include <atomic>
+#include <mutex>
 #include <ranges>
 #include <utility>
 
+namespace {
+std::atomic<uint64_t> allocations{0};
+
+/*!
+ * Recycles the sample storage and shared data of released buffers, so that
+ * steady-state decoding performs no heap allocations.
+ */
+class BufferPool
+{
+public:
+    BufferPool()
+    {
+        m_storage.reserve(MaxPooled);
+        m_blocks.reserve(MaxPooled);
+    }
+
+    ~BufferPool()
+    {
+        for(void* block : m_blocks) {
+            ::operator delete(block);
+        }
+    }
+
+    BufferPool(const BufferPool&)            = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    std::vector<std::byte> takeStorage()
+    {
+        const std::scoped_lock lock{m_mutex};
+
+        if(m_storage.empty()) {
+            return {};
+        }
+
+        auto storage = std::move(m_storage.back());
+        m_storage.pop_back();
+        return storage;
+    }
+
+    void releaseStorage(std::vector<std::byte>&& storage)
+    {
+        if(storage.capacity() == 0) {
+            return;
+        }
+
+        storage.clear();
+
+        const std::scoped_lock lock{m_mutex};
+
+        if(m_storage.size() < MaxPooled) {
+            m_storage.push_back(std::move(storage));
+        }
+    }
+
+    void* allocateBlock(size_t size)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+
+            if(!m_blocks.empty()) {
+                void* block = m_blocks.back();
+                m_blocks.pop_back();
+                return block;
+            }
+        }
+
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    void releaseBlock(void* block)
+    {
+        {
+            const std::scoped_lock lock{m_mutex};
+
+            if(m_blocks.size() < MaxPooled) {
+                m_blocks.push_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+
+private:
+    static constexpr size_t MaxPooled = 64;
+
+    std::mutex m_mutex;
+    std::vector<std::vector<std::byte>> m_storage;
+    std::vector<void*> m_blocks;
+};
+
+BufferPool& bufferPool()
+{
+    static BufferPool pool;
+    return pool;
+}
+} // namespace
+
 namespace Fooyin {
 struct AudioBuffer::Private : QSharedData
 {
@@ -32,20 +135,64 @@ struct AudioBuffer::Private : QSharedData
     uint64_t startTime;
 
     Private(std::span<const std::byte> data_, AudioFormat format_, uint64_t startTime_)
-        : format{format_}
+        : buffer{bufferPool().takeStorage()}
+        , format{format_}
         , startTime{startTime_}
     {
+        reserve(data_.size());
         buffer.assign(data_.begin(), data_.end());
     }
 
     Private(const uint8_t* data_, size_t size, AudioFormat format_, uint64_t startTime_)
-        : format{format_}
+        : buffer{bufferPool().takeStorage()}
+        , format{format_}
         , startTime{startTime_}
     {
-        buffer.resize(size);
+        resize(size);
         std::memmove(buffer.data(), data_, size);
     }
 
+    Private(const Private& other)
+        : QSharedData{other}
+        , buffer{bufferPool().takeStorage()}
+        , format{other.format}
+        , startTime{other.startTime}
+    {
+        reserve(other.buffer.size());
+        buffer.assign(other.buffer.cbegin(), other.buffer.cend());
+    }
+
+    ~Private()
+    {
+        bufferPool().releaseStorage(std::move(buffer));
+    }
+
+    Private& operator=(const Private&) = delete;
+
+    static void* operator new(size_t size)
+    {
+        return bufferPool().allocateBlock(size);
+    }
+
+    static void operator delete(void* ptr)
+    {
+        bufferPool().releaseBlock(ptr);
+    }
+
+    void reserve(size_t size)
+    {
+        if(size > buffer.capacity()) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            buffer.reserve(size);
+        }
+    }
+
+    void resize(size_t size)
+    {
+        reserve(size);
+        buffer.resize(size);
+    }
+
     void fillSilence()
     {
         const bool unsignedFormat = format.sampleFormat() == SampleFormat::U8;
@@ -58,20 +205,6 @@ struct AudioBuffer::Private : QSharedData
         std::fill(buffer.begin() + buffer.size(), buffer.begin() + buffer.capacity(),
                   unsignedFormat ? std::byte{0x80} : std::byte{0});
     }
-
-    template <typename T>
-    void adjustVolume(const double volume)
-    {
-        const auto bytes = static_cast<int>(buffer.size());
-        const int bps    = format.bytesPerSample();
-
-        for(int i{0}; i < bytes; i += bps) {
-            T sample;
-            std::memcpy(&sample, buffer.data() + i, bps);
-            sample *= volume;
-            std::memcpy(buffer.data() + i, &sample, bps);
-        }
-    }
 };
 
 AudioBuffer::AudioBuffer() = default;
@@ -97,14 +230,14 @@ AudioBuffer::AudioBuffer(AudioBuffer&& other) noexcept        = default;
 void AudioBuffer::reserve(size_t size)
 {
     if(isValid()) {
-        p->buffer.reserve(size);
+        p->reserve(size);
     }
 }
 
 void AudioBuffer::resize(size_t size)
 {
     if(isValid()) {
-        p->buffer.resize(size);
+        p->resize(size);
     }
 }
 
@@ -119,7 +252,7 @@ void AudioBuffer::append(const std::byte* data, size_t size)
 {
     if(isValid()) {
         const size_t index = p->buffer.size();
-        p->buffer.resize(index + size);
+        p->resize(index + size);
         std::memcpy(p->buffer.data() + index, data, size);
     }
 }
@@ -214,6 +347,11 @@ std::byte* AudioBuffer::data()
     return {};
 }
 
+uint64_t AudioBuffer::allocationCount()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
 void AudioBuffer::fillSilence()
 {
     if(isValid()) {
@@ -239,23 +377,11 @@ void AudioBuffer::adjustVolumeOfSamples(double volume)
         return;
     }
 
-    switch(format().sampleFormat()) {
-        case(SampleFormat::U8):
-            p->adjustVolume<uint8_t>(volume);
-            break;
-        case(SampleFormat::S16):
-            p->adjustVolume<int16_t>(volume);
-            break;
-        case(SampleFormat::S24):
-        case(SampleFormat::S32):
-            p->adjustVolume<int32_t>(volume);
-            break;
-        case(SampleFormat::Float):
-            p->adjustVolume<float>(volume);
-            break;
-        case(SampleFormat::Unknown):
-        default:
-            qDebug() << "Unable to adjust volume of unsupported format";
+    if(format().sampleFormat() == SampleFormat::Unknown) {
+        qDebug() << "Unable to adjust volume of unsupported format";
+        return;
     }
+
+    Audio::Kernels::applyGain(data(), p->buffer.size(), format().sampleFormat(), volume);
 }
 } // namespace Fooyin
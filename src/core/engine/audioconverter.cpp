@@ -19,10 +19,13 @@
 
 #include <core/engine/audioconverter.h>
 
+#include "audiokernels.h"
+
 #include <core/engine/audiobuffer.h>
 #include <utils/math.h>
 
 #include <cfenv>
+#include <cstring>
 
 namespace {
 using ChannelMap = std::array<int, 32>;
@@ -39,16 +42,16 @@ void convert(const Fooyin::AudioFormat& inputFormat, const std::byte* input, con
 
     for(int i{0}; i < sampleCount; ++i) {
         for(int ch{0}; ch < outChannels; ++ch) {
-            if(channelMap.at(ch) < 0) {
+            if(channelMap[ch] < 0) {
                 continue;
             }
 
             InputType inSample;
-            const auto inOffset = (i * inChannels + channelMap.at(ch)) * inBps;
+            const auto inOffset = (i * inChannels + channelMap[ch]) * inBps;
             std::memcpy(&inSample, input + inOffset, inBps);
 
             OutputType outSample = conversionFunc(inSample);
-            const auto outOffset = (i * outChannels + channelMap.at(ch)) * outBps;
+            const auto outOffset = (i * outChannels + channelMap[ch]) * outBps;
             std::memcpy(output + outOffset, &outSample, outBps);
         }
     }
@@ -116,49 +119,34 @@ float convertS32ToFloat(const int32_t inSample)
 
 uint8_t convertFloatToU8(const float inSample)
 {
-    const int prevRoundingMode = std::fegetround();
-    std::fesetround(FE_TONEAREST);
-
     static constexpr auto minS8 = static_cast<int>(std::numeric_limits<int8_t>::min());
     static constexpr auto maxS8 = static_cast<int>(std::numeric_limits<int8_t>::max());
 
     int intSample = Fooyin::Math::fltToInt(inSample * 0x80);
     intSample     = std::clamp(intSample, minS8, maxS8);
 
-    std::fesetround(prevRoundingMode);
-
     return static_cast<uint8_t>(intSample ^ 0x80);
 }
 
 int16_t convertFloatToS16(const float inSample)
 {
-    const int prevRoundingMode = std::fegetround();
-    std::fesetround(FE_TONEAREST);
-
     static constexpr auto minS16 = static_cast<int>(std::numeric_limits<int16_t>::min());
     static constexpr auto maxS16 = static_cast<int>(std::numeric_limits<int16_t>::max());
 
     int intSample = Fooyin::Math::fltToInt(inSample * 0x8000);
     intSample     = std::clamp(intSample, minS16, maxS16);
 
-    std::fesetround(prevRoundingMode);
-
     return static_cast<int16_t>(intSample);
 }
 
 int32_t convertFloatToS32(const float inSample)
 {
-    const int prevRoundingMode = std::fegetround();
-    std::fesetround(FE_TONEAREST);
-
     static constexpr int minS32 = std::numeric_limits<int32_t>::min();
     static constexpr int maxS32 = std::numeric_limits<int32_t>::max();
 
     int intSample = Fooyin::Math::fltToInt(inSample * 0x80000000);
     intSample     = std::clamp(intSample, minS32, maxS32);
 
-    std::fesetround(prevRoundingMode);
-
     return intSample;
 }
 
@@ -167,9 +155,85 @@ float convertFloatToFloat(const float inSample)
     return inSample;
 }
 
+// Float to integer conversions round to nearest; the mode is set once per call rather than per sample
+class RoundingGuard
+{
+public:
+    RoundingGuard()
+        : m_prevMode{std::fegetround()}
+    {
+        std::fesetround(FE_TONEAREST);
+    }
+
+    ~RoundingGuard()
+    {
+        std::fesetround(m_prevMode);
+    }
+
+    RoundingGuard(const RoundingGuard&)            = delete;
+    RoundingGuard& operator=(const RoundingGuard&) = delete;
+
+private:
+    int m_prevMode;
+};
+
+// Conversions which don't need to remap channels are handled by a single vectorised pass
+bool convertSimple(const Fooyin::AudioFormat& inFormat, const std::byte* input, const Fooyin::AudioFormat& outFormat,
+                   std::byte* output, int samples)
+{
+    using SampleFormat = Fooyin::SampleFormat;
+    namespace Kernels  = Fooyin::Audio::Kernels;
+
+    if(inFormat.channelCount() != outFormat.channelCount()) {
+        return false;
+    }
+
+    const SampleFormat inSampleFormat  = inFormat.sampleFormat();
+    const SampleFormat outSampleFormat = outFormat.sampleFormat();
+    const auto count = static_cast<size_t>(samples) * static_cast<size_t>(inFormat.channelCount());
+
+    if(inSampleFormat == outSampleFormat) {
+        std::memcpy(output, input, static_cast<size_t>(inFormat.bytesForFrames(samples)));
+        return true;
+    }
+
+    const auto isS32 = [](SampleFormat format) {
+        return format == SampleFormat::S32 || format == SampleFormat::S24;
+    };
+
+    if(inSampleFormat == SampleFormat::Float) {
+        if(outSampleFormat == SampleFormat::S16) {
+            Kernels::floatToS16(reinterpret_cast<const float*>(input), reinterpret_cast<int16_t*>(output), count);
+            return true;
+        }
+        if(isS32(outSampleFormat)) {
+            Kernels::floatToS32(reinterpret_cast<const float*>(input), reinterpret_cast<int32_t*>(output), count);
+            return true;
+        }
+    }
+    else if(outSampleFormat == SampleFormat::Float) {
+        if(inSampleFormat == SampleFormat::S16) {
+            Kernels::s16ToFloat(reinterpret_cast<const int16_t*>(input), reinterpret_cast<float*>(output), count);
+            return true;
+        }
+        if(isS32(inSampleFormat)) {
+            Kernels::s32ToFloat(reinterpret_cast<const int32_t*>(input), reinterpret_cast<float*>(output), count);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool convertFormat(const Fooyin::AudioFormat& inFormat, const std::byte* input, const Fooyin::AudioFormat& outFormat,
                    std::byte* output, int samples)
 {
+    const RoundingGuard roundingGuard;
+
+    if(convertSimple(inFormat, input, outFormat, output, samples)) {
+        return true;
+    }
+
     ChannelMap channels;
     std::iota(channels.begin(), channels.end(), -1);
 
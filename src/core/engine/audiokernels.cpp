@@ -0,0 +1,552 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audiokernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if(defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define FY_KERNELS_X86 1
+#include <immintrin.h>
+#define FY_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace {
+using Fooyin::Audio::Kernels::Level;
+
+// Largest float below 2^31; anything higher overflows when converted to int32
+constexpr float MaxS32Float = 2147483520.0F;
+constexpr float S16Scale    = 32768.0F;
+constexpr float S32Scale    = 2147483648.0F;
+constexpr float S16ToFloat  = 1.0F / 32767.0F;
+constexpr float S32ToFloat  = 1.0F / 2147483647.0F;
+
+Level detectLevel()
+{
+#ifdef FY_KERNELS_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return Level::AVX2;
+    }
+    // SSE2 is part of the x86-64 baseline
+    return Level::SSE2;
+#else
+    return Level::Scalar;
+#endif
+}
+
+std::atomic<Level>& currentLevel()
+{
+    static std::atomic<Level> level{detectLevel()};
+    return level;
+}
+
+namespace Scalar {
+template <typename T>
+void interleave(const uint8_t* const* in, std::byte* out, int channels, int frames, int start = 0)
+{
+    auto* dst = out + static_cast<ptrdiff_t>(start) * channels * sizeof(T);
+
+    for(int i{start}; i < frames; ++i) {
+        const auto offset = static_cast<ptrdiff_t>(i) * sizeof(T);
+        for(int ch{0}; ch < channels; ++ch) {
+            std::memcpy(dst, in[ch] + offset, sizeof(T));
+            dst += sizeof(T);
+        }
+    }
+}
+
+void interleave(const uint8_t* const* in, std::byte* out, int channels, int frames, int bytesPerSample,
+                int start = 0)
+{
+    switch(bytesPerSample) {
+        case(1):
+            interleave<uint8_t>(in, out, channels, frames, start);
+            break;
+        case(2):
+            interleave<int16_t>(in, out, channels, frames, start);
+            break;
+        case(4):
+            interleave<int32_t>(in, out, channels, frames, start);
+            break;
+        default:
+            break;
+    }
+}
+
+void floatToS16(const float* in, int16_t* out, size_t count, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        const float sample = std::clamp(in[i] * S16Scale, -S16Scale, S16Scale - 1.0F);
+        out[i]             = static_cast<int16_t>(std::lrint(sample));
+    }
+}
+
+void floatToS32(const float* in, int32_t* out, size_t count, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        const float sample = std::clamp(in[i] * S32Scale, -S32Scale, MaxS32Float);
+        out[i]             = static_cast<int32_t>(std::lrint(sample));
+    }
+}
+
+void s16ToFloat(const int16_t* in, float* out, size_t count, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * S16ToFloat;
+    }
+}
+
+void s32ToFloat(const int32_t* in, float* out, size_t count, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        out[i] = static_cast<float>(in[i]) * S32ToFloat;
+    }
+}
+
+void scaleS16(int16_t* data, size_t count, float gain, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        const float sample = std::clamp(static_cast<float>(data[i]) * gain, -S16Scale, S16Scale - 1.0F);
+        data[i]            = static_cast<int16_t>(sample);
+    }
+}
+
+void scaleS32(int32_t* data, size_t count, double gain, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        const double sample = std::clamp(static_cast<double>(data[i]) * gain, -2147483648.0, 2147483647.0);
+        data[i]             = static_cast<int32_t>(sample);
+    }
+}
+
+void scaleFloat(float* data, size_t count, float gain, size_t start = 0)
+{
+    for(size_t i{start}; i < count; ++i) {
+        data[i] *= gain;
+    }
+}
+
+// Unsigned 8bit samples are centred on 128
+void scaleU8(uint8_t* data, size_t count, float gain)
+{
+    for(size_t i{0}; i < count; ++i) {
+        const float sample = std::clamp(static_cast<float>(data[i] - 128) * gain, -128.0F, 127.0F);
+        data[i]            = static_cast<uint8_t>(static_cast<int>(sample) + 128);
+    }
+}
+} // namespace Scalar
+
+#ifdef FY_KERNELS_X86
+namespace SSE2 {
+void interleave(const uint8_t* const* in, std::byte* out, int channels, int frames, int bytesPerSample)
+{
+    if(channels != 2 || bytesPerSample == 1) {
+        Scalar::interleave(in, out, channels, frames, bytesPerSample);
+        return;
+    }
+
+    const auto* left  = in[0];
+    const auto* right = in[1];
+    auto* dst         = reinterpret_cast<uint8_t*>(out);
+
+    // 16 bytes of each channel per iteration
+    const int step = 16 / bytesPerSample;
+    int i{0};
+
+    for(; i + step <= frames; i += step) {
+        const int offset = i * bytesPerSample;
+        const __m128i l  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + offset));
+        const __m128i r  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + offset));
+
+        const __m128i lo = bytesPerSample == 2 ? _mm_unpacklo_epi16(l, r) : _mm_unpacklo_epi32(l, r);
+        const __m128i hi = bytesPerSample == 2 ? _mm_unpackhi_epi16(l, r) : _mm_unpackhi_epi32(l, r);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (2 * offset)), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + (2 * offset) + 16), hi);
+    }
+
+    Scalar::interleave(in, out, channels, frames, bytesPerSample, i);
+}
+
+void floatToS16(const float* in, int16_t* out, size_t count)
+{
+    const __m128 scale  = _mm_set1_ps(S16Scale);
+    const __m128 minVal = _mm_set1_ps(-S16Scale);
+    const __m128 maxVal = _mm_set1_ps(S16Scale - 1.0F);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(in + i + 4), scale);
+        a        = _mm_min_ps(_mm_max_ps(a, minVal), maxVal);
+        b        = _mm_min_ps(_mm_max_ps(b, minVal), maxVal);
+
+        const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+
+    Scalar::floatToS16(in, out, count, i);
+}
+
+void floatToS32(const float* in, int32_t* out, size_t count)
+{
+    const __m128 scale  = _mm_set1_ps(S32Scale);
+    const __m128 minVal = _mm_set1_ps(-S32Scale);
+    const __m128 maxVal = _mm_set1_ps(MaxS32Float);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        a        = _mm_min_ps(_mm_max_ps(a, minVal), maxVal);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(a));
+    }
+
+    Scalar::floatToS32(in, out, count, i);
+}
+
+void s16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(S16ToFloat);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign extend to 32bit
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    Scalar::s16ToFloat(in, out, count, i);
+}
+
+void s32ToFloat(const int32_t* in, float* out, size_t count)
+{
+    const __m128 scale = _mm_set1_ps(S32ToFloat);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), scale));
+    }
+
+    Scalar::s32ToFloat(in, out, count, i);
+}
+
+void scaleS16(int16_t* data, size_t count, float gain)
+{
+    const __m128 factor = _mm_set1_ps(gain);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i lo      = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        const __m128i hi      = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+        const __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(lo), factor);
+        const __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(hi), factor);
+
+        // packs saturates to the 16bit range
+        const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), packed);
+    }
+
+    Scalar::scaleS16(data, count, gain, i);
+}
+
+void scaleS32(int32_t* data, size_t count, double gain)
+{
+    const __m128d factor = _mm_set1_pd(gain);
+    const __m128d minVal = _mm_set1_pd(-2147483648.0);
+    const __m128d maxVal = _mm_set1_pd(2147483647.0);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        __m128d lo = _mm_mul_pd(_mm_cvtepi32_pd(samples), factor);
+        __m128d hi = _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(samples, _MM_SHUFFLE(1, 0, 3, 2))), factor);
+        lo         = _mm_min_pd(_mm_max_pd(lo, minVal), maxVal);
+        hi         = _mm_min_pd(_mm_max_pd(hi, minVal), maxVal);
+
+        const __m128i result = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), result);
+    }
+
+    Scalar::scaleS32(data, count, gain, i);
+}
+
+void scaleFloat(float* data, size_t count, float gain)
+{
+    const __m128 factor = _mm_set1_ps(gain);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), factor));
+    }
+
+    Scalar::scaleFloat(data, count, gain, i);
+}
+} // namespace SSE2
+
+namespace AVX2 {
+FY_TARGET_AVX2 void interleave(const uint8_t* const* in, std::byte* out, int channels, int frames,
+                               int bytesPerSample)
+{
+    if(channels != 2 || bytesPerSample == 1) {
+        Scalar::interleave(in, out, channels, frames, bytesPerSample);
+        return;
+    }
+
+    const auto* left  = in[0];
+    const auto* right = in[1];
+    auto* dst         = reinterpret_cast<uint8_t*>(out);
+
+    // 32 bytes of each channel per iteration
+    const int step = 32 / bytesPerSample;
+    int i{0};
+
+    for(; i + step <= frames; i += step) {
+        const int offset = i * bytesPerSample;
+        const __m256i l  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(left + offset));
+        const __m256i r  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(right + offset));
+
+        // Unpacking works within 128bit lanes, so the halves need reordering afterwards
+        const __m256i lo = bytesPerSample == 2 ? _mm256_unpacklo_epi16(l, r) : _mm256_unpacklo_epi32(l, r);
+        const __m256i hi = bytesPerSample == 2 ? _mm256_unpackhi_epi16(l, r) : _mm256_unpackhi_epi32(l, r);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (2 * offset)), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (2 * offset) + 32),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    Scalar::interleave(in, out, channels, frames, bytesPerSample, i);
+}
+
+FY_TARGET_AVX2 void floatToS16(const float* in, int16_t* out, size_t count)
+{
+    const __m256 scale  = _mm256_set1_ps(S16Scale);
+    const __m256 minVal = _mm256_set1_ps(-S16Scale);
+    const __m256 maxVal = _mm256_set1_ps(S16Scale - 1.0F);
+
+    size_t i{0};
+    for(; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale);
+        a        = _mm256_min_ps(_mm256_max_ps(a, minVal), maxVal);
+        b        = _mm256_min_ps(_mm256_max_ps(b, minVal), maxVal);
+
+        // Packing works within 128bit lanes, so restore the order of the 64bit blocks
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    Scalar::floatToS16(in, out, count, i);
+}
+
+FY_TARGET_AVX2 void floatToS32(const float* in, int32_t* out, size_t count)
+{
+    const __m256 scale  = _mm256_set1_ps(S32Scale);
+    const __m256 minVal = _mm256_set1_ps(-S32Scale);
+    const __m256 maxVal = _mm256_set1_ps(MaxS32Float);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+        a        = _mm256_min_ps(_mm256_max_ps(a, minVal), maxVal);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvtps_epi32(a));
+    }
+
+    Scalar::floatToS32(in, out, count, i);
+}
+
+FY_TARGET_AVX2 void s16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(S16ToFloat);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m256 values   = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(values, scale));
+    }
+
+    Scalar::s16ToFloat(in, out, count, i);
+}
+
+FY_TARGET_AVX2 void s32ToFloat(const int32_t* in, float* out, size_t count)
+{
+    const __m256 scale = _mm256_set1_ps(S32ToFloat);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(samples), scale));
+    }
+
+    Scalar::s32ToFloat(in, out, count, i);
+}
+
+FY_TARGET_AVX2 void scaleS16(int16_t* data, size_t count, float gain)
+{
+    const __m256 factor = _mm256_set1_ps(gain);
+
+    size_t i{0};
+    for(; i + 16 <= count; i += 16) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 8));
+
+        const __m256 a = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo)), factor);
+        const __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi)), factor);
+
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(a), _mm256_cvttps_epi32(b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    Scalar::scaleS16(data, count, gain, i);
+}
+
+FY_TARGET_AVX2 void scaleS32(int32_t* data, size_t count, double gain)
+{
+    const __m256d factor = _mm256_set1_pd(gain);
+    const __m256d minVal = _mm256_set1_pd(-2147483648.0);
+    const __m256d maxVal = _mm256_set1_pd(2147483647.0);
+
+    size_t i{0};
+    for(; i + 4 <= count; i += 4) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        __m256d values = _mm256_mul_pd(_mm256_cvtepi32_pd(samples), factor);
+        values         = _mm256_min_pd(_mm256_max_pd(values, minVal), maxVal);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm256_cvttpd_epi32(values));
+    }
+
+    Scalar::scaleS32(data, count, gain, i);
+}
+
+FY_TARGET_AVX2 void scaleFloat(float* data, size_t count, float gain)
+{
+    const __m256 factor = _mm256_set1_ps(gain);
+
+    size_t i{0};
+    for(; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), factor));
+    }
+
+    Scalar::scaleFloat(data, count, gain, i);
+}
+} // namespace AVX2
+#endif
+} // namespace
+
+#ifdef FY_KERNELS_X86
+#define FY_DISPATCH(func, ...)                                                                                         \
+    switch(currentLevel().load(std::memory_order_relaxed)) {                                                           \
+        case(Level::AVX2):                                                                                             \
+            return AVX2::func(__VA_ARGS__);                                                                            \
+        case(Level::SSE2):                                                                                             \
+            return SSE2::func(__VA_ARGS__);                                                                            \
+        case(Level::Scalar):                                                                                           \
+        default:                                                                                                       \
+            return Scalar::func(__VA_ARGS__);                                                                          \
+    }
+#else
+#define FY_DISPATCH(func, ...) return Scalar::func(__VA_ARGS__);
+#endif
+
+namespace Fooyin::Audio::Kernels {
+Level level()
+{
+    return currentLevel().load(std::memory_order_relaxed);
+}
+
+void setLevel(Level level)
+{
+    currentLevel().store(std::min(level, detectLevel()), std::memory_order_relaxed);
+}
+
+void interleave(const uint8_t* const* in, std::byte* out, int channels, int frames, int bytesPerSample)
+{
+    FY_DISPATCH(interleave, in, out, channels, frames, bytesPerSample)
+}
+
+void floatToS16(const float* in, int16_t* out, size_t count)
+{
+    FY_DISPATCH(floatToS16, in, out, count)
+}
+
+void floatToS32(const float* in, int32_t* out, size_t count)
+{
+    FY_DISPATCH(floatToS32, in, out, count)
+}
+
+void s16ToFloat(const int16_t* in, float* out, size_t count)
+{
+    FY_DISPATCH(s16ToFloat, in, out, count)
+}
+
+void s32ToFloat(const int32_t* in, float* out, size_t count)
+{
+    FY_DISPATCH(s32ToFloat, in, out, count)
+}
+
+void scaleS16(int16_t* data, size_t count, float gain)
+{
+    FY_DISPATCH(scaleS16, data, count, gain)
+}
+
+void scaleS32(int32_t* data, size_t count, double gain)
+{
+    FY_DISPATCH(scaleS32, data, count, gain)
+}
+
+void scaleFloat(float* data, size_t count, float gain)
+{
+    FY_DISPATCH(scaleFloat, data, count, gain)
+}
+
+void applyGain(std::byte* data, size_t bytes, SampleFormat format, double gain)
+{
+    switch(format) {
+        case(SampleFormat::U8):
+            Scalar::scaleU8(reinterpret_cast<uint8_t*>(data), bytes, static_cast<float>(gain));
+            break;
+        case(SampleFormat::S16):
+            scaleS16(reinterpret_cast<int16_t*>(data), bytes / sizeof(int16_t), static_cast<float>(gain));
+            break;
+        case(SampleFormat::S24):
+        case(SampleFormat::S32):
+            scaleS32(reinterpret_cast<int32_t*>(data), bytes / sizeof(int32_t), gain);
+            break;
+        case(SampleFormat::Float):
+            scaleFloat(reinterpret_cast<float*>(data), bytes / sizeof(float), static_cast<float>(gain));
+            break;
+        case(SampleFormat::Unknown):
+        default:
+            break;
+    }
+}
+} // namespace Fooyin::Audio::Kernels
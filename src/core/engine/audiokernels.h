@@ -0,0 +1,74 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioformat.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * Vectorised sample processing kernels.
+ * The best implementation for the running CPU (AVX2, SSE2 or scalar) is selected once at startup.
+ * @note all counts are in samples (frames * channels) unless stated otherwise.
+ */
+namespace Fooyin::Audio::Kernels {
+enum class Level
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/** Returns the instruction set level the kernels are currently using. */
+FYCORE_EXPORT Level level();
+/*!
+ * Forces the kernels to use @p level, or the best supported level if @p level isn't supported.
+ * @note only intended for tests and benchmarks.
+ */
+FYCORE_EXPORT void setLevel(Level level);
+
+/*!
+ * Interleaves @p frames frames of planar audio from @p in (one plane per channel)
+ * into @p out. @p bytesPerSample must be 1, 2 or 4.
+ */
+FYCORE_EXPORT void interleave(const uint8_t* const* in, std::byte* out, int channels, int frames,
+                              int bytesPerSample);
+
+/** Converts float samples to signed 16bit, rounding to nearest and clamping to range. */
+FYCORE_EXPORT void floatToS16(const float* in, int16_t* out, size_t count);
+/** Converts float samples to signed 32bit, rounding to nearest and clamping to range. */
+FYCORE_EXPORT void floatToS32(const float* in, int32_t* out, size_t count);
+FYCORE_EXPORT void s16ToFloat(const int16_t* in, float* out, size_t count);
+FYCORE_EXPORT void s32ToFloat(const int32_t* in, float* out, size_t count);
+
+/** Multiplies each sample by @p gain in place, truncating integer samples towards zero. */
+FYCORE_EXPORT void scaleS16(int16_t* data, size_t count, float gain);
+FYCORE_EXPORT void scaleS32(int32_t* data, size_t count, double gain);
+FYCORE_EXPORT void scaleFloat(float* data, size_t count, float gain);
+
+/*!
+ * Multiplies the @p bytes bytes of @p format samples in @p data by @p gain in place,
+ * saturating integer formats to their range.
+ */
+FYCORE_EXPORT void applyGain(std::byte* data, size_t bytes, SampleFormat format, double gain);
+} // namespace Fooyin::Audio::Kernels
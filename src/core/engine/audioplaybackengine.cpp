@@ -22,6 +22,7 @@
 #include "audioclock.h"
 #include "audiorenderer.h"
 #include "engine/ffmpeg/ffmpegdecoder.h"
+#include "replaygain.h"
 
 #include <core/coresettings.h>
 #include <core/engine/audiobuffer.h>
@@ -37,6 +38,14 @@ using namespace std::chrono_literals;
 namespace Fooyin {
 struct AudioPlaybackEngine::Private
 {
+    // A track opened and partially decoded before it's needed
+    struct PreparedTrack
+    {
+        Track track;
+        std::unique_ptr<AudioDecoder> decoder;
+        AudioBuffer buffer;
+    };
+
     AudioEngine* self;
 
     SettingsManager* settings;
@@ -47,36 +56,55 @@ struct AudioPlaybackEngine::Private
     TrackStatus status{NoTrack};
     PlaybackState state{StoppedState};
     uint64_t lastPosition{0};
+    uint64_t lastRenderedPosition{0};
 
-    uint64_t totalBufferTime{0};
     uint64_t bufferLength{0};
+    uint64_t preloadTime{0};
 
     uint64_t duration{0};
     double volume{1.0};
+    Track currentTrack;
 
     AudioFormat format;
 
     std::unique_ptr<AudioDecoder> decoder;
+    AudioBuffer preparedBuffer;
     AudioRenderer* renderer;
 
+    PreparedTrack nextTrack;
+    // The track still being rendered after the next track has been spliced in
+    std::unique_ptr<AudioDecoder> finishingDecoder;
+    Track finishingTrack;
+    bool splicePending{false};
+    bool trackSpliced{false};
+    bool inputFinished{false};
+    bool nextTrackRequested{false};
+
     QTimer* bufferTimer;
 
     explicit Private(AudioEngine* self_, SettingsManager* settings_)
         : self{self_}
         , settings{settings_}
         , bufferLength{static_cast<uint64_t>(settings->value<Settings::Core::BufferLength>())}
+        , preloadTime{static_cast<uint64_t>(settings->value<Settings::Core::PreloadTime>())}
         , decoder{std::make_unique<FFmpegDecoder>()}
         , renderer{new AudioRenderer(self)}
         , bufferTimer{new QTimer(self)}
     {
         bufferTimer->setInterval(10ms);
 
-        settings->subscribe<Settings::Core::BufferLength>(self, [this](int length) { bufferLength = length; });
+        renderer->setBufferLength(bufferLength);
 
-        QObject::connect(renderer, &AudioRenderer::bufferProcessed, self, [this](const AudioBuffer& buffer) {
-            totalBufferTime -= buffer.duration();
-            clock.sync(buffer.startTime());
+        settings->subscribe<Settings::Core::BufferLength>(self, [this](int length) {
+            bufferLength = length;
+            renderer->setBufferLength(bufferLength);
         });
+        settings->subscribe<Settings::Core::PreloadTime>(self, [this](int time) { preloadTime = time; });
+
+        settings->subscribe<Settings::Core::ReplayGainMode>(self, [this]() { updateReplayGain(); });
+        settings->subscribe<Settings::Core::ReplayGainPreAmp>(self, [this]() { updateReplayGain(); });
+        settings->subscribe<Settings::Core::ReplayGainNoClip>(self, [this]() { updateReplayGain(); });
+
         QObject::connect(renderer, &AudioRenderer::finished, self, [this]() { onRendererFinished(); });
 
         QObject::connect(bufferTimer, &QTimer::timeout, self, [this]() { readNextBuffer(); });
@@ -93,24 +121,98 @@ struct AudioPlaybackEngine::Private
         return positionUpdateTimer;
     }
 
+    [[nodiscard]] double replayGain(const Track& track) const
+    {
+        const auto type     = static_cast<ReplayGainType>(settings->value<Settings::Core::ReplayGainMode>());
+        const double preAmp = settings->value<Settings::Core::ReplayGainPreAmp>();
+        const bool noClip   = settings->value<Settings::Core::ReplayGainNoClip>();
+
+        return ReplayGain::trackGain(track, type, preAmp, noClip);
+    }
+
+    void updateReplayGain() const
+    {
+        const double gain = replayGain(currentTrack);
+        renderer->setReplayGain(gain);
+        renderer->setCurrentReplayGain(splicePending ? replayGain(finishingTrack) : gain);
+    }
+
+    void requestNextTrack()
+    {
+        if(!std::exchange(nextTrackRequested, true)) {
+            QMetaObject::invokeMethod(self, &AudioEngine::trackAboutToFinish);
+        }
+    }
+
     void readNextBuffer()
     {
-        if(totalBufferTime >= bufferLength) {
+        if(!renderer->writePending() || renderer->bufferedDuration() >= bufferLength) {
             return;
         }
 
-        const auto buffer = decoder->readBuffer();
+        const auto buffer = preparedBuffer.isValid() ? std::exchange(preparedBuffer, {}) : decoder->readBuffer();
         if(buffer.isValid()) {
-            totalBufferTime += buffer.duration();
             renderer->queueBuffer(buffer);
+
+            if(duration > 0 && buffer.startTime() + preloadTime >= duration) {
+                requestNextTrack();
+            }
         }
         else {
-            bufferTimer->stop();
             renderer->queueBuffer({});
-            QMetaObject::invokeMethod(self, &AudioEngine::trackAboutToFinish);
+            inputFinished = true;
+            requestNextTrack();
+
+            if(!spliceNextTrack()) {
+                bufferTimer->stop();
+            }
         }
     }
 
+    // Continues decoding from the prepared next track, so the renderer plays it straight after the current one
+    bool spliceNextTrack()
+    {
+        if(!inputFinished || splicePending || !nextTrack.decoder || nextTrack.decoder->format() != format
+           || !settings->value<Settings::Core::GaplessPlayback>()) {
+            return false;
+        }
+
+        finishingDecoder = std::exchange(decoder, std::move(nextTrack.decoder));
+        finishingTrack   = std::exchange(currentTrack, nextTrack.track);
+        preparedBuffer   = std::exchange(nextTrack.buffer, {});
+        nextTrack        = {};
+
+        decoder->start();
+
+        duration           = currentTrack.duration();
+        splicePending      = true;
+        inputFinished      = false;
+        nextTrackRequested = false;
+
+        renderer->setReplayGain(replayGain(currentTrack));
+
+        return true;
+    }
+
+    // Returns the spliced track to the prepared slot, so the finishing track can be controlled again
+    void cancelSplice()
+    {
+        trackSpliced = false;
+
+        if(!std::exchange(splicePending, false)) {
+            return;
+        }
+
+        decoder->stop();
+
+        nextTrack = {.track   = std::exchange(currentTrack, finishingTrack),
+                     .decoder = std::exchange(decoder, std::move(finishingDecoder)),
+                     .buffer  = {}};
+
+        preparedBuffer = {};
+        duration       = currentTrack.duration();
+    }
+
     PlaybackState changeState(PlaybackState newState)
     {
         auto prevState = std::exchange(state, newState);
@@ -131,6 +233,11 @@ struct AudioPlaybackEngine::Private
 
     void updatePosition()
     {
+        const uint64_t renderedPosition = renderer->position();
+        if(std::exchange(lastRenderedPosition, renderedPosition) != renderedPosition) {
+            clock.sync(renderedPosition);
+        }
+
         if(std::exchange(lastPosition, clock.currentPosition()) != lastPosition) {
             emit self->positionChanged(lastPosition);
         }
@@ -162,8 +269,17 @@ struct AudioPlaybackEngine::Private
 
     void onRendererFinished()
     {
-        clock.setPaused(true);
-        clock.sync(duration);
+        if(std::exchange(splicePending, false)) {
+            // The spliced track is already playing
+            finishingDecoder.reset();
+            finishingTrack = {};
+            trackSpliced   = true;
+            clock.sync();
+        }
+        else {
+            clock.setPaused(true);
+            clock.sync(duration);
+        }
 
         changeTrackStatus(EndOfTrack);
     }
@@ -182,20 +298,23 @@ struct AudioPlaybackEngine::Private
 
     void resetWorkers()
     {
+        cancelSplice();
+        inputFinished = false;
         bufferTimer->stop();
         clock.setPaused(true);
         renderer->reset();
-        totalBufferTime = 0;
     }
 
     void stopWorkers()
     {
+        cancelSplice();
+        inputFinished  = false;
+        preparedBuffer = {};
         bufferTimer->stop();
         clock.setPaused(true);
         clock.sync();
         renderer->stop();
         decoder->stop();
-        totalBufferTime = 0;
     }
 };
 
@@ -236,6 +355,13 @@ void AudioPlaybackEngine::seek(uint64_t pos)
 
 void AudioPlaybackEngine::changeTrack(const Track& track)
 {
+    if(std::exchange(p->trackSpliced, false) && track == p->currentTrack) {
+        // Already playing without a gap
+        emit positionChanged(0);
+        p->changeTrackStatus(BufferedTrack);
+        return;
+    }
+
     p->stopWorkers();
 
     emit positionChanged(0);
@@ -243,16 +369,32 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
     p->clock.setPaused(true);
     p->clock.sync();
 
+    p->currentTrack       = track;
+    p->duration           = track.duration();
+    p->nextTrackRequested = false;
+
     if(!track.isValid()) {
+        p->nextTrack = {};
         p->changeTrackStatus(InvalidTrack);
         return;
     }
 
     p->changeTrackStatus(LoadingTrack);
+    p->updateReplayGain();
 
-    if(!p->decoder->init(track.filepath())) {
-        p->changeTrackStatus(InvalidTrack);
-        return;
+    if(p->nextTrack.decoder && p->nextTrack.track == track) {
+        // Skip reopening the file if it was prepared in advance
+        p->decoder        = std::move(p->nextTrack.decoder);
+        p->preparedBuffer = std::exchange(p->nextTrack.buffer, {});
+        p->nextTrack      = {};
+    }
+    else {
+        p->nextTrack = {};
+
+        if(!p->decoder->init(track.filepath())) {
+            p->changeTrackStatus(InvalidTrack);
+            return;
+        }
     }
 
     if(!p->updateFormat(p->decoder->format())) {
@@ -267,6 +409,30 @@ void AudioPlaybackEngine::changeTrack(const Track& track)
     }
 }
 
+void AudioPlaybackEngine::prepareNextTrack(const Track& track)
+{
+    p->nextTrack = {};
+
+    if(!track.isValid() || !p->settings->value<Settings::Core::GaplessPlayback>()) {
+        return;
+    }
+
+    auto decoder = std::make_unique<FFmpegDecoder>();
+    if(!decoder->init(track.filepath())) {
+        return;
+    }
+
+    decoder->start();
+    const AudioBuffer buffer = decoder->readBuffer();
+
+    p->nextTrack = {.track = track, .decoder = std::move(decoder), .buffer = buffer};
+
+    // The current track may have already finished decoding
+    if(p->spliceNextTrack() && p->state == PlayingState) {
+        p->bufferTimer->start();
+    }
+}
+
 void AudioPlaybackEngine::setState(PlaybackState state)
 {
     const auto prevState = p->changeState(state);
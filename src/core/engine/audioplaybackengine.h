@@ -36,6 +36,7 @@ public slots:
     void seek(uint64_t pos) override;
 
     void changeTrack(const Track& track) override;
+    void prepareNextTrack(const Track& track) override;
     void setState(PlaybackState state) override;
 
     void play() override;
@@ -19,14 +19,79 @@
 
 #include "audiorenderer.h"
 
+#include "audiokernels.h"
+#include "audioringbuffer.h"
+
 #include <core/engine/audiobuffer.h>
 #include <core/engine/audiooutput.h>
-#include <utils/threadqueue.h>
 
 #include <QDebug>
-#include <QTimer>
+#include <QThread>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <utility>
 
+namespace {
+// A point in the ring buffer's byte stream where the track timeline changes
+struct TimelineMarker
+{
+    uint64_t offset{0};
+    uint64_t startTime{0};
+    double gain{1.0};
+    bool endOfTrack{false};
+};
+
+// Lock-free single-producer/single-consumer queue of timeline markers
+class MarkerQueue
+{
+public:
+    bool push(const TimelineMarker& marker)
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) >= Size) {
+            return false;
+        }
+
+        m_markers.at(tail % Size) = marker;
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    [[nodiscard]] std::optional<TimelineMarker> front() const
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        if(head == m_tail.load(std::memory_order_acquire)) {
+            return {};
+        }
+        return m_markers.at(head % Size);
+    }
+
+    void pop()
+    {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    void clear()
+    {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t Size = 32;
+
+    std::array<TimelineMarker, Size> m_markers;
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_tail{0};
+};
+} // namespace
+
 namespace Fooyin {
 struct AudioRenderer::Private
 {
@@ -34,27 +99,59 @@ struct AudioRenderer::Private
 
     std::unique_ptr<AudioOutput> audioOutput;
     AudioFormat format;
-    double volume{0.0};
+    // Read by the output's real-time thread, so changed without taking renderMutex
+    std::atomic<double> volume{0.0};
+    std::atomic<double> timelineGain{1.0};
+    std::atomic<bool> isRunning{false};
     int bufferSize{0};
-
+    uint64_t bufferLength{0};
+    bool pullMode{false};
+
+    AudioRingBuffer ringBuffer;
+    MarkerQueue markers;
+    std::atomic<uint64_t> position{0};
+    std::atomic<bool> endQueued{false};
+    // Tracks which have finished rendering, reported by the render thread
+    std::atomic<int> tracksFinished{0};
+
+    // Only accessed from the engine thread
+    double queueGain{1.0};
+    AudioBuffer pendingBuffer;
+    int pendingOffset{0};
+    bool pendingEnd{false};
+    bool trackStarted{false};
+
+    // Only accessed with outputMutex held
+    AudioBuffer renderBuffer;
     bool bufferPrefilled{false};
-
-    ThreadQueue<AudioBuffer> bufferQueue{false};
-    AudioBuffer tempBuffer;
-    int totalSamplesWritten{0};
-    int currentBufferOffset{0};
-
-    bool isRunning{false};
-
-    QTimer* writeTimer;
+    uint64_t totalSamplesWritten{0};
+
+    // Only accessed with renderMutex held (render thread, or the output's thread in pull mode)
+    uint64_t timelineOffset{0};
+    uint64_t timelineStart{0};
+    bool softwareVolume{false};
+    bool startRequested{false};
+    bool outputReset{false};
+
+    // Guards the output, and is always taken before renderMutex
+    std::mutex outputMutex;
+    // Guards the queue bookkeeping only, so it's never held while the output is busy
+    std::mutex renderMutex;
+    std::condition_variable renderCond;
+    std::chrono::milliseconds interval{1};
+    bool quit{false};
+    uint64_t wakeups{0};
+
+    QThread* renderThread;
 
     explicit Private(AudioRenderer* self_)
         : self{self_}
-        , writeTimer{new QTimer(self)}
+        , renderThread{QThread::create([this]() { renderLoop(); })}
     {
-        QObject::connect(writeTimer, &QTimer::timeout, self, [this]() { writeNext(); });
+        renderThread->setObjectName(QStringLiteral("Render Thread"));
     }
 
+    // Must be called with outputMutex held
     bool initOutput()
     {
         if(!audioOutput->init(format)) {
@@ -62,104 +159,308 @@ struct AudioRenderer::Private
         }
 
         audioOutput->setVolume(volume);
-        bufferSize = audioOutput->bufferSize();
-        updateInterval();
+        bufferSize               = audioOutput->bufferSize();
+        const bool pullsAudio    = audioOutput->pullsAudio();
+        const bool handlesVolume = audioOutput->canHandleVolume();
+
+        renderBuffer = {format, 0};
+        renderBuffer.reserve(static_cast<size_t>(format.bytesForFrames(bufferSize)));
+
+        {
+            const std::scoped_lock lock{renderMutex};
+
+            pullMode       = pullsAudio;
+            softwareVolume = !handlesVolume;
+            updateInterval();
+
+            const auto capacity
+                = static_cast<size_t>(format.bytesForDuration(bufferLength) + format.bytesForFrames(bufferSize));
+            if(ringBuffer.capacity() != capacity) {
+                ringBuffer.resize(capacity);
+                clearQueue();
+            }
+        }
+
+        if(pullMode) {
+            audioOutput->setAudioSource([this](std::byte* data, int frames) { return pullAudio(data, frames); });
+        }
 
         return true;
     }
 
-    void updateInterval() const
+    // AudioFormat::durationForBytes takes an int, which overflows after a couple of GiB of a single track
+    [[nodiscard]] uint64_t durationForBytes(uint64_t bytes) const
     {
-        const auto interval = static_cast<int>(static_cast<double>(bufferSize) / format.sampleRate() * 1000 * 0.25);
-        writeTimer->setInterval(interval);
+        const auto bytesPerSecond = static_cast<uint64_t>(format.sampleRate()) * format.bytesPerFrame();
+        return bytesPerSecond > 0 ? bytes * 1000 / bytesPerSecond : 0;
     }
 
-    void writeNext()
+    void updateInterval()
     {
-        if(!isRunning || bufferQueue.empty() || !audioOutput->initialised()) {
-            return;
+        const auto ms = static_cast<int>(static_cast<double>(bufferSize) / format.sampleRate() * 1000 * 0.25);
+        interval      = std::chrono::milliseconds{std::max(ms, 1)};
+    }
+
+    void wake()
+    {
+        {
+            const std::scoped_lock lock{renderMutex};
+            ++wakeups;
         }
+        renderCond.notify_all();
+    }
 
-        const int samples = audioOutput->currentState().freeSamples;
+    // Must be called with renderMutex held
+    void clearQueue()
+    {
+        ringBuffer.clear();
+        markers.clear();
+        endQueued.store(false, std::memory_order_release);
+
+        pendingBuffer  = {};
+        pendingOffset  = 0;
+        pendingEnd     = false;
+        trackStarted   = false;
+        timelineOffset = 0;
+        timelineStart  = 0;
+        startRequested = false;
+        timelineGain.store(1.0, std::memory_order_relaxed);
+
+        // Applied by the render thread, as the output may be in use
+        outputReset = true;
+    }
 
-        if((samples == 0 && totalSamplesWritten > 0) || (samples > 0 && renderAudio(samples) == samples)) {
-            if(!bufferPrefilled) {
-                bufferPrefilled = true;
-                audioOutput->start();
-            }
+    void queueEnd()
+    {
+        if(!markers.push({.offset = ringBuffer.totalWritten(), .endOfTrack = true})) {
+            qWarning() << "[Renderer] Timeline marker queue is full";
         }
+        endQueued.store(true, std::memory_order_release);
+        trackStarted = false;
     }
 
-    int writeAudioSamples(int samples)
+    void renderLoop()
     {
-        tempBuffer.clear();
+        std::unique_lock lock{renderMutex};
+
+        while(!quit) {
+            if(!isRunning) {
+                if(tracksFinished.load(std::memory_order_relaxed) > 0) {
+                    lock.unlock();
+                    notifyFinished();
+                    lock.lock();
+                    continue;
+                }
+                renderCond.wait(lock);
+                continue;
+            }
 
-        int samplesBuffered{0};
+            const uint64_t wakeup = wakeups;
 
-        const int sstride = format.bytesPerFrame();
+            lock.unlock();
+            const bool idle = renderNext();
+            notifyFinished();
+            lock.lock();
 
-        while(isRunning && !bufferQueue.empty() && samplesBuffered < samples) {
-            const AudioBuffer& buffer = bufferQueue.front();
+            const auto woken = [this, wakeup]() { return quit || wakeups != wakeup; };
 
-            if(!buffer.isValid()) {
-                // End of file
-                currentBufferOffset = 0;
-                bufferQueue.dequeue();
-                QMetaObject::invokeMethod(self, &AudioRenderer::finished);
-                return samplesBuffered;
+            if(idle) {
+                renderCond.wait(lock, woken);
+            }
+            else {
+                renderCond.wait_for(lock, interval, woken);
             }
+        }
+    }
 
-            const int bytesLeft = buffer.byteCount() - currentBufferOffset;
+    // Called from the render thread without renderMutex held. Returns true if there's nothing to do until woken.
+    bool renderNext()
+    {
+        const std::scoped_lock lock{outputMutex};
 
-            if(bytesLeft <= 0) {
-                currentBufferOffset = 0;
-                emit self->bufferProcessed(buffer);
-                bufferQueue.dequeue();
-                continue;
+        if(!audioOutput || !audioOutput->initialised()) {
+            return true;
+        }
+
+        {
+            const std::scoped_lock renderLock{renderMutex};
+            if(std::exchange(outputReset, false)) {
+                bufferPrefilled     = false;
+                totalSamplesWritten = 0;
             }
+        }
 
-            const int sampleCount = std::min(bytesLeft / sstride, samples - samplesBuffered);
-            const int bytes       = sampleCount * sstride;
-            const auto fdata      = buffer.constData().subspan(currentBufferOffset, static_cast<size_t>(bytes));
+        if(pullMode) {
+            // The output reads from its own thread; we only need to start it once prefilled,
+            // then keep polling to report finished tracks
+            prefillOutput();
+            return false;
+        }
+
+        writeNext();
+        return false;
+    }
+
+    void startOutput()
+    {
+        if(!std::exchange(bufferPrefilled, true)) {
+            audioOutput->start();
+        }
+    }
+
+    void prefillOutput()
+    {
+        const auto prefillBytes = static_cast<size_t>(format.bytesForFrames(bufferSize));
+
+        if(ringBuffer.readAvailable() >= prefillBytes || endQueued.load(std::memory_order_acquire)) {
+            startOutput();
+        }
+    }
 
-            if(!tempBuffer.isValid()) {
-                tempBuffer = {fdata, buffer.format(), buffer.startTime()};
+    // Called from the render thread, as posting an event allocates and locks
+    void notifyFinished()
+    {
+        for(int count = tracksFinished.exchange(0, std::memory_order_acq_rel); count > 0; --count) {
+            QMetaObject::invokeMethod(self, &AudioRenderer::finished, Qt::QueuedConnection);
+        }
+    }
+
+    void writeNext()
+    {
+        const int samples = audioOutput->currentState().freeSamples;
+
+        bool start = samples == 0 && totalSamplesWritten > 0;
+        if(samples > 0) {
+            start = renderAudio(samples) == samples;
+        }
+
+        {
+            const std::scoped_lock lock{renderMutex};
+            processMarkers();
+            start = std::exchange(startRequested, false) || start;
+        }
+
+        if(start) {
+            startOutput();
+        }
+    }
+
+    void processMarkers()
+    {
+        const uint64_t readPos = ringBuffer.totalRead();
+
+        while(const auto marker = markers.front()) {
+            if(marker->offset > readPos) {
+                return;
+            }
+
+            markers.pop();
+
+            if(marker->endOfTrack) {
+                endQueued.store(false, std::memory_order_release);
+                // Start any track shorter than the output buffer
+                startRequested = !pullMode;
+                // May be on the output's real-time thread, so only flag it here
+                tracksFinished.fetch_add(1, std::memory_order_release);
             }
             else {
-                tempBuffer.append(fdata);
+                timelineOffset = marker->offset;
+                timelineStart  = marker->startTime;
+                timelineGain.store(marker->gain, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Reads up to @p bytes whole frames from the ring buffer, applying timeline changes as they're reached
+    size_t readAudio(std::byte* data, size_t bytes)
+    {
+        const auto bytesPerFrame = static_cast<size_t>(format.bytesPerFrame());
+
+        size_t bytesRead{0};
+
+        while(bytesRead < bytes) {
+            processMarkers();
+
+            auto count = std::min(bytes - bytesRead, ringBuffer.readAvailable());
+            if(const auto marker = markers.front()) {
+                count = std::min(count, static_cast<size_t>(marker->offset - ringBuffer.totalRead()));
             }
+            count -= count % bytesPerFrame;
 
-            samplesBuffered += sampleCount;
-            currentBufferOffset += bytes;
+            if(count == 0) {
+                break;
+            }
+
+            const size_t read = ringBuffer.read(data + bytesRead, count);
+            applyGain(data + bytesRead, read);
+            bytesRead += read;
         }
 
-        tempBuffer.fillRemainingWithSilence();
+        processMarkers();
 
-        if(!tempBuffer.isValid()) {
-            return 0;
+        const uint64_t renderedBytes = ringBuffer.totalRead() - timelineOffset;
+        position.store(timelineStart + durationForBytes(renderedBytes), std::memory_order_release);
+
+        return bytesRead;
+    }
+
+    // Applies ReplayGain and, if the output can't, software volume in a single pass
+    void applyGain(std::byte* data, size_t bytes) const
+    {
+        double gain = timelineGain.load(std::memory_order_relaxed);
+        if(softwareVolume) {
+            gain *= volume.load(std::memory_order_relaxed);
         }
 
-        return samplesBuffered;
+        if(gain != 1.0) {
+            Audio::Kernels::applyGain(data, bytes, format.sampleFormat(), gain);
+        }
     }
 
     int renderAudio(int samples)
     {
-        if(writeAudioSamples(samples) == 0) {
-            return 0;
-        }
+        renderBuffer.resize(static_cast<size_t>(format.bytesForFrames(samples)));
 
-        if(!audioOutput->canHandleVolume()) {
-            tempBuffer.adjustVolumeOfSamples(volume);
+        size_t bytes{0};
+        {
+            const std::scoped_lock lock{renderMutex};
+            bytes = readAudio(renderBuffer.data(), renderBuffer.constData().size());
         }
 
-        if(!tempBuffer.isValid()) {
+        if(bytes == 0) {
             return 0;
         }
 
-        const int samplesWritten = audioOutput->write(tempBuffer);
-        totalSamplesWritten += samplesWritten;
+        renderBuffer.resize(bytes);
+
+        // Written without renderMutex, so a slow device doesn't hold up the engine
+        totalSamplesWritten += audioOutput->write(renderBuffer);
+
+        return format.framesForBytes(static_cast<int>(bytes));
+    }
+
+    // Called from the output's real-time thread in pull mode
+    int pullAudio(std::byte* data, int frames)
+    {
+        const auto requested = static_cast<size_t>(format.bytesForFrames(frames));
+
+        size_t bytes{0};
+
+        // Never block the output's thread; just output silence while paused or the queue is being reset.
+        // Volume, gain and pause changes don't take renderMutex, so they never cause a dropout.
+        if(isRunning.load(std::memory_order_acquire)) {
+            const std::unique_lock lock{renderMutex, std::try_to_lock};
+            if(lock.owns_lock()) {
+                bytes = readAudio(data, requested);
+            }
+        }
+
+        if(bytes < requested) {
+            const bool unsignedFormat = format.sampleFormat() == SampleFormat::U8;
+            std::fill(data + bytes, data + requested, unsignedFormat ? std::byte{0x80} : std::byte{0});
+        }
 
-        return samplesWritten;
+        return format.framesForBytes(static_cast<int>(bytes));
     }
 };
 
@@ -168,10 +469,21 @@ AudioRenderer::AudioRenderer(QObject* parent)
     , p{std::make_unique<Private>(this)}
 {
     setObjectName(QStringLiteral("Renderer"));
+
+    p->renderThread->start(QThread::TimeCriticalPriority);
 }
 
 AudioRenderer::~AudioRenderer()
 {
+    {
+        const std::scoped_lock lock{p->renderMutex};
+        p->quit = true;
+    }
+    p->renderCond.notify_all();
+
+    p->renderThread->wait();
+    delete p->renderThread;
+
     if(p->audioOutput && p->audioOutput->initialised()) {
         p->audioOutput->uninit();
     }
@@ -179,70 +491,164 @@ AudioRenderer::~AudioRenderer()
 
 bool AudioRenderer::init(const AudioFormat& format)
 {
-    p->format = format;
+    bool success{false};
 
-    if(!p->audioOutput) {
-        return false;
-    }
+    {
+        const std::scoped_lock lock{p->outputMutex};
 
-    if(p->audioOutput->initialised()) {
-        p->audioOutput->uninit();
+        if(p->audioOutput && p->audioOutput->initialised()) {
+            p->audioOutput->uninit();
+        }
+
+        {
+            const std::scoped_lock renderLock{p->renderMutex};
+            p->format = format;
+        }
+
+        if(!p->audioOutput) {
+            return false;
+        }
+
+        success = p->initOutput();
     }
 
-    return p->initOutput();
+    p->wake();
+
+    return success;
 }
 
 void AudioRenderer::start()
 {
-    if(std::exchange(p->isRunning, true)) {
-        return;
+    {
+        const std::scoped_lock lock{p->renderMutex};
+        if(p->isRunning.exchange(true)) {
+            return;
+        }
+        ++p->wakeups;
     }
-
-    p->writeTimer->start();
+    p->renderCond.notify_all();
 }
 
 void AudioRenderer::stop()
 {
-    p->isRunning = false;
-    p->writeTimer->stop();
+    const std::scoped_lock lock{p->renderMutex};
 
-    p->bufferPrefilled     = false;
-    p->totalSamplesWritten = 0;
-    p->currentBufferOffset = 0;
-    p->bufferQueue.clear();
-    p->tempBuffer.reset();
+    p->isRunning = false;
+    p->clearQueue();
 }
 
 void AudioRenderer::reset()
 {
+    const std::scoped_lock outputLock{p->outputMutex};
+
     if(p->audioOutput && p->audioOutput->initialised()) {
         p->audioOutput->reset();
     }
 
-    p->bufferPrefilled     = false;
-    p->totalSamplesWritten = 0;
-    p->currentBufferOffset = 0;
-    p->bufferQueue.clear();
-    p->tempBuffer.reset();
+    const std::scoped_lock lock{p->renderMutex};
+    p->clearQueue();
 }
 
 void AudioRenderer::pause(bool paused)
 {
-    if(p->audioOutput && p->audioOutput->initialised()) {
-        p->audioOutput->setPaused(paused);
+    if(paused) {
+        // Stop rendering straight away, rather than once the output is free
+        p->isRunning.store(false, std::memory_order_release);
+    }
+
+    {
+        const std::scoped_lock lock{p->outputMutex};
+        if(p->audioOutput && p->audioOutput->initialised()) {
+            p->audioOutput->setPaused(paused);
+        }
     }
 
-    p->isRunning = !paused;
+    if(!paused) {
+        p->isRunning.store(true, std::memory_order_release);
+        p->wake();
+    }
 }
 
 void AudioRenderer::queueBuffer(const AudioBuffer& buffer)
 {
-    p->bufferQueue.enqueue(buffer);
+    if(!buffer.isValid()) {
+        if(p->pendingBuffer.isValid()) {
+            p->pendingEnd = true;
+        }
+        else {
+            p->queueEnd();
+        }
+        return;
+    }
+
+    if(!p->trackStarted) {
+        p->trackStarted = p->markers.push(
+            {.offset = p->ringBuffer.totalWritten(), .startTime = buffer.startTime(), .gain = p->queueGain});
+    }
+
+    const auto data     = buffer.constData();
+    const size_t queued = p->ringBuffer.write(data.data(), data.size());
+
+    if(queued < data.size()) {
+        p->pendingBuffer = buffer;
+        p->pendingOffset = static_cast<int>(queued);
+    }
+}
+
+bool AudioRenderer::writePending()
+{
+    if(!p->pendingBuffer.isValid()) {
+        return true;
+    }
+
+    const auto data = p->pendingBuffer.constData().subspan(static_cast<size_t>(p->pendingOffset));
+    p->pendingOffset += static_cast<int>(p->ringBuffer.write(data.data(), data.size()));
+
+    if(p->pendingOffset < p->pendingBuffer.byteCount()) {
+        return false;
+    }
+
+    p->pendingBuffer = {};
+    p->pendingOffset = 0;
+
+    if(std::exchange(p->pendingEnd, false)) {
+        p->queueEnd();
+    }
+
+    return true;
+}
+
+uint64_t AudioRenderer::bufferedDuration() const
+{
+    return p->durationForBytes(p->ringBuffer.readAvailable());
+}
+
+uint64_t AudioRenderer::position() const
+{
+    return p->position.load(std::memory_order_acquire);
+}
+
+void AudioRenderer::setBufferLength(uint64_t ms)
+{
+    p->bufferLength = ms;
+}
+
+void AudioRenderer::setReplayGain(double gain)
+{
+    p->queueGain = gain;
+}
+
+void AudioRenderer::setCurrentReplayGain(double gain)
+{
+    p->timelineGain.store(gain, std::memory_order_relaxed);
 }
 
 void AudioRenderer::updateOutput(const OutputCreator& output)
 {
     auto newOutput = output();
+
+    const std::scoped_lock lock{p->outputMutex};
+
     if(newOutput == p->audioOutput) {
         return;
     }
@@ -257,6 +663,8 @@ void AudioRenderer::updateOutput(const OutputCreator& output)
 
 void AudioRenderer::updateDevice(const QString& device)
 {
+    const std::scoped_lock lock{p->outputMutex};
+
     if(!p->audioOutput) {
         return;
     }
@@ -276,6 +684,8 @@ void AudioRenderer::updateVolume(double volume)
 {
     p->volume = volume;
 
+    const std::scoped_lock lock{p->outputMutex};
+
     if(p->audioOutput && p->audioOutput->canHandleVolume()) {
         p->audioOutput->setVolume(volume);
     }
@@ -27,6 +27,12 @@ namespace Fooyin {
 class AudioBuffer;
 class AudioFormat;
 
+/*!
+ * Feeds decoded PCM to an AudioOutput from a lock-free ring buffer filled by the engine thread.
+ * Push outputs are written to from a dedicated, high-priority render thread, while pull outputs
+ * read from the ring buffer directly on their own thread. The current playback position is
+ * published through atomics.
+ */
 class AudioRenderer : public QObject
 {
     Q_OBJECT
@@ -41,14 +47,38 @@ public:
     void reset();
     void pause(bool paused);
 
+    /*!
+     * Queues the samples in @p buffer for rendering.
+     * An invalid buffer marks the end of the current track; buffers queued after it start
+     * the next track, which is rendered without a gap.
+     * @note any samples which don't fit in the ring buffer are held until @fn writePending.
+     */
     void queueBuffer(const AudioBuffer& buffer);
+    /*!
+     * Writes any samples held back from the last call to @fn queueBuffer.
+     * @returns @c true if there are no samples left pending.
+     */
+    bool writePending();
+
+    /** Returns the duration of audio queued but not yet rendered. */
+    [[nodiscard]] uint64_t bufferedDuration() const;
+    /** Returns the track position of the last samples rendered. */
+    [[nodiscard]] uint64_t position() const;
+
+    void setBufferLength(uint64_t ms);
+    /*!
+     * Sets the linear ReplayGain applied to tracks queued from now on.
+     * This is combined with software volume when rendering.
+     */
+    void setReplayGain(double gain);
+    /** Changes the ReplayGain of the track currently being rendered. */
+    void setCurrentReplayGain(double gain);
 
     void updateOutput(const OutputCreator& output);
     void updateDevice(const QString& device);
     void updateVolume(double volume);
 
 signals:
-    void bufferProcessed(const AudioBuffer& buffer);
     void finished();
 
 private:
@@ -0,0 +1,125 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audioringbuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Fooyin {
+AudioRingBuffer::AudioRingBuffer(size_t capacity)
+{
+    resize(capacity);
+}
+
+void AudioRingBuffer::resize(size_t capacity)
+{
+    m_buffer.assign(capacity, std::byte{0});
+    clear();
+}
+
+void AudioRingBuffer::clear()
+{
+    m_readPos.store(0, std::memory_order_relaxed);
+    m_writePos.store(0, std::memory_order_release);
+}
+
+size_t AudioRingBuffer::capacity() const
+{
+    return m_buffer.size();
+}
+
+size_t AudioRingBuffer::readAvailable() const
+{
+    const uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+    const uint64_t readPos  = m_readPos.load(std::memory_order_acquire);
+    return static_cast<size_t>(writePos - readPos);
+}
+
+size_t AudioRingBuffer::writeAvailable() const
+{
+    return capacity() - readAvailable();
+}
+
+uint64_t AudioRingBuffer::totalRead() const
+{
+    return m_readPos.load(std::memory_order_acquire);
+}
+
+uint64_t AudioRingBuffer::totalWritten() const
+{
+    return m_writePos.load(std::memory_order_acquire);
+}
+
+size_t AudioRingBuffer::write(const std::byte* data, size_t size)
+{
+    if(m_buffer.empty()) {
+        return 0;
+    }
+
+    const uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+    const uint64_t readPos  = m_readPos.load(std::memory_order_acquire);
+    const size_t free       = capacity() - static_cast<size_t>(writePos - readPos);
+
+    const size_t count = std::min(size, free);
+    if(count == 0) {
+        return 0;
+    }
+
+    const size_t start = writePos % capacity();
+    const size_t first = std::min(count, capacity() - start);
+
+    std::memcpy(m_buffer.data() + start, data, first);
+    if(count > first) {
+        std::memcpy(m_buffer.data(), data + first, count - first);
+    }
+
+    m_writePos.store(writePos + count, std::memory_order_release);
+
+    return count;
+}
+
+size_t AudioRingBuffer::read(std::byte* data, size_t size)
+{
+    if(m_buffer.empty()) {
+        return 0;
+    }
+
+    const uint64_t readPos  = m_readPos.load(std::memory_order_relaxed);
+    const uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+    const auto available    = static_cast<size_t>(writePos - readPos);
+
+    const size_t count = std::min(size, available);
+    if(count == 0) {
+        return 0;
+    }
+
+    const size_t start = readPos % capacity();
+    const size_t first = std::min(count, capacity() - start);
+
+    std::memcpy(data, m_buffer.data() + start, first);
+    if(count > first) {
+        std::memcpy(data + first, m_buffer.data(), count - first);
+    }
+
+    m_readPos.store(readPos + count, std::memory_order_release);
+
+    return count;
+}
+} // namespace Fooyin
@@ -0,0 +1,77 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Fooyin {
+/*!
+ * A preallocated, lock-free single-producer/single-consumer ring buffer of raw PCM bytes.
+ * One thread may call @fn write while another calls @fn read without any locking.
+ * @note @fn resize and @fn clear are only safe when neither side is active.
+ */
+class FYCORE_EXPORT AudioRingBuffer
+{
+public:
+    AudioRingBuffer() = default;
+    explicit AudioRingBuffer(size_t capacity);
+
+    AudioRingBuffer(const AudioRingBuffer&)            = delete;
+    AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+    void resize(size_t capacity);
+    void clear();
+
+    [[nodiscard]] size_t capacity() const;
+    /** Returns the number of bytes available to the consumer. */
+    [[nodiscard]] size_t readAvailable() const;
+    /** Returns the number of bytes available to the producer. */
+    [[nodiscard]] size_t writeAvailable() const;
+
+    /** Total number of bytes consumed since the last @fn clear. */
+    [[nodiscard]] uint64_t totalRead() const;
+    /** Total number of bytes produced since the last @fn clear. */
+    [[nodiscard]] uint64_t totalWritten() const;
+
+    /*!
+     * Copies up to @p size bytes from @p data into the buffer.
+     * @note must only be called from the producer thread.
+     * @returns the number of bytes written.
+     */
+    size_t write(const std::byte* data, size_t size);
+    /*!
+     * Copies up to @p size bytes from the buffer into @p data.
+     * @note must only be called from the consumer thread.
+     * @returns the number of bytes read.
+     */
+    size_t read(std::byte* data, size_t size);
+
+private:
+    std::vector<std::byte> m_buffer;
+    // Monotonic counters; the difference is the number of readable bytes
+    alignas(64) std::atomic<uint64_t> m_readPos{0};
+    alignas(64) std::atomic<uint64_t> m_writePos{0};
+};
+} // namespace Fooyin
@@ -62,6 +62,8 @@ struct EngineHandler::Private
         engineThread.start();
 
         QObject::connect(playerController, &PlayerController::currentTrackChanged, engine, &AudioEngine::changeTrack);
+        QObject::connect(playerController, &PlayerController::nextTrackPreloading, engine,
+                         &AudioEngine::prepareNextTrack);
         QObject::connect(playerController, &PlayerController::positionMoved, engine, &AudioEngine::seek);
         QObject::connect(&engineThread, &QThread::finished, engine, &AudioEngine::deleteLater);
         QObject::connect(engine, &AudioEngine::trackAboutToFinish, self, &EngineHandler::trackAboutToFinish);
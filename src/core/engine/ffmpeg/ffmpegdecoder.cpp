@@ -25,6 +25,8 @@
 #include "ffmpegstream.h"
 #include "ffmpegutils.h"
 
+#include "engine/audiokernels.h"
+
 #include <core/engine/audiobuffer.h>
 #include <utils/worker.h>
 
@@ -41,19 +43,9 @@ using namespace std::chrono_literals;
 namespace {
 void interleaveSamples(uint8_t** in, Fooyin::AudioBuffer& buffer)
 {
-    const auto format  = buffer.format();
-    const int channels = format.channelCount();
-    const int samples  = buffer.frameCount();
-    const int bps      = format.bytesPerSample();
-    auto* out          = buffer.data();
-
-    for(int i{0}; i < samples; ++i) {
-        for(int ch{0}; ch < channels; ++ch) {
-            const auto inOffset  = i * bps;
-            const auto outOffset = (i * channels + ch) * bps;
-            std::memmove(out + outOffset, in[ch] + inOffset, bps);
-        }
-    }
+    const auto format = buffer.format();
+    Fooyin::Audio::Kernels::interleave(in, buffer.data(), format.channelCount(), buffer.frameCount(),
+                                       format.bytesPerSample());
 }
 
 void interleave(uint8_t** in, Fooyin::AudioBuffer& buffer)
@@ -88,6 +80,8 @@ struct FFmpegDecoder::Private
     FormatContextPtr context;
     Stream stream;
     Codec codec;
+    Packet packet;
+    Frame frame;
     AudioFormat audioFormat;
 
     Error error{NoError};
@@ -110,6 +104,8 @@ struct FFmpegDecoder::Private
         context.reset();
         stream = {};
         codec  = {};
+        packet = {};
+        frame  = {};
         buffer = {};
 
         error = Error::NoError;
@@ -125,6 +121,9 @@ struct FFmpegDecoder::Private
         }
 
         audioFormat = Utils::audioFormatFromCodec(stream.avStream()->codecpar);
+        // Reused for every packet read and frame decoded
+        packet = Packet{PacketPtr{av_packet_alloc()}};
+        frame  = Frame{FramePtr{av_frame_alloc()}, timeBase};
 
         return createCodec(stream.avStream());
     }
@@ -221,23 +220,26 @@ struct FFmpegDecoder::Private
         return true;
     }
 
-    void decodeAudio(const Packet& packet)
+    void decodeAudio()
     {
         if(!isDecoding) {
             return;
         }
 
-        int result = sendAVPacket(packet);
+        int result = sendAVPacket();
 
         if(result == AVERROR(EAGAIN)) {
             receiveAVFrames();
-            result = sendAVPacket(packet);
+            result = sendAVPacket();
 
             if(result != AVERROR(EAGAIN)) {
                 qWarning() << "Unexpected decoder behavior";
             }
         }
 
+        // The decoder holds its own reference, so the packet is free to be read into again
+        av_packet_unref(packet.avPacket());
+
         if(result == 0) {
             receiveAVFrames();
         }
@@ -248,7 +250,7 @@ struct FFmpegDecoder::Private
         return error != Error::NoError;
     }
 
-    [[nodiscard]] int sendAVPacket(const Packet& packet) const
+    [[nodiscard]] int sendAVPacket() const
     {
         if(hasError() || !isDecoding) {
             return -1;
@@ -263,8 +265,7 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        auto avFrame     = FramePtr(av_frame_alloc());
-        const int result = avcodec_receive_frame(codec.context(), avFrame.get());
+        const int result = avcodec_receive_frame(codec.context(), frame.avFrame());
 
         if(result == AVERROR_EOF) {
             return;
@@ -280,8 +281,6 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        const Frame frame{std::move(avFrame), timeBase};
-
         currentPts = frame.ptsMs();
 
         const auto sampleCount = audioFormat.bytesPerFrame() * frame.sampleCount();
@@ -302,7 +301,6 @@ struct FFmpegDecoder::Private
             return;
         }
 
-        const Packet packet(PacketPtr{av_packet_alloc()});
         const int readResult = av_read_frame(context.get(), packet.avPacket());
         if(readResult < 0) {
             if(readResult != AVERROR_EOF) {
@@ -310,18 +308,19 @@ struct FFmpegDecoder::Private
             }
             else if(!draining) {
                 draining = true;
-                decodeAudio(packet);
+                decodeAudio();
                 return;
             }
             return;
         }
 
         if(packet.avPacket()->stream_index != codec.streamIndex()) {
+            av_packet_unref(packet.avPacket());
             readNext();
             return;
         }
 
-        decodeAudio(packet);
+        decodeAudio();
     }
 
     void seek(uint64_t pos) const
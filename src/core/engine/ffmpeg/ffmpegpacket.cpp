@@ -28,6 +28,12 @@ Packet::Packet(Packet&& other) noexcept
     : m_packet{std::move(other.m_packet)}
 { }
 
+Packet& Packet::operator=(Packet&& other) noexcept
+{
+    m_packet = std::move(other.m_packet);
+    return *this;
+}
+
 bool Packet::isValid() const
 {
     return !!m_packet;
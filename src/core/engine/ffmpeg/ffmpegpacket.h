@@ -47,6 +47,7 @@ public:
     explicit Packet(PacketPtr packet);
 
     Packet(Packet&& other) noexcept;
+    Packet& operator=(Packet&& other) noexcept;
     Packet(const Packet& other)            = delete;
     Packet& operator=(const Packet& other) = delete;
 
@@ -0,0 +1,83 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "replaygain.h"
+
+#include <core/track.h>
+
+#include <QRegularExpression>
+
+#include <cmath>
+#include <optional>
+
+namespace {
+// Values are stored as e.g. "-6.54 dB" or "0.988553"
+std::optional<double> readValue(const Fooyin::Track& track, const QString& tag)
+{
+    const QStringList values = track.extraTag(tag);
+    if(values.empty()) {
+        return {};
+    }
+
+    static const QRegularExpression unitRegex{QStringLiteral("\\s*dB\\s*$"),
+                                              QRegularExpression::CaseInsensitiveOption};
+
+    QString value = values.front().trimmed();
+    value.remove(unitRegex);
+
+    bool ok{false};
+    const double result = value.toDouble(&ok);
+    if(!ok || !std::isfinite(result)) {
+        return {};
+    }
+
+    return result;
+}
+} // namespace
+
+namespace Fooyin::ReplayGain {
+double trackGain(const Track& track, ReplayGainType type, double preAmp, bool preventClipping)
+{
+    if(type == ReplayGainType::Disabled || !track.isValid()) {
+        return 1.0;
+    }
+
+    const auto trackGainDb = readValue(track, QStringLiteral("REPLAYGAIN_TRACK_GAIN"));
+    const auto trackPeak   = readValue(track, QStringLiteral("REPLAYGAIN_TRACK_PEAK"));
+    const auto albumGainDb = readValue(track, QStringLiteral("REPLAYGAIN_ALBUM_GAIN"));
+    const auto albumPeak   = readValue(track, QStringLiteral("REPLAYGAIN_ALBUM_PEAK"));
+
+    const bool useAlbum = type == ReplayGainType::Album ? albumGainDb.has_value() : !trackGainDb.has_value();
+
+    const auto gainDb = useAlbum ? albumGainDb : trackGainDb;
+    const auto peak   = useAlbum ? albumPeak : trackPeak;
+
+    if(!gainDb) {
+        return 1.0;
+    }
+
+    double gain = std::pow(10.0, (*gainDb + preAmp) / 20.0);
+
+    if(preventClipping && peak && *peak > 0.0) {
+        gain = std::min(gain, 1.0 / *peak);
+    }
+
+    return gain;
+}
+} // namespace Fooyin::ReplayGain
@@ -0,0 +1,35 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/engine/audioengine.h>
+
+namespace Fooyin::ReplayGain {
+/*!
+ * Returns the linear gain to apply to @p track, using the REPLAYGAIN_* tags read into its extra tags.
+ * Album gain falls back to track gain (and vice versa) if missing. Tracks without any ReplayGain info
+ * are played unaltered.
+ * @param preAmp additional gain in dB applied to tracks with ReplayGain info.
+ * @param preventClipping limits the gain so the tagged peak doesn't exceed full scale.
+ */
+FYCORE_EXPORT double trackGain(const Track& track, ReplayGainType type, double preAmp, bool preventClipping);
+} // namespace Fooyin::ReplayGain
@@ -47,6 +47,10 @@ CoreSettings::CoreSettings(SettingsManager* settingsManager)
     m_settings->createSetting<GaplessPlayback>(true, QStringLiteral("Engine/GaplessPlayback"));
     m_settings->createSetting<Language>(QStringLiteral(""), QStringLiteral("Language"));
     m_settings->createSetting<BufferLength>(4000, QStringLiteral("Engine/BufferLength"));
+    m_settings->createSetting<ReplayGainMode>(0, QStringLiteral("Engine/ReplayGainMode"));
+    m_settings->createSetting<ReplayGainPreAmp>(0.0, QStringLiteral("Engine/ReplayGainPreAmp"));
+    m_settings->createSetting<ReplayGainNoClip>(true, QStringLiteral("Engine/ReplayGainPreventClipping"));
+    m_settings->createSetting<PreloadTime>(5000, QStringLiteral("Engine/PreloadTime"));
 
     m_settings->createSetting<Internal::MonitorLibraries>(true, QStringLiteral("Library/MonitorLibraries"));
     m_settings->createTempSetting<Internal::MuteVolume>(m_settings->value<OutputVolume>());
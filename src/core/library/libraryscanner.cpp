@@ -20,6 +20,7 @@
 #include "libraryscanner.h"
 
 #include "database/database.h"
+#include "database/librarydatabase.h"
 #include "database/trackdatabase.h"
 #include "internalcoresettings.h"
 #include "library/libraryinfo.h"
@@ -27,17 +28,121 @@
 #include "tagging/tagreader.h"
 
 #include <core/track.h>
-#include <utils/fileutils.h>
 #include <utils/settings/settingsmanager.h>
+#include <utils/threadqueue.h>
 
 #include <QDir>
-#include <QFileSystemWatcher>
+#include <QThread>
 
+#include <atomic>
+#include <optional>
 #include <ranges>
+#include <thread>
+#include <unordered_set>
 
-constexpr auto BatchSize = 250;
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+constexpr auto BatchSize = 2000;
 
 namespace {
+// A file found during enumeration. An empty filepath tells a reader there's nothing left to read.
+struct PendingFile
+{
+    QString filepath;
+    uint64_t modifiedTime{0};
+};
+
+struct ReadResult
+{
+    enum class Status : uint8_t
+    {
+        Unchanged,
+        Changed,
+        New,
+        Failed,
+        // Sent once by each reader as it exits
+        Finished,
+    };
+
+    Status status{Status::Failed};
+    Fooyin::Track track;
+};
+
+uint64_t lastModified(const QFileInfo& info)
+{
+    const QDateTime lastModifiedTime{info.lastModified()};
+    if(lastModifiedTime.isValid()) {
+        return static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch());
+    }
+    return 0;
+}
+
+QString parentPath(const QString& path)
+{
+    return path.left(path.lastIndexOf(u'/'));
+}
+
+// Allows paths to be looked up by a view of part of another path, without allocating
+struct PathHash
+{
+    using is_transparent = void;
+
+    size_t operator()(QStringView path) const
+    {
+        return qHash(path);
+    }
+};
+using PathSet = std::unordered_set<QString, PathHash, std::equal_to<>>;
+
+// Returns true if @p filepath, or any directory above it, is in @p paths
+bool containsPathOrParent(const PathSet& paths, QStringView filepath)
+{
+    while(!filepath.isEmpty()) {
+        if(paths.contains(filepath)) {
+            return true;
+        }
+
+        const auto slash = filepath.lastIndexOf(u'/');
+        if(slash < 0) {
+            break;
+        }
+        filepath = filepath.left(slash);
+    }
+
+    return false;
+}
+
+std::optional<Fooyin::LibraryDirectory> directoryStamp(const QString& path)
+{
+    const QFileInfo info{path};
+    if(!info.isDir()) {
+        return {};
+    }
+
+    Fooyin::LibraryDirectory directory;
+    directory.modifiedTime = lastModified(info);
+
+#ifdef Q_OS_UNIX
+    // Catches a directory being replaced by another with the same modified time
+    struct stat dirStat{};
+    if(::stat(QFile::encodeName(path).constData(), &dirStat) == 0) {
+        directory.inode = static_cast<uint64_t>(dirStat.st_ino);
+    }
+#endif
+
+    return directory;
+}
+
+// The result of walking a library's directory tree
+struct DirectoryScan
+{
+    Fooyin::LibraryDirectoryMap directories;
+    std::unordered_set<QString> unchangedDirs;
+    std::unordered_set<QString> foundFiles;
+};
+
 Fooyin::Track matchMissingTrack(const Fooyin::TrackFieldMap& missingFiles, const Fooyin::TrackFieldMap& missingHashes,
                                 Fooyin::Track& track)
 {
@@ -67,6 +172,7 @@ struct LibraryScanner::Private
     std::unique_ptr<DbConnectionHandler> dbHandler;
 
     LibraryInfo currentLibrary;
+    LibraryDatabase libraryDatabase;
     TrackDatabase trackDatabase;
 
     int tracksProcessed{0};
@@ -83,18 +189,14 @@ struct LibraryScanner::Private
 
     void addWatcher(const Fooyin::LibraryInfo& library)
     {
-        auto watchPaths = [this, library](const QString& path) {
-            QStringList dirs = Utils::File::getAllSubdirectories(path);
-            dirs.append(path);
-            watchers[library.id].addPaths(dirs);
-        };
-
-        watchPaths(library.path);
-
-        QObject::connect(&watchers.at(library.id), &LibraryWatcher::libraryDirChanged, self,
-                         [this, watchPaths, library](const QString& dir) {
-                             watchPaths(dir);
-                             emit self->directoryChanged(library, dir);
+        auto& watcher = watchers[library.id];
+        watcher.watchLibrary(library.path);
+
+        QObject::connect(&watcher, &LibraryWatcher::libraryDirChanged, self,
+                         [this, library](const QString& dir) { emit self->directoryChanged(library, dir); });
+        QObject::connect(&watcher, &LibraryWatcher::filesChanged, self,
+                         [this, library](const QStringList& changedFiles, const QStringList& removedPaths) {
+                             emit self->filesChanged(library, changedFiles, removedPaths);
                          });
     }
 
@@ -116,9 +218,131 @@ struct LibraryScanner::Private
         trackDatabase.storeTracks(tracks);
     }
 
-    bool getAndSaveAllTracks(const QString& path, const TrackList& tracks)
+    /*!
+     * Stores the tracks and reports them along with the database revision which includes them.
+     * Every stored change must be reported, so the library knows which revision it matches.
+     */
+    void storeScanResult(TrackList& tracksToStore, TrackList& tracksToUpdate)
+    {
+        if(!self->mayRun() || (tracksToStore.empty() && tracksToUpdate.empty())) {
+            return;
+        }
+
+        trackDatabase.storeTracks(tracksToStore);
+        trackDatabase.storeTracks(tracksToUpdate);
+
+        emit self->scanUpdate(
+            {.addedTracks = tracksToStore, .updatedTracks = tracksToUpdate, .revision = trackDatabase.revision()});
+    }
+
+    /*!
+     * Walks the tree under @p dir, queueing the files of every directory which differs from @p index.
+     * Directories which match are skipped without being listed; their subdirectories are taken from @p index.
+     */
+    void enumerateFiles(const QDir& dir, const LibraryDirectoryMap& index, DirectoryScan& scan,
+                        ThreadQueue<PendingFile>& files, std::atomic<int>& filesFound) const
+    {
+        const QStringList extensions = Track::supportedFileExtensions();
+
+        std::unordered_map<QString, QStringList> indexedSubdirs;
+        for(const QString& dirPath : index | std::views::keys) {
+            indexedSubdirs[parentPath(dirPath)].append(dirPath);
+        }
+
+        QStringList stack{dir.absolutePath()};
+
+        while(!stack.isEmpty() && self->mayRun()) {
+            const QString dirPath = stack.takeLast();
+
+            // Stamp before listing so changes made while listing are picked up next time
+            const auto stamp = directoryStamp(dirPath);
+            if(!stamp) {
+                continue;
+            }
+
+            scan.directories.emplace(dirPath, stamp.value());
+
+            if(index.contains(dirPath) && index.at(dirPath) == stamp.value()) {
+                scan.unchangedDirs.emplace(dirPath);
+                if(indexedSubdirs.contains(dirPath)) {
+                    stack.append(indexedSubdirs.at(dirPath));
+                }
+                continue;
+            }
+
+            const QDir currentDir{dirPath};
+
+            const QFileInfoList subDirs = currentDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+            for(const auto& subDir : subDirs) {
+                stack.append(subDir.absoluteFilePath());
+            }
+
+            const QFileInfoList dirFiles = currentDir.entryInfoList(extensions, QDir::Files);
+            for(const auto& file : dirFiles) {
+                const QString filepath = file.absoluteFilePath();
+                scan.foundFiles.emplace(filepath);
+                files.enqueue({filepath, lastModified(file)});
+                filesFound.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void readFiles(const TrackFieldMap& trackPaths, ThreadQueue<PendingFile>& files,
+                   ThreadQueue<ReadResult>& results) const
+    {
+        while(self->mayRun()) {
+            const PendingFile file = files.dequeue();
+            if(file.filepath.isEmpty()) {
+                break;
+            }
+
+            if(trackPaths.contains(file.filepath)) {
+                const Track& libraryTrack = trackPaths.at(file.filepath);
+
+                if(libraryTrack.isEnabled() && libraryTrack.libraryId() == currentLibrary.id
+                   && libraryTrack.modifiedTime() == file.modifiedTime) {
+                    results.enqueue({.status = ReadResult::Status::Unchanged, .track = {}});
+                    continue;
+                }
+
+                Track changedTrack{libraryTrack};
+                if(Tagging::readMetaData(changedTrack)) {
+                    results.enqueue({.status = ReadResult::Status::Changed, .track = changedTrack});
+                    continue;
+                }
+            }
+            else {
+                Track track{file.filepath};
+                if(Tagging::readMetaData(track)) {
+                    results.enqueue({.status = ReadResult::Status::New, .track = track});
+                    continue;
+                }
+            }
+
+            results.enqueue({.status = ReadResult::Status::Failed, .track = {}});
+        }
+
+        results.enqueue({.status = ReadResult::Status::Finished, .track = {}});
+    }
+
+    /*!
+     * Scans @p path using a pipeline of three stages:
+     * - a thread enumerating the directory tree,
+     * - a pool of readers pulling files from a shared queue and reading their tags,
+     * - this thread, which matches missing tracks and writes to the database in large batches.
+     * Only this thread touches the database, as connections are per-thread.
+     *
+     * Directories matching @p index are assumed to still contain the same files, so a rescan
+     * of an unchanged library only stats its directories. Pass an empty index to read everything.
+     * @note editing a file in place doesn't change its directory's modified time, so files edited
+     * while the library wasn't being monitored are only picked up by a full scan.
+     */
+    bool getAndSaveAllTracks(const QString& path, const TrackList& tracks, const LibraryDirectoryMap& index,
+                             DirectoryScan& scan)
     {
         const QDir dir{path};
+        const QString root     = dir.absolutePath() + u'/';
+        const bool libraryRoot = dir.absolutePath() == QDir{currentLibrary.path}.absolutePath();
 
         TrackList tracksToStore;
         TrackList tracksToUpdate;
@@ -129,59 +353,232 @@ struct LibraryScanner::Private
 
         for(const Track& track : tracks) {
             trackPaths.emplace(track.filepath(), track);
+        }
 
-            if(!QFileInfo::exists(track.filepath())) {
-                missingFiles.emplace(track.filename(), track);
-                missingHashes.emplace(track.hash(), track);
+        tracksProcessed = 0;
+        totalTracks     = 0;
+        currentProgress = -1;
+
+        const int readerCount = std::max(1, QThread::idealThreadCount());
+
+        ThreadQueue<PendingFile> files;
+        ThreadQueue<ReadResult> results;
+        std::atomic<int> filesFound{0};
+        std::atomic<bool> enumerated{false};
+
+        std::thread enumerator{[&]() {
+            enumerateFiles(dir, index, scan, files, filesFound);
+            enumerated = true;
+            for(int i{0}; i < readerCount; ++i) {
+                files.enqueue({});
             }
+        }};
+
+        std::vector<std::thread> readers;
+        readers.reserve(readerCount);
+        for(int i{0}; i < readerCount; ++i) {
+            readers.emplace_back([&]() { readFiles(trackPaths, files, results); });
         }
 
-        const QStringList files = Utils::File::getFilesInDir(dir, Track::supportedFileExtensions());
+        // Tracks under the scanned path are checked against the walk. When scanning the whole library,
+        // any of its tracks stored outside the path are checked individually; a subdirectory scan leaves them alone.
+        auto findMissingTracks = [&]() {
+            for(const Track& track : tracks) {
+                const QString filepath = track.filepath();
+                bool exists{false};
 
-        tracksProcessed = 0;
-        totalTracks     = static_cast<double>(files.size());
-        currentProgress = -1;
+                if(filepath.startsWith(root)) {
+                    exists = scan.unchangedDirs.contains(parentPath(filepath)) || scan.foundFiles.contains(filepath);
+                }
+                else if(libraryRoot && track.libraryId() == currentLibrary.id) {
+                    exists = QFileInfo::exists(filepath);
+                }
+                else {
+                    continue;
+                }
 
-        for(const auto& filepath : files) {
-            if(!self->mayRun()) {
-                return false;
+                if(!exists) {
+                    missingFiles.emplace(track.filename(), track);
+                    missingHashes.emplace(track.hash(), track);
+                }
             }
+        };
+
+        auto setTrackProps = [this, &dir](Track& track) {
+            track.setLibraryId(currentLibrary.id);
+            track.setRelativePath(dir.relativeFilePath(track.filepath()));
+            track.setIsEnabled(true);
+        };
+
+        auto flush = [this, &tracksToStore, &tracksToUpdate]() {
+            storeScanResult(tracksToStore, tracksToUpdate);
 
+            tracksToStore.clear();
+            tracksToUpdate.clear();
+        };
+
+        auto handleResult = [&](ReadResult& result) {
             ++tracksProcessed;
 
-            const QFileInfo info{filepath};
-            const QDateTime lastModifiedTime{info.lastModified()};
-            uint64_t lastModified{0};
+            if(result.status == ReadResult::Status::Changed) {
+                Track& changedTrack = result.track;
+                setTrackProps(changedTrack);
 
-            if(lastModifiedTime.isValid()) {
-                lastModified = static_cast<uint64_t>(lastModifiedTime.toMSecsSinceEpoch());
+                tracksToUpdate.push_back(changedTrack);
+                missingHashes.erase(changedTrack.hash());
+                missingFiles.erase(changedTrack.filename());
             }
+            else if(result.status == ReadResult::Status::New) {
+                Track& track       = result.track;
+                Track refoundTrack = matchMissingTrack(missingFiles, missingHashes, track);
 
-            auto setTrackProps = [this, &filepath, &dir](Track& track) {
-                track.setFilePath(filepath);
-                track.setLibraryId(currentLibrary.id);
-                track.setRelativePath(dir.relativeFilePath(filepath));
-                track.setIsEnabled(true);
-            };
+                if(refoundTrack.isInLibrary() || refoundTrack.isInDatabase()) {
+                    missingHashes.erase(refoundTrack.hash());
+                    missingFiles.erase(refoundTrack.filename());
 
-            if(trackPaths.contains(filepath)) {
-                const Track& libraryTrack = trackPaths.at(filepath);
+                    refoundTrack.setFilePath(track.filepath());
+                    setTrackProps(refoundTrack);
+                    tracksToUpdate.push_back(refoundTrack);
+                }
+                else {
+                    setTrackProps(track);
+                    tracksToStore.push_back(track);
+                }
+            }
+
+            if(tracksToStore.size() + tracksToUpdate.size() >= BatchSize) {
+                flush();
+            }
 
-                if(!libraryTrack.isEnabled() || libraryTrack.libraryId() != currentLibrary.id
-                   || libraryTrack.modifiedTime() != lastModified) {
-                    Track changedTrack{libraryTrack};
-                    if(Tagging::readMetaData(changedTrack)) {
-                        setTrackProps(changedTrack);
+            if(totalTracks > 0) {
+                reportProgress();
+            }
+        };
 
-                        tracksToUpdate.push_back(changedTrack);
-                        missingHashes.erase(changedTrack.hash());
-                        missingFiles.erase(changedTrack.filename());
-                    }
+        // Results can't be matched against missing tracks until the walk is complete
+        std::vector<ReadResult> heldResults;
+        bool missingFound{false};
+
+        auto finishEnumeration = [&]() {
+            enumerator.join();
+            totalTracks = static_cast<double>(filesFound.load());
+            findMissingTracks();
+            missingFound = true;
+
+            for(auto& result : heldResults) {
+                handleResult(result);
+            }
+            heldResults.clear();
+        };
+
+        int readersFinished{0};
+
+        while(readersFinished < readerCount) {
+            ReadResult result = results.dequeue();
+
+            if(result.status == ReadResult::Status::Finished) {
+                ++readersFinished;
+                continue;
+            }
+            if(!self->mayRun()) {
+                // Keep draining until every reader has seen the cancellation
+                continue;
+            }
+
+            if(!missingFound) {
+                if(!enumerated) {
+                    heldResults.push_back(std::move(result));
+                    continue;
+                }
+                finishEnumeration();
+            }
+
+            handleResult(result);
+        }
+
+        for(auto& reader : readers) {
+            reader.join();
+        }
+
+        if(!self->mayRun()) {
+            if(enumerator.joinable()) {
+                enumerator.join();
+            }
+            return false;
+        }
+
+        if(!missingFound) {
+            finishEnumeration();
+        }
+
+        for(auto& track : missingFiles | std::views::values) {
+            if(track.isInLibrary() || track.isEnabled()) {
+                track.setLibraryId(-1);
+                track.setIsEnabled(false);
+                tracksToUpdate.push_back(track);
+            }
+        }
+
+        flush();
+
+        return true;
+    }
+
+    /*!
+     * Applies changes reported by a LibraryWatcher.
+     * Removed paths are first treated as missing, so files which were moved or renamed
+     * within the library can be matched to their existing tracks.
+     */
+    void updateFiles(const QStringList& changedFiles, const QStringList& removedPaths, const TrackList& tracks)
+    {
+        const QDir dir{currentLibrary.path};
+
+        TrackList tracksToStore;
+        TrackList tracksToUpdate;
+
+        TrackFieldMap trackPaths;
+        TrackFieldMap missingFiles;
+        TrackFieldMap missingHashes;
+
+        const PathSet removed{removedPaths.cbegin(), removedPaths.cend()};
+
+        for(const Track& track : tracks) {
+            const QString filepath = track.filepath();
+            trackPaths.emplace(filepath, track);
+
+            // The path may have been recreated since the event
+            if(!removed.empty() && containsPathOrParent(removed, filepath) && !QFileInfo::exists(filepath)) {
+                missingFiles.emplace(track.filename(), track);
+                missingHashes.emplace(track.hash(), track);
+            }
+        }
+
+        tracksProcessed = 0;
+        totalTracks     = static_cast<double>(changedFiles.size());
+        currentProgress = -1;
+
+        auto setTrackProps = [this, &dir](Track& track) {
+            track.setLibraryId(currentLibrary.id);
+            track.setRelativePath(dir.relativeFilePath(track.filepath()));
+            track.setIsEnabled(true);
+        };
+
+        for(const QString& filepath : changedFiles) {
+            if(!self->mayRun()) {
+                return;
+            }
+
+            ++tracksProcessed;
+
+            if(trackPaths.contains(filepath)) {
+                Track changedTrack{trackPaths.at(filepath)};
+                if(Tagging::readMetaData(changedTrack)) {
+                    setTrackProps(changedTrack);
+                    tracksToUpdate.push_back(changedTrack);
                 }
             }
             else {
                 Track track{filepath};
-
                 if(Tagging::readMetaData(track)) {
                     Track refoundTrack = matchMissingTrack(missingFiles, missingHashes, track);
 
@@ -189,6 +586,7 @@ struct LibraryScanner::Private
                         missingHashes.erase(refoundTrack.hash());
                         missingFiles.erase(refoundTrack.filename());
 
+                        refoundTrack.setFilePath(filepath);
                         setTrackProps(refoundTrack);
                         tracksToUpdate.push_back(refoundTrack);
                     }
@@ -196,12 +594,6 @@ struct LibraryScanner::Private
                         setTrackProps(track);
                         tracksToStore.push_back(track);
                     }
-
-                    if(tracksToStore.size() >= BatchSize) {
-                        storeTracks(tracksToStore);
-                        emit self->scanUpdate({.addedTracks = tracksToStore, .updatedTracks = {}});
-                        tracksToStore.clear();
-                    }
                 }
             }
 
@@ -216,14 +608,7 @@ struct LibraryScanner::Private
             }
         }
 
-        storeTracks(tracksToStore);
-        storeTracks(tracksToUpdate);
-
-        if(!tracksToStore.empty() || !tracksToUpdate.empty()) {
-            emit self->scanUpdate({tracksToStore, tracksToUpdate});
-        }
-
-        return true;
+        storeScanResult(tracksToStore, tracksToUpdate);
     }
 
     void changeLibraryStatus(LibraryInfo::Status status)
@@ -245,6 +630,7 @@ void LibraryScanner::initialiseThread()
     Worker::initialiseThread();
 
     p->dbHandler = std::make_unique<DbConnectionHandler>(p->dbPool);
+    p->libraryDatabase.initialise(DbConnectionProvider{p->dbPool});
     p->trackDatabase.initialise(DbConnectionProvider{p->dbPool});
 }
 
@@ -280,7 +666,7 @@ void LibraryScanner::setupWatchers(const LibraryInfoMap& libraries, bool enabled
     }
 }
 
-void LibraryScanner::scanLibrary(const LibraryInfo& library, const TrackList& tracks)
+void LibraryScanner::scanLibrary(const LibraryInfo& library, const TrackList& tracks, bool fullScan)
 {
     setState(Running);
 
@@ -292,7 +678,16 @@ void LibraryScanner::scanLibrary(const LibraryInfo& library, const TrackList& tr
         if(p->settings->value<Settings::Core::Internal::MonitorLibraries>() && !p->watchers.contains(library.id)) {
             p->addWatcher(library);
         }
-        p->getAndSaveAllTracks(library.path, tracks);
+
+        LibraryDirectoryMap index;
+        if(!fullScan) {
+            p->libraryDatabase.getDirectories(library.id, index);
+        }
+
+        DirectoryScan scan;
+        if(p->getAndSaveAllTracks(library.path, tracks, index, scan)) {
+            p->libraryDatabase.storeDirectories(library.id, scan.directories);
+        }
     }
 
     if(state() == Paused) {
@@ -315,7 +710,37 @@ void LibraryScanner::scanLibraryDirectory(const LibraryInfo& library, const QStr
 
     p->changeLibraryStatus(LibraryInfo::Status::Scanning);
 
-    p->getAndSaveAllTracks(dir, tracks);
+    // Unchanged subdirectories are skipped, so only what actually changed below dir is listed
+    LibraryDirectoryMap index;
+    p->libraryDatabase.getDirectories(library.id, index);
+
+    DirectoryScan scan;
+    if(p->getAndSaveAllTracks(dir, tracks, index, scan)) {
+        p->libraryDatabase.updateDirectories(library.id, QDir{dir}.absolutePath(), scan.directories);
+    }
+
+    if(state() == Paused) {
+        p->changeLibraryStatus(LibraryInfo::Status::Pending);
+    }
+    else {
+        p->changeLibraryStatus(p->settings->value<Settings::Core::Internal::MonitorLibraries>()
+                                   ? LibraryInfo::Status::Monitoring
+                                   : LibraryInfo::Status::Idle);
+        setState(Idle);
+        emit finished();
+    }
+}
+
+void LibraryScanner::scanLibraryFiles(const LibraryInfo& library, const QStringList& changedFiles,
+                                      const QStringList& removedPaths, const TrackList& tracks)
+{
+    setState(Running);
+
+    p->currentLibrary = library;
+
+    p->changeLibraryStatus(LibraryInfo::Status::Scanning);
+
+    p->updateFiles(changedFiles, removedPaths, tracks);
 
     if(state() == Paused) {
         p->changeLibraryStatus(LibraryInfo::Status::Pending);
@@ -375,7 +800,7 @@ void LibraryScanner::scanTracks(const TrackList& libraryTracks, const TrackList&
 
     std::ranges::copy(tracksToStore, std::back_inserter(tracksScanned));
 
-    emit scannedTracks(tracksScanned);
+    emit scannedTracks(tracksScanned, p->trackDatabase.revision());
 
     handleFinished();
 }
@@ -33,6 +33,8 @@ struct ScanResult
 {
     TrackList addedTracks;
     TrackList updatedTracks;
+    /** The TrackDatabase::revision once these tracks were stored. */
+    uint64_t revision{0};
 };
 
 class LibraryScanner : public Worker
@@ -50,13 +52,16 @@ signals:
     void progressChanged(int percent);
     void statusChanged(const LibraryInfo& library);
     void scanUpdate(const ScanResult& result);
-    void scannedTracks(const TrackList& tracks);
+    void scannedTracks(const TrackList& tracks, uint64_t revision);
     void directoryChanged(const LibraryInfo& library, const QString& dir);
+    void filesChanged(const LibraryInfo& library, const QStringList& changedFiles, const QStringList& removedPaths);
 
 public slots:
     void setupWatchers(const LibraryInfoMap& libraries, bool enabled);
-    void scanLibrary(const LibraryInfo& library, const TrackList& tracks);
+    void scanLibrary(const LibraryInfo& library, const TrackList& tracks, bool fullScan);
     void scanLibraryDirectory(const LibraryInfo& library, const QString& dir, const TrackList& tracks);
+    void scanLibraryFiles(const LibraryInfo& library, const QStringList& changedFiles,
+                          const QStringList& removedPaths, const TrackList& tracks);
     void scanTracks(const TrackList& libraryTracks, const TrackList& tracks);
 
 private:
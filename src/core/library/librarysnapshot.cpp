@@ -0,0 +1,203 @@
+/*
+ * Fooyin
+ * Copyright © 2023, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "librarysnapshot.h"
+
+#include <utils/paths.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+constexpr quint32 SnapshotMagic   = 0x46594C53; // FYLS
+constexpr quint32 SnapshotVersion = 2;
+constexpr auto StreamVersion      = QDataStream::Qt_6_0;
+
+namespace {
+void writeTrack(QDataStream& stream, const Fooyin::Track& track)
+{
+    stream << static_cast<qint32>(track.id()) << static_cast<qint32>(track.libraryId()) << track.isEnabled()
+           << track.hash() << static_cast<qint32>(track.type()) << track.filepath() << track.relativePath()
+           << track.title() << track.artists() << track.album() << track.albumArtists()
+           << static_cast<qint32>(track.trackNumber()) << static_cast<qint32>(track.trackTotal())
+           << static_cast<qint32>(track.discNumber()) << static_cast<qint32>(track.discTotal()) << track.genres()
+           << track.composer() << track.performer() << static_cast<quint64>(track.duration()) << track.comment()
+           << track.date() << static_cast<qint32>(track.year()) << track.extraTags()
+           << static_cast<quint64>(track.fileSize()) << static_cast<qint32>(track.bitrate())
+           << static_cast<qint32>(track.sampleRate()) << static_cast<qint32>(track.channels())
+           << static_cast<qint32>(track.playCount()) << static_cast<quint64>(track.addedTime())
+           << static_cast<quint64>(track.modifiedTime()) << static_cast<quint64>(track.firstPlayed())
+           << static_cast<quint64>(track.lastPlayed()) << track.sort();
+}
+
+Fooyin::Track readTrack(QDataStream& stream)
+{
+    qint32 id{0}, libraryId{0}, type{0}, trackNumber{0}, trackTotal{0}, discNumber{0}, discTotal{0}, year{0};
+    qint32 bitrate{0}, sampleRate{0}, channels{0}, playCount{0};
+    quint64 duration{0}, fileSize{0}, addedTime{0}, modifiedTime{0}, firstPlayed{0}, lastPlayed{0};
+    bool enabled{true};
+    QString hash, filepath, relativePath, title, album, composer, performer, comment, date, sort;
+    QStringList artists, albumArtists, genres;
+    Fooyin::Track::ExtraTags extraTags;
+
+    stream >> id >> libraryId >> enabled >> hash >> type >> filepath >> relativePath >> title >> artists >> album
+        >> albumArtists >> trackNumber >> trackTotal >> discNumber >> discTotal >> genres >> composer >> performer
+        >> duration >> comment >> date >> year >> extraTags >> fileSize >> bitrate >> sampleRate >> channels
+        >> playCount >> addedTime >> modifiedTime >> firstPlayed >> lastPlayed >> sort;
+
+    Fooyin::Track track{filepath};
+
+    track.setId(id);
+    track.setLibraryId(libraryId);
+    track.setIsEnabled(enabled);
+    track.setType(static_cast<Fooyin::Track::Type>(type));
+    track.setRelativePath(relativePath);
+    track.setTitle(title);
+    track.setArtists(artists);
+    track.setAlbum(album);
+    track.setAlbumArtists(albumArtists);
+    track.setTrackNumber(trackNumber);
+    track.setTrackTotal(trackTotal);
+    track.setDiscNumber(discNumber);
+    track.setDiscTotal(discTotal);
+    track.setGenres(genres);
+    track.setComposer(composer);
+    track.setPerformer(performer);
+    track.setDuration(duration);
+    track.setComment(comment);
+    track.setDate(date);
+    track.setYear(year);
+    track.setFileSize(fileSize);
+    track.setBitrate(bitrate);
+    track.setSampleRate(sampleRate);
+    track.setChannels(channels);
+    track.setPlayCount(playCount);
+    track.setAddedTime(addedTime);
+    track.setModifiedTime(modifiedTime);
+    track.setFirstPlayed(firstPlayed);
+    track.setLastPlayed(lastPlayed);
+    track.setSort(sort);
+    // Set last, as setting metadata regenerates an existing hash
+    track.setHash(hash);
+
+    if(!extraTags.isEmpty()) {
+        for(auto tagIt = extraTags.cbegin(); tagIt != extraTags.cend(); ++tagIt) {
+            for(const QString& value : tagIt.value()) {
+                track.addExtraTag(tagIt.key(), value);
+            }
+        }
+    }
+
+    return track;
+}
+} // namespace
+
+namespace Fooyin::LibrarySnapshot {
+QString defaultPath()
+{
+    return QDir{Utils::cachePath()}.filePath(QStringLiteral("library.snapshot"));
+}
+
+bool write(const QString& filepath, const TrackList& tracks, const QString& sortScript, uint64_t revision)
+{
+    QSaveFile file{filepath};
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[LibrarySnapshot] Could not open" << filepath << "for writing:" << file.errorString();
+        return false;
+    }
+
+    QDataStream stream{&file};
+    stream.setVersion(StreamVersion);
+
+    stream << SnapshotMagic << SnapshotVersion << sortScript << static_cast<quint64>(revision)
+           << static_cast<quint64>(tracks.size());
+
+    for(const Track& track : tracks) {
+        writeTrack(stream, track);
+    }
+
+    if(stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+
+    return file.commit();
+}
+
+std::optional<Snapshot> read(const QString& filepath)
+{
+    QFile file{filepath};
+    if(!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    // Map the file so it's read in one pass without buffered copies
+    const qint64 size = file.size();
+    uchar* data       = file.map(0, size);
+    if(!data) {
+        return {};
+    }
+
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), size);
+
+    QDataStream stream{bytes};
+    stream.setVersion(StreamVersion);
+
+    quint32 magic{0};
+    quint32 version{0};
+    quint64 revision{0};
+    quint64 count{0};
+    Snapshot snapshot;
+
+    stream >> magic >> version;
+    if(magic != SnapshotMagic || version != SnapshotVersion) {
+        file.unmap(data);
+        return {};
+    }
+
+    stream >> snapshot.sortScript >> revision >> count;
+    snapshot.revision = revision;
+
+    if(stream.status() == QDataStream::Ok) {
+        // Don't trust the count to reserve more than the file could hold
+        snapshot.tracks.reserve(std::min(count, static_cast<quint64>(size) / 64));
+        for(quint64 i{0}; i < count && stream.status() == QDataStream::Ok; ++i) {
+            snapshot.tracks.push_back(readTrack(stream));
+        }
+    }
+
+    const bool valid = stream.status() == QDataStream::Ok && stream.atEnd();
+
+    file.unmap(data);
+
+    if(!valid) {
+        qWarning() << "[LibrarySnapshot] Ignoring corrupt snapshot" << filepath;
+        return {};
+    }
+
+    return snapshot;
+}
+
+void remove(const QString& filepath)
+{
+    QFile::remove(filepath);
+}
+} // namespace Fooyin::LibrarySnapshot
@@ -0,0 +1,58 @@
+/*
+ * Fooyin
+ * Copyright © 2023, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <cstdint>
+#include <optional>
+
+namespace Fooyin::LibrarySnapshot {
+/*!
+ * A copy of the library's tracks, in sort order, which can be loaded at startup
+ * much faster than reading every row from the database.
+ * The database remains the source of truth; a snapshot is only a cache of it.
+ */
+struct Snapshot
+{
+    QString sortScript;
+    /** The TrackDatabase::revision the tracks were taken at. */
+    uint64_t revision{0};
+    TrackList tracks;
+};
+
+/** Returns the default location of the snapshot. */
+FYCORE_EXPORT QString defaultPath();
+
+/*!
+ * Writes @p tracks, sorted using @p sortScript and matching database @p revision, to @p filepath.
+ * The existing snapshot is only replaced once the new one has been fully written.
+ */
+FYCORE_EXPORT bool write(const QString& filepath, const TrackList& tracks, const QString& sortScript,
+                         uint64_t revision);
+
+/** Returns the snapshot at @p filepath, or std::nullopt if missing, corrupt or written by a different version. */
+FYCORE_EXPORT std::optional<Snapshot> read(const QString& filepath);
+
+/** Removes the snapshot at @p filepath, so it can't be loaded once it no longer matches the database. */
+FYCORE_EXPORT void remove(const QString& filepath);
+} // namespace Fooyin::LibrarySnapshot
@@ -46,6 +46,9 @@ struct LibraryScanRequest
     LibraryInfo library;
     QString dir;
     TrackList tracks;
+    QStringList changedFiles;
+    QStringList removedPaths;
+    bool fullScan{false};
 };
 
 struct LibraryThreadHandler::Private
@@ -86,8 +89,9 @@ struct LibraryThreadHandler::Private
 
     void scanLibrary(const LibraryScanRequest& request)
     {
-        QMetaObject::invokeMethod(&scanner,
-                                  [this, request]() { scanner.scanLibrary(request.library, library->tracks()); });
+        QMetaObject::invokeMethod(&scanner, [this, request]() {
+            scanner.scanLibrary(request.library, library->tracks(), request.fullScan);
+        });
     }
 
     void scanTracks(const LibraryScanRequest& request)
@@ -103,7 +107,14 @@ struct LibraryThreadHandler::Private
         });
     }
 
-    ScanRequest addLibraryScanRequest(const LibraryInfo& libraryInfo)
+    void scanFiles(const LibraryScanRequest& request)
+    {
+        QMetaObject::invokeMethod(&scanner, [this, request]() {
+            scanner.scanLibraryFiles(request.library, request.changedFiles, request.removedPaths, library->tracks());
+        });
+    }
+
+    ScanRequest addLibraryScanRequest(const LibraryInfo& libraryInfo, bool fullScan)
     {
         const int id = nextRequestId();
 
@@ -111,7 +122,8 @@ struct LibraryThreadHandler::Private
                                 cancelScanRequest(id);
                             }};
 
-        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, QStringLiteral(""), TrackList{});
+        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, QStringLiteral(""), TrackList{},
+                                  QStringList{}, QStringList{}, fullScan);
 
         if(scanRequests.size() == 1) {
             execNextRequest();
@@ -160,6 +172,25 @@ struct LibraryThreadHandler::Private
         return request;
     }
 
+    ScanRequest addFilesScanRequest(const LibraryInfo& libraryInfo, const QStringList& changedFiles,
+                                    const QStringList& removedPaths)
+    {
+        const int id = nextRequestId();
+
+        ScanRequest request{.type = ScanRequest::Library, .id = id, .cancel = [this, id]() {
+                                cancelScanRequest(id);
+                            }};
+
+        scanRequests.emplace_back(id, ScanRequest::Library, libraryInfo, QStringLiteral(""), TrackList{}, changedFiles,
+                                  removedPaths);
+
+        if(scanRequests.size() == 1) {
+            execNextRequest();
+        }
+
+        return request;
+    }
+
     std::optional<LibraryScanRequest> currentRequest() const
     {
         const auto requestIt = std::ranges::find_if(
@@ -183,7 +214,10 @@ struct LibraryThreadHandler::Private
             scanTracks(request);
         }
         else {
-            if(request.dir.isEmpty()) {
+            if(!request.changedFiles.isEmpty() || !request.removedPaths.isEmpty()) {
+                scanFiles(request);
+            }
+            else if(request.dir.isEmpty()) {
                 scanLibrary(request);
             }
             else {
@@ -227,18 +261,29 @@ LibraryThreadHandler::LibraryThreadHandler(DbConnectionPoolPtr dbPool, MusicLibr
 {
     QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::gotTracks, this,
                      &LibraryThreadHandler::gotTracks);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::gotSnapshot, this,
+                     &LibraryThreadHandler::gotSnapshot);
     QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::updatedTracks, this,
                      &LibraryThreadHandler::tracksUpdated);
+    QObject::connect(&p->trackDatabaseManager, &TrackDatabaseManager::revisionChanged, this,
+                     &LibraryThreadHandler::revisionChanged);
     QObject::connect(&p->scanner, &Worker::finished, this, [this]() { p->finishScanRequest(); });
     QObject::connect(&p->scanner, &LibraryScanner::progressChanged, this,
                      [this](int percent) { emit progressChanged(p->currentRequestId, percent); });
     QObject::connect(&p->scanner, &LibraryScanner::scannedTracks, this,
-                     [this](const TrackList& tracks) { emit scannedTracks(p->currentRequestId, tracks); });
+                     [this](const TrackList& tracks, uint64_t revision) {
+                         emit scannedTracks(p->currentRequestId, tracks, revision);
+                     });
     QObject::connect(&p->scanner, &LibraryScanner::statusChanged, this, &LibraryThreadHandler::statusChanged);
     QObject::connect(&p->scanner, &LibraryScanner::scanUpdate, this, &LibraryThreadHandler::scanUpdate);
     QObject::connect(
         &p->scanner, &LibraryScanner::directoryChanged, this,
         [this](const LibraryInfo& libraryInfo, const QString& dir) { p->addDirectoryScanRequest(libraryInfo, dir); });
+    QObject::connect(&p->scanner, &LibraryScanner::filesChanged, this,
+                     [this](const LibraryInfo& libraryInfo, const QStringList& changedFiles,
+                            const QStringList& removedPaths) {
+                         p->addFilesScanRequest(libraryInfo, changedFiles, removedPaths);
+                     });
 
     QMetaObject::invokeMethod(&p->scanner, &Worker::initialiseThread);
     QMetaObject::invokeMethod(&p->trackDatabaseManager, &Worker::initialiseThread);
@@ -264,9 +309,9 @@ void LibraryThreadHandler::setupWatchers(const LibraryInfoMap& libraries, bool e
                               [this, libraries, enabled]() { p->scanner.setupWatchers(libraries, enabled); });
 }
 
-ScanRequest LibraryThreadHandler::scanLibrary(const LibraryInfo& library)
+ScanRequest LibraryThreadHandler::scanLibrary(const LibraryInfo& library, bool fullScan)
 {
-    return p->addLibraryScanRequest(library);
+    return p->addLibraryScanRequest(library, fullScan);
 }
 
 ScanRequest LibraryThreadHandler::scanTracks(const TrackList& tracks)
@@ -45,7 +45,8 @@ public:
 
     void setupWatchers(const LibraryInfoMap& libraries, bool enabled);
 
-    ScanRequest scanLibrary(const LibraryInfo& library);
+    /** Scans @p library, reading every file if @p fullScan is set rather than only those in changed directories. */
+    ScanRequest scanLibrary(const LibraryInfo& library, bool fullScan);
     ScanRequest scanTracks(const TrackList& tracks);
 
     void saveUpdatedTracks(const TrackList& tracks);
@@ -56,12 +57,15 @@ public:
 
 signals:
     void progressChanged(int id, int percent);
-    void scannedTracks(int id, const TrackList& tracks);
+    void scannedTracks(int id, const TrackList& tracks, uint64_t revision);
     void statusChanged(const LibraryInfo& library);
     void scanUpdate(const ScanResult& result);
-    void tracksUpdated(const TrackList& tracks);
+    void tracksUpdated(const TrackList& tracks, uint64_t revision);
+    /** Emitted when the track database changed without any tracks to apply. */
+    void revisionChanged(uint64_t revision);
 
-    void gotTracks(const TrackList& result);
+    void gotTracks(const TrackList& result, uint64_t revision);
+    void gotSnapshot(const TrackList& tracks, const QString& sortScript, uint64_t revision);
 
 private:
     struct Private;
@@ -19,33 +19,423 @@
 
 #include "librarywatcher.h"
 
+#include <core/track.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
 #include <QTimer>
 
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#else
+#include <QFileSystemWatcher>
+#endif
+
+#include <map>
+#include <unordered_map>
+
 using namespace std::chrono_literals;
 
-constexpr auto Interval = 15ms;
+constexpr auto SettleInterval = 1s;
+constexpr auto PollInterval   = 60s;
+
+namespace {
+bool isWithin(const QString& path, const QString& dir)
+{
+    return path.size() > dir.size() && path.startsWith(dir) && path.at(dir.size()) == u'/';
+}
+
+QStringList subdirectories(const QString& path)
+{
+    QStringList dirs;
+
+    const QFileInfoList entries = QDir{path}.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for(const auto& entry : entries) {
+        dirs.append(entry.absoluteFilePath());
+    }
+
+    return dirs;
+}
+
+uint64_t modifiedTime(const QFileInfo& info)
+{
+    const QDateTime modified = info.lastModified();
+    return modified.isValid() ? static_cast<uint64_t>(modified.toMSecsSinceEpoch()) : 0;
+}
+} // namespace
 
 namespace Fooyin {
+struct LibraryWatcher::Private
+{
+    enum class Change : uint8_t
+    {
+        Modified,
+        Removed,
+    };
+
+    struct PolledDir
+    {
+        uint64_t modified{0};
+        QStringList subdirs;
+    };
+
+    LibraryWatcher* self;
+
+    QString root;
+    QStringList extensions;
+
+    QTimer settleTimer;
+    std::map<QString, Change> pendingFiles;
+    QStringList pendingDirs;
+
+#ifdef Q_OS_LINUX
+    int inotifyFd{-1};
+    QSocketNotifier* notifier{nullptr};
+    std::unordered_map<int, QString> watches;
+    std::unordered_map<QString, int> watchedPaths;
+#else
+    QFileSystemWatcher* fsWatcher{nullptr};
+#endif
+
+    QTimer pollTimer;
+    std::unordered_map<QString, PolledDir> polledDirs;
+
+    explicit Private(LibraryWatcher* self_)
+        : self{self_}
+    {
+        const QStringList filters = Track::supportedFileExtensions();
+        for(const QString& filter : filters) {
+            extensions.append(filter.mid(2));
+        }
+
+        settleTimer.setSingleShot(true);
+        settleTimer.setInterval(SettleInterval);
+        QObject::connect(&settleTimer, &QTimer::timeout, self, [this]() { flush(); });
+
+        pollTimer.setInterval(PollInterval);
+        QObject::connect(&pollTimer, &QTimer::timeout, self, [this]() { poll(true); });
+    }
+
+    ~Private()
+    {
+#ifdef Q_OS_LINUX
+        if(inotifyFd >= 0) {
+            ::close(inotifyFd);
+        }
+#endif
+    }
+
+    [[nodiscard]] bool isSupported(const QString& path) const
+    {
+        const auto suffixPos = path.lastIndexOf(u'.');
+        return suffixPos >= 0 && extensions.contains(path.mid(suffixPos + 1), Qt::CaseInsensitive);
+    }
+
+    void queueFile(const QString& path, Change change)
+    {
+        pendingFiles[path] = change;
+        settleTimer.start();
+    }
+
+    void queueDir(const QString& path)
+    {
+        if(!pendingDirs.contains(path)) {
+            pendingDirs.append(path);
+        }
+        settleTimer.start();
+    }
+
+    void flush()
+    {
+        // A directory scan covers everything beneath it
+        std::ranges::sort(pendingDirs);
+
+        QStringList dirs;
+        for(const QString& dir : pendingDirs) {
+            if(dirs.isEmpty() || (dir != dirs.constLast() && !isWithin(dir, dirs.constLast()))) {
+                dirs.append(dir);
+            }
+        }
+        pendingDirs.clear();
+
+        auto isCovered = [&dirs](const QString& path) {
+            return std::ranges::any_of(dirs, [&path](const QString& dir) { return isWithin(path, dir); });
+        };
+
+        QStringList changedFiles;
+        QStringList removedPaths;
+
+        for(const auto& [path, change] : pendingFiles) {
+            if(isCovered(path)) {
+                continue;
+            }
+            if(change == Change::Removed) {
+                removedPaths.append(path);
+            }
+            else {
+                changedFiles.append(path);
+            }
+        }
+        pendingFiles.clear();
+
+        // Directories first, so moved tracks can still be matched against their old location
+        for(const QString& dir : dirs) {
+            emit self->libraryDirChanged(dir);
+        }
+
+        if(!changedFiles.isEmpty() || !removedPaths.isEmpty()) {
+            emit self->filesChanged(changedFiles, removedPaths);
+        }
+    }
+
+    void startPolling()
+    {
+        qWarning() << "[LibraryWatcher] Unable to watch all directories in" << root
+                   << "- falling back to polling for changes";
+
+        // May be called while handling one of their signals
+#ifdef Q_OS_LINUX
+        if(notifier) {
+            notifier->deleteLater();
+            notifier = nullptr;
+        }
+        if(inotifyFd >= 0) {
+            ::close(inotifyFd);
+            inotifyFd = -1;
+        }
+        watches.clear();
+        watchedPaths.clear();
+#else
+        if(fsWatcher) {
+            fsWatcher->deleteLater();
+            fsWatcher = nullptr;
+        }
+#endif
+
+        poll(false);
+        pollTimer.start();
+    }
+
+    /*!
+     * Stats every known directory, only listing those whose modified time has changed.
+     * A new or removed directory changes the modified time of its parent, which is then rescanned.
+     */
+    void poll(bool report)
+    {
+        std::unordered_map<QString, PolledDir> currentDirs;
+
+        QStringList stack{root};
+
+        while(!stack.isEmpty()) {
+            const QString dir = stack.takeLast();
+
+            const QFileInfo info{dir};
+            if(!info.isDir()) {
+                continue;
+            }
+
+            PolledDir state{.modified = modifiedTime(info), .subdirs = {}};
+
+            const auto prevIt = polledDirs.find(dir);
+            if(prevIt != polledDirs.end() && prevIt->second.modified == state.modified) {
+                state.subdirs = prevIt->second.subdirs;
+            }
+            else {
+                state.subdirs = subdirectories(dir);
+                if(report && prevIt != polledDirs.end()) {
+                    queueDir(dir);
+                }
+            }
+
+            stack.append(state.subdirs);
+            currentDirs.emplace(dir, std::move(state));
+        }
+
+        polledDirs = std::move(currentDirs);
+    }
+
+#ifdef Q_OS_LINUX
+    bool initInotify()
+    {
+        inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(inotifyFd < 0) {
+            return false;
+        }
+
+        notifier = new QSocketNotifier(inotifyFd, QSocketNotifier::Read, self);
+        QObject::connect(notifier, &QSocketNotifier::activated, self, [this]() { readEvents(); });
+
+        return true;
+    }
+
+    bool addWatches(const QString& path)
+    {
+        static constexpr uint32_t WatchMask = IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE
+                                            | IN_ONLYDIR;
+
+        QStringList stack{path};
+
+        while(!stack.isEmpty()) {
+            const QString dir = stack.takeLast();
+
+            const int wd = ::inotify_add_watch(inotifyFd, QFile::encodeName(dir).constData(), WatchMask);
+            if(wd < 0) {
+                if(errno == ENOSPC || errno == ENOMEM) {
+                    return false;
+                }
+                // Removed or unreadable
+                continue;
+            }
+
+            watches[wd]       = dir;
+            watchedPaths[dir] = wd;
+
+            stack.append(subdirectories(dir));
+        }
+
+        return true;
+    }
+
+    void removeWatches(const QString& path)
+    {
+        std::erase_if(watchedPaths, [this, &path](const auto& watched) {
+            if(watched.first == path || isWithin(watched.first, path)) {
+                ::inotify_rm_watch(inotifyFd, watched.second);
+                watches.erase(watched.second);
+                return true;
+            }
+            return false;
+        });
+    }
+
+    void readEvents()
+    {
+        alignas(inotify_event) char buffer[4096];
+
+        while(inotifyFd >= 0) {
+            const auto length = ::read(inotifyFd, buffer, sizeof(buffer));
+            if(length <= 0) {
+                break;
+            }
+
+            for(const char* ptr = buffer; ptr < buffer + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                handleEvent(*event);
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+
+    void handleEvent(const inotify_event& event)
+    {
+        if(event.mask & IN_Q_OVERFLOW) {
+            // Events were dropped, so we no longer know what changed
+            queueDir(root);
+            return;
+        }
+
+        const auto watchIt = watches.find(event.wd);
+        if(watchIt == watches.end()) {
+            return;
+        }
+
+        if(event.mask & IN_IGNORED) {
+            watchedPaths.erase(watchIt->second);
+            watches.erase(watchIt);
+            return;
+        }
+
+        if(event.len == 0) {
+            return;
+        }
+
+        const QString path = watchIt->second + u'/' + QFile::decodeName(event.name);
+
+        if(event.mask & IN_ISDIR) {
+            if(event.mask & (IN_CREATE | IN_MOVED_TO)) {
+                // Files may have been added before the watch, so scan the whole directory
+                if(!addWatches(path)) {
+                    startPolling();
+                    return;
+                }
+                queueDir(path);
+            }
+            else if(event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+                removeWatches(path);
+                queueFile(path, Change::Removed);
+            }
+            return;
+        }
+
+        if(!isSupported(path)) {
+            return;
+        }
+
+        if(event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+            queueFile(path, Change::Modified);
+        }
+        else if(event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+            queueFile(path, Change::Removed);
+        }
+    }
+#else
+    bool initFsWatcher()
+    {
+        fsWatcher = new QFileSystemWatcher(self);
+
+        QObject::connect(fsWatcher, &QFileSystemWatcher::directoryChanged, self, [this](const QString& path) {
+            if(QFileInfo::exists(path) && !addWatches(path)) {
+                startPolling();
+                return;
+            }
+            queueDir(path);
+        });
+
+        return true;
+    }
+
+    bool addWatches(const QString& path)
+    {
+        QStringList dirs{path};
+
+        for(qsizetype i{0}; i < dirs.size(); ++i) {
+            dirs.append(subdirectories(dirs.at(i)));
+        }
+
+        const QStringList watched = fsWatcher->directories();
+        dirs.removeIf([&watched](const QString& dir) { return watched.contains(dir); });
+
+        return dirs.isEmpty() || fsWatcher->addPaths(dirs).isEmpty();
+    }
+#endif
+};
+
 LibraryWatcher::LibraryWatcher(QObject* parent)
-    : QFileSystemWatcher{parent}
-    , m_timer{new QTimer(this)}
+    : QObject{parent}
+    , p{std::make_unique<Private>(this)}
+{ }
+
+LibraryWatcher::~LibraryWatcher() = default;
+
+void LibraryWatcher::watchLibrary(const QString& path)
 {
-    m_timer->setSingleShot(true);
-    m_timer->setInterval(Interval);
-
-    QObject::connect(this, &QFileSystemWatcher::directoryChanged, this, [this](const QString& path) {
-        if(!m_dir.isEmpty() && path != m_dir) {
-            m_timer->stop();
-            emit libraryDirChanged(m_dir);
-        }
-        m_dir = path;
-        m_timer->start();
-    });
-
-    QObject::connect(m_timer, &QTimer::timeout, this, [this]() {
-        emit libraryDirChanged(m_dir);
-        m_dir.clear();
-    });
+    p->root = QDir{path}.absolutePath();
+
+#ifdef Q_OS_LINUX
+    if(!p->initInotify() || !p->addWatches(p->root)) {
+        p->startPolling();
+    }
+#else
+    if(!p->initFsWatcher() || !p->addWatches(p->root)) {
+        p->startPolling();
+    }
+#endif
 }
 } // namespace Fooyin
 
@@ -19,23 +19,39 @@
 
 #pragma once
 
-#include <QFileSystemWatcher>
-
-class QTimer;
+#include <QObject>
 
 namespace Fooyin {
-class LibraryWatcher : public QFileSystemWatcher
+/*!
+ * Watches a library directory tree for changes.
+ * On Linux, inotify is used directly so individual file events can be reported.
+ * Elsewhere, QFileSystemWatcher reports changed directories. If the system runs out
+ * of watches, the tree is polled for directory modification times instead.
+ *
+ * Events are coalesced, so a file written several times is only reported once.
+ */
+class LibraryWatcher : public QObject
 {
     Q_OBJECT
 
 public:
     explicit LibraryWatcher(QObject* parent = nullptr);
+    ~LibraryWatcher() override;
+
+    /** Watches @p path and all of its subdirectories. */
+    void watchLibrary(const QString& path);
 
 signals:
+    /** Emitted when the contents of @p path (and its subdirectories) need to be rescanned. */
     void libraryDirChanged(const QString& path);
+    /*!
+     * Emitted with the files which have been added or modified, and the files
+     * or directories which have been removed.
+     */
+    void filesChanged(const QStringList& changedFiles, const QStringList& removedPaths);
 
 private:
-    QTimer* m_timer;
-    QString m_dir;
+    struct Private;
+    std::unique_ptr<Private> p;
 };
 } // namespace Fooyin
@@ -0,0 +1,120 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "trackavailability.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+// Number of changed tracks reported at once
+constexpr size_t BatchSize = 1000;
+
+namespace {
+struct Directory
+{
+    QString path;
+    std::vector<size_t> tracks;
+};
+
+std::vector<Directory> groupByDirectory(const Fooyin::TrackList& tracks)
+{
+    std::vector<Directory> dirs;
+    std::unordered_map<QString, size_t> dirIndexes;
+
+    for(size_t i{0}; i < tracks.size(); ++i) {
+        const QString& filepath = tracks.at(i).filepath();
+        const QString dir       = filepath.left(filepath.lastIndexOf(u'/') + 1);
+
+        auto [it, inserted] = dirIndexes.try_emplace(dir, dirs.size());
+        if(inserted) {
+            dirs.push_back({dir, {}});
+        }
+        dirs.at(it->second).tracks.push_back(i);
+    }
+
+    return dirs;
+}
+} // namespace
+
+namespace Fooyin::TrackAvailability {
+void checkTracks(QPromise<TrackList>& promise, const TrackList& tracks)
+{
+    const std::vector<Directory> dirs = groupByDirectory(tracks);
+    if(dirs.empty()) {
+        return;
+    }
+
+    std::atomic<size_t> nextDir{0};
+
+    auto checkDirs = [&promise, &tracks, &dirs, &nextDir]() {
+        TrackList changedTracks;
+
+        for(size_t i = nextDir++; i < dirs.size() && !promise.isCanceled(); i = nextDir++) {
+            const Directory& dir = dirs.at(i);
+
+            // Broken symlinks are only listed with QDir::System, so leaving it out treats them as missing
+            const QStringList entries
+                = QDir{dir.path}.entryList(QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDir::Unsorted);
+            const QSet<QString> files{entries.cbegin(), entries.cend()};
+
+            for(const size_t index : dir.tracks) {
+                const Track& track = tracks.at(index);
+                // Listed names are compared exactly, so check anything not found directly in case
+                // the filesystem is case-insensitive and the stored path differs in case
+                const bool exists = files.contains(track.filepath().sliced(dir.path.size()))
+                                 || QFileInfo::exists(track.filepath());
+
+                if(exists != track.isEnabled()) {
+                    Track changedTrack{track};
+                    changedTrack.setIsEnabled(exists);
+                    changedTracks.push_back(changedTrack);
+                }
+            }
+
+            if(changedTracks.size() >= BatchSize) {
+                promise.addResult(std::exchange(changedTracks, {}));
+            }
+        }
+
+        if(!changedTracks.empty()) {
+            promise.addResult(changedTracks);
+        }
+    };
+
+    const auto threadCount = std::min(dirs.size(), static_cast<size_t>(std::max(1, QThread::idealThreadCount())));
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for(size_t i{1}; i < threadCount; ++i) {
+        threads.emplace_back(checkDirs);
+    }
+
+    checkDirs();
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+}
+} // namespace Fooyin::TrackAvailability
@@ -0,0 +1,38 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+
+#include <QPromise>
+
+namespace Fooyin::TrackAvailability {
+/*!
+ * Checks whether the files of @p tracks still exist, listing each directory once
+ * rather than checking every file, with directories checked in parallel.
+ * Only files not found in the listing are checked individually.
+ * Tracks whose enabled state no longer matches are reported to @p promise, with
+ * the state corrected, in batches as they're found.
+ * Stops early if @p promise is cancelled.
+ */
+FYCORE_EXPORT void checkTracks(QPromise<TrackList>& promise, const TrackList& tracks);
+} // namespace Fooyin::TrackAvailability
@@ -20,11 +20,14 @@
 #include "trackdatabasemanager.h"
 
 #include "database/trackdatabase.h"
+#include "librarysnapshot.h"
 #include "tagging/tagwriter.h"
 
 #include <core/track.h>
 #include <utils/database/dbconnectionhandler.h>
 
+#include <utility>
+
 namespace Fooyin {
 TrackDatabaseManager::TrackDatabaseManager(DbConnectionPoolPtr dbPool, QObject* parent)
     : Worker{parent}
@@ -41,8 +44,20 @@ void TrackDatabaseManager::initialiseThread()
 
 void TrackDatabaseManager::getAllTracks()
 {
+    auto snapshot = LibrarySnapshot::read(LibrarySnapshot::defaultPath());
+
+    // Read before the tracks, so a change made in between can only make the tracks look older
+    const uint64_t revision = m_trackDatabase.revision();
+
+    // The database is the source of truth, so only use a snapshot taken since its last change
+    if(snapshot && snapshot->revision == revision
+       && std::cmp_equal(snapshot->tracks.size(), m_trackDatabase.trackCount())) {
+        emit gotSnapshot(snapshot->tracks, snapshot->sortScript, revision);
+        return;
+    }
+
     const TrackList tracks = m_trackDatabase.getAllTracks();
-    emit gotTracks(tracks);
+    emit gotTracks(tracks, revision);
 }
 
 void TrackDatabaseManager::updateTracks(const TrackList& tracks)
@@ -56,18 +71,20 @@ void TrackDatabaseManager::updateTracks(const TrackList& tracks)
     }
 
     if(!tracksUpdated.empty()) {
-        emit updatedTracks(tracksUpdated);
+        emit updatedTracks(tracksUpdated, m_trackDatabase.revision());
     }
 }
 
 void TrackDatabaseManager::updateTrackStats(const TrackList& tracks)
 {
     m_trackDatabase.updateTrackStats(tracks);
+    emit revisionChanged(m_trackDatabase.revision());
 }
 
 void TrackDatabaseManager::cleanupTracks()
 {
     m_trackDatabase.cleanupTracks();
+    emit revisionChanged(m_trackDatabase.revision());
 }
 } // namespace Fooyin
 
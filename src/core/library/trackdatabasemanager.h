@@ -37,8 +37,16 @@ public:
     void initialiseThread() override;
 
 signals:
-    void gotTracks(const TrackList& tracks);
-    void updatedTracks(const TrackList& tracks);
+    /*!
+     * Each signal carries the TrackDatabase::revision its tracks match, so the library
+     * knows which revision it holds once every signal has been applied.
+     */
+    void gotTracks(const TrackList& tracks, uint64_t revision);
+    /** Emitted instead of gotTracks when a snapshot matching the database was loaded. */
+    void gotSnapshot(const TrackList& tracks, const QString& sortScript, uint64_t revision);
+    void updatedTracks(const TrackList& tracks, uint64_t revision);
+    /** Emitted after changes which don't need to be applied to the library's tracks. */
+    void revisionChanged(uint64_t revision);
 
 public slots:
     void getAllTracks();
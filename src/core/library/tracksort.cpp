@@ -22,17 +22,110 @@
 #include <core/scripting/scriptparser.h>
 #include <core/track.h>
 
+#include <QCollator>
+#include <QThread>
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
 #include <ranges>
+#include <thread>
 
-#include <QCollator>
+// Below these, the cost of starting threads outweighs working in parallel
+constexpr size_t ParallelThreshold     = 20000;
+constexpr size_t ParallelEvalThreshold = 2000;
 
 namespace {
 Fooyin::ParsedScript parseScript(const QString& sort)
 {
-    static Fooyin::ScriptParser parser;
+    // Sorts can run on several threads at once, and parsing isn't thread-safe
+    Fooyin::ScriptParser parser;
 
     return parser.parse(sort);
 }
+
+// Runs func(begin, end) over @p count items split into @p chunks ranges, one thread per range
+template <typename Func>
+void forEachChunk(size_t count, size_t chunks, Func&& func)
+{
+    if(chunks <= 1) {
+        func(0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunks);
+
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    for(size_t begin{0}; begin < count; begin += chunkSize) {
+        threads.emplace_back(func, begin, std::min(begin + chunkSize, count));
+    }
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::vector<QCollatorSortKey> sortKeys(const Fooyin::TrackList& tracks, size_t chunks)
+{
+    std::vector<std::optional<QCollatorSortKey>> keys(tracks.size());
+
+    forEachChunk(tracks.size(), chunks, [&tracks, &keys](size_t begin, size_t end) {
+        // QCollator isn't thread-safe, so each thread needs its own
+        QCollator collator;
+        collator.setNumericMode(true);
+
+        for(size_t i{begin}; i < end; ++i) {
+            keys[i].emplace(collator.sortKey(tracks[i].sort()));
+        }
+    });
+
+    std::vector<QCollatorSortKey> sortKeys;
+    sortKeys.reserve(keys.size());
+    for(auto& key : keys) {
+        sortKeys.push_back(std::move(key.value()));
+    }
+    return sortKeys;
+}
+
+/*!
+ * Stable sorts @p indexes by sorting a chunk per thread, then merging neighbouring chunks
+ * in parallel until a single run remains.
+ */
+template <typename Compare>
+void parallelStableSort(std::vector<int>& indexes, size_t chunks, Compare compare)
+{
+    const size_t count = indexes.size();
+    if(chunks <= 1) {
+        std::ranges::stable_sort(indexes, compare);
+        return;
+    }
+
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+
+    forEachChunk(count, chunks, [&indexes, &compare](size_t begin, size_t end) {
+        std::stable_sort(indexes.begin() + static_cast<std::ptrdiff_t>(begin),
+                         indexes.begin() + static_cast<std::ptrdiff_t>(end), compare);
+    });
+
+    for(size_t runSize{chunkSize}; runSize < count; runSize *= 2) {
+        const size_t merges = (count + (2 * runSize) - 1) / (2 * runSize);
+
+        forEachChunk(merges, merges, [&indexes, &compare, runSize, count](size_t begin, size_t end) {
+            for(size_t merge{begin}; merge < end; ++merge) {
+                const size_t first = merge * 2 * runSize;
+                const size_t mid   = std::min(first + runSize, count);
+                const size_t last  = std::min(first + (2 * runSize), count);
+
+                if(mid < last) {
+                    std::inplace_merge(indexes.begin() + static_cast<std::ptrdiff_t>(first),
+                                       indexes.begin() + static_cast<std::ptrdiff_t>(mid),
+                                       indexes.begin() + static_cast<std::ptrdiff_t>(last), compare);
+                }
+            }
+        });
+    }
+}
 } // namespace
 
 namespace Fooyin::Sorting {
@@ -43,33 +136,43 @@ TrackList calcSortFields(const QString& sort, const TrackList& tracks)
 
 TrackList calcSortFields(const ParsedScript& sortScript, const TrackList& tracks)
 {
-    static ScriptParser parser;
+    const ScriptParser parser;
 
     TrackList calcTracks{tracks};
-    for(Track& track : calcTracks) {
-        track.setSort(parser.evaluate(sortScript, track));
-    }
+
+    const size_t threadCount
+        = calcTracks.size() < ParallelEvalThreshold ? 1 : static_cast<size_t>(std::max(1, QThread::idealThreadCount()));
+
+    forEachChunk(calcTracks.size(), threadCount, [&parser, &sortScript, &calcTracks](size_t begin, size_t end) {
+        for(size_t i{begin}; i < end; ++i) {
+            calcTracks[i].setSort(parser.evaluate(sortScript, calcTracks[i]));
+        }
+    });
+
     return calcTracks;
 }
 
 TrackList sortTracks(const TrackList& tracks, Qt::SortOrder order)
 {
-    TrackList sortedTracks{tracks};
+    const size_t threadCount
+        = tracks.size() < ParallelThreshold ? 1 : static_cast<size_t>(std::max(1, QThread::idealThreadCount()));
 
-    QCollator collator;
-    collator.setNumericMode(true);
+    // Collating each sort string once is far cheaper than collating both strings in every comparison
+    const std::vector<QCollatorSortKey> keys = sortKeys(tracks, threadCount);
 
-    std::ranges::sort(sortedTracks, [order, collator](const Track& lhs, const Track& rhs) {
-        const auto cmp = collator.compare(lhs.sort(), rhs.sort());
+    std::vector<int> indexes(tracks.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
 
-        if(cmp == 0) {
-            return false;
-        }
-        if(order == Qt::AscendingOrder) {
-            return cmp < 0;
-        }
-        return cmp > 0;
+    parallelStableSort(indexes, threadCount, [order, &keys](int lhs, int rhs) {
+        const auto cmp = keys[lhs].compare(keys[rhs]);
+        return order == Qt::AscendingOrder ? cmp < 0 : cmp > 0;
     });
+
+    TrackList sortedTracks;
+    sortedTracks.reserve(tracks.size());
+    for(const int index : indexes) {
+        sortedTracks.push_back(tracks[index]);
+    }
     return sortedTracks;
 }
 
@@ -0,0 +1,218 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "trackstore.h"
+
+#include <algorithm>
+#include <set>
+
+// Pruning scans the whole pool, so wait until a fraction of the library has been replaced or removed
+constexpr size_t MinPruneReleases  = 1000;
+constexpr size_t PruneReleaseRatio = 4;
+
+namespace Fooyin {
+bool TrackStore::empty() const
+{
+    return m_tracks.empty();
+}
+
+size_t TrackStore::size() const
+{
+    return m_tracks.size();
+}
+
+const TrackList& TrackStore::tracks() const
+{
+    return m_tracks;
+}
+
+bool TrackStore::contains(int id) const
+{
+    return m_idIndex.contains(id);
+}
+
+Track TrackStore::trackForId(int id) const
+{
+    const auto indexIt = m_idIndex.find(id);
+    if(indexIt == m_idIndex.cend()) {
+        return {};
+    }
+    return m_tracks.at(indexIt->second);
+}
+
+TrackList TrackStore::tracksForIds(const TrackIds& ids) const
+{
+    TrackList tracks;
+    tracks.reserve(ids.size());
+
+    for(const int id : ids) {
+        const auto indexIt = m_idIndex.find(id);
+        if(indexIt != m_idIndex.cend()) {
+            tracks.push_back(m_tracks.at(indexIt->second));
+        }
+    }
+
+    return tracks;
+}
+
+TrackList TrackStore::tracksForHash(const QString& hash) const
+{
+    const auto hashIt = m_hashIndex.find(hash);
+    if(hashIt == m_hashIndex.cend()) {
+        return {};
+    }
+    return tracksForIds(hashIt->second);
+}
+
+Track TrackStore::trackForFilepath(const QString& filepath) const
+{
+    const auto pathIt = m_pathIndex.find(filepath);
+    if(pathIt == m_pathIndex.cend()) {
+        return {};
+    }
+    return m_tracks.at(pathIt->second);
+}
+
+void TrackStore::setTracks(const TrackList& tracks)
+{
+    m_tracks = tracks;
+    m_strings.prune();
+    m_releasedTracks = 0;
+
+    for(Track& track : m_tracks) {
+        track.shareStrings(m_strings);
+    }
+
+    rebuildIndexes();
+}
+
+TrackList TrackStore::addTracks(const TrackList& tracks)
+{
+    m_tracks.reserve(m_tracks.size() + tracks.size());
+
+    for(const Track& track : tracks) {
+        Track& addedTrack = m_tracks.emplace_back(track);
+        addedTrack.shareStrings(m_strings);
+        indexTrack(addedTrack, m_tracks.size() - 1);
+    }
+
+    return TrackList(m_tracks.cend() - static_cast<std::ptrdiff_t>(tracks.size()), m_tracks.cend());
+}
+
+TrackList TrackStore::updateTracks(const TrackList& tracks)
+{
+    TrackList updatedTracks;
+
+    for(const Track& track : tracks) {
+        const auto indexIt = m_idIndex.find(track.id());
+        if(indexIt == m_idIndex.cend()) {
+            continue;
+        }
+
+        const size_t index = indexIt->second;
+        Track& oldTrack    = m_tracks.at(index);
+
+        unindexTrack(oldTrack);
+        oldTrack = track;
+        oldTrack.shareStrings(m_strings);
+        indexTrack(oldTrack, index);
+
+        updatedTracks.push_back(oldTrack);
+    }
+
+    releaseStrings(updatedTracks.size());
+
+    return updatedTracks;
+}
+
+void TrackStore::removeTracks(const TrackIds& ids)
+{
+    const std::set<int> idsToRemove{ids.cbegin(), ids.cend()};
+
+    const auto removed
+        = std::erase_if(m_tracks, [&idsToRemove](const Track& track) { return idsToRemove.contains(track.id()); });
+
+    if(removed > 0) {
+        rebuildIndexes();
+        releaseStrings(removed);
+    }
+}
+
+void TrackStore::clear()
+{
+    m_tracks.clear();
+    m_idIndex.clear();
+    m_hashIndex.clear();
+    m_pathIndex.clear();
+    m_strings.clear();
+    m_releasedTracks = 0;
+}
+
+void TrackStore::indexTrack(const Track& track, size_t index)
+{
+    m_pathIndex[track.filepath()] = index;
+
+    if(track.id() >= 0) {
+        m_idIndex[track.id()] = index;
+        m_hashIndex[track.hash()].push_back(track.id());
+    }
+}
+
+void TrackStore::unindexTrack(const Track& track)
+{
+    m_pathIndex.erase(track.filepath());
+
+    if(track.id() >= 0) {
+        m_idIndex.erase(track.id());
+
+        const auto hashIt = m_hashIndex.find(track.hash());
+        if(hashIt != m_hashIndex.end()) {
+            std::erase(hashIt->second, track.id());
+            if(hashIt->second.empty()) {
+                m_hashIndex.erase(hashIt);
+            }
+        }
+    }
+}
+
+void TrackStore::rebuildIndexes()
+{
+    m_idIndex.clear();
+    m_hashIndex.clear();
+    m_pathIndex.clear();
+
+    m_idIndex.reserve(m_tracks.size());
+    m_pathIndex.reserve(m_tracks.size());
+
+    for(size_t i{0}; i < m_tracks.size(); ++i) {
+        indexTrack(m_tracks.at(i), i);
+    }
+}
+
+void TrackStore::releaseStrings(size_t count)
+{
+    m_releasedTracks += count;
+
+    if(m_releasedTracks >= std::max(MinPruneReleases, m_tracks.size() / PruneReleaseRatio)) {
+        // Drop any values only the replaced or removed tracks used
+        m_strings.prune();
+        m_releasedTracks = 0;
+    }
+}
+} // namespace Fooyin
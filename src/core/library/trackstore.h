@@ -0,0 +1,88 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "fycore_export.h"
+
+#include <core/track.h>
+#include <utils/stringpool.h>
+
+#include <unordered_map>
+
+namespace Fooyin {
+/*!
+ * Holds the library's tracks in sort order, along with indexes for
+ * constant time lookup by id, hash and filepath.
+ * Tracks which aren't in the database (id < 0) are stored but not indexed by id.
+ *
+ * Strings repeated across tracks (artists, album, genres etc.) are interned on insertion,
+ * so large libraries only store each distinct value once. Values no longer used by any track
+ * are released once enough tracks have been updated or removed to make scanning the pool worthwhile.
+ */
+class FYCORE_EXPORT TrackStore
+{
+public:
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] const TrackList& tracks() const;
+
+    [[nodiscard]] bool contains(int id) const;
+    /** Returns the track with @p id, or an invalid track if not found. */
+    [[nodiscard]] Track trackForId(int id) const;
+    /** Returns the tracks found with an id from @p ids, in the same order as @p ids. */
+    [[nodiscard]] TrackList tracksForIds(const TrackIds& ids) const;
+    /** Returns all tracks with @p hash. */
+    [[nodiscard]] TrackList tracksForHash(const QString& hash) const;
+    /** Returns the track at @p filepath, or an invalid track if not found. */
+    [[nodiscard]] Track trackForFilepath(const QString& filepath) const;
+
+    /** Replaces all tracks, keeping the order of @p tracks. */
+    void setTracks(const TrackList& tracks);
+    /*!
+     * Appends @p tracks to the end of the store.
+     * @returns the tracks as stored, sharing their strings with the rest of the library.
+     */
+    TrackList addTracks(const TrackList& tracks);
+    /*!
+     * Replaces the tracks with the same id as those in @p tracks, keeping their position.
+     * @returns the tracks which were found and updated.
+     */
+    TrackList updateTracks(const TrackList& tracks);
+    /** Removes the tracks with an id from @p ids. */
+    void removeTracks(const TrackIds& ids);
+
+    void clear();
+
+private:
+    void indexTrack(const Track& track, size_t index);
+    void unindexTrack(const Track& track);
+    void rebuildIndexes();
+    void releaseStrings(size_t count);
+
+    TrackList m_tracks;
+    std::unordered_map<int, size_t> m_idIndex;
+    std::unordered_map<QString, TrackIds> m_hashIndex;
+    std::unordered_map<QString, size_t> m_pathIndex;
+    StringPool m_strings;
+    // Tracks replaced or removed since the pool was last pruned
+    size_t m_releasedTracks{0};
+};
+} // namespace Fooyin
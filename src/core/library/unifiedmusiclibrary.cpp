@@ -19,20 +19,31 @@
 
 #include "unifiedmusiclibrary.h"
 
+#include "database/trackdatabase.h"
 #include "internalcoresettings.h"
 #include "library/libraryinfo.h"
 #include "library/librarymanager.h"
+#include "librarysnapshot.h"
 #include "librarythreadhandler.h"
+#include "trackavailability.h"
+#include "trackstore.h"
 
 #include <core/coresettings.h>
 #include <core/library/tracksort.h>
 #include <utils/async.h>
 #include <utils/settings/settingsmanager.h>
 
+#include <QFutureWatcher>
+#include <QTimer>
+
+#include <algorithm>
+#include <optional>
 #include <ranges>
 
 using namespace std::chrono_literals;
 
+constexpr auto SnapshotDelay = 5s;
+
 namespace {
 QFuture<Fooyin::TrackList> recalSortTracks(const QString& sort, const Fooyin::TrackList& tracks)
 {
@@ -55,10 +66,22 @@ struct UnifiedMusicLibrary::Private
     SettingsManager* settings;
 
     LibraryThreadHandler threadHandler;
+    TrackDatabase trackDatabase;
 
-    TrackList tracks;
+    TrackStore tracks;
     std::unordered_map<QString, Track> pendingStatUpdates;
 
+    QString snapshotPath{LibrarySnapshot::defaultPath()};
+    QTimer snapshotTimer;
+    QFuture<bool> snapshotWrite;
+    int snapshotGeneration{0};
+
+    // The TrackDatabase::revision the tracks match once no updates are pending.
+    // Unset after a change with an unknown revision, until tracks are next loaded.
+    std::optional<uint64_t> revision;
+    // Updates still being sorted before they're applied to the tracks
+    int pendingUpdates{0};
+
     Private(UnifiedMusicLibrary* self_, LibraryManager* libraryManager_, DbConnectionPoolPtr dbPool_,
             SettingsManager* settings_)
         : self{self_}
@@ -66,7 +89,76 @@ struct UnifiedMusicLibrary::Private
         , dbPool{std::move(dbPool_)}
         , settings{settings_}
         , threadHandler{dbPool, self, settings}
-    { }
+    {
+        trackDatabase.initialise(DbConnectionProvider{dbPool});
+
+        snapshotTimer.setSingleShot(true);
+        snapshotTimer.setInterval(SnapshotDelay);
+        QObject::connect(&snapshotTimer, &QTimer::timeout, self, [this]() { writeSnapshot(); });
+    }
+
+    /*!
+     * Removes the snapshot as soon as the library changes, so a stale one is never loaded,
+     * and writes a new one once changes have settled.
+     */
+    void invalidateSnapshot()
+    {
+        ++snapshotGeneration;
+        LibrarySnapshot::remove(snapshotPath);
+        snapshotTimer.start();
+    }
+
+    /*!
+     * Records the revision of a result from the library thread as it's received.
+     * Results arrive in the order they were stored, so once every pending update has been
+     * applied, the tracks match the revision of the last one.
+     */
+    void resultReceived(uint64_t resultRevision)
+    {
+        if(revision) {
+            revision = std::max(revision.value(), resultRevision);
+        }
+    }
+
+    void writeSnapshot()
+    {
+        if(snapshotWrite.isRunning() || pendingUpdates > 0) {
+            // Only one write to the same file at a time, and only once the tracks match a revision
+            snapshotTimer.start();
+            return;
+        }
+
+        if(!revision) {
+            return;
+        }
+
+        const int generation = snapshotGeneration;
+
+        snapshotWrite = Utils::asyncExec([path = snapshotPath, libraryTracks = tracks.tracks(),
+                                          sort     = settings->value<Settings::Core::LibrarySortScript>(),
+                                          revision = revision.value()]() {
+            return LibrarySnapshot::write(path, libraryTracks, sort, revision);
+        });
+        snapshotWrite.then(self, [this, generation](bool written) {
+            if(written && generation != snapshotGeneration) {
+                // Changed while writing
+                invalidateSnapshot();
+            }
+        });
+    }
+
+    void loadSnapshot(const TrackList& snapshotTracks, const QString& sort, uint64_t snapshotRevision)
+    {
+        revision = snapshotRevision;
+
+        if(sort != settings->value<Settings::Core::LibrarySortScript>()) {
+            loadTracks(snapshotTracks);
+            return;
+        }
+
+        tracks.setTracks(snapshotTracks);
+        emit self->tracksLoaded(tracks.tracks());
+    }
 
     void loadTracks(const TrackList& trackToLoad)
     {
@@ -75,52 +167,103 @@ struct UnifiedMusicLibrary::Private
             return;
         }
 
+        ++pendingUpdates;
+
         recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), trackToLoad)
             .then(self, [this](const TrackList& sortedTracks) {
-                tracks = sortedTracks;
-                emit self->tracksLoaded(tracks);
+                tracks.setTracks(sortedTracks);
+                --pendingUpdates;
+                invalidateSnapshot();
+                emit self->tracksLoaded(tracks.tracks());
             });
     }
 
     QFuture<void> addTracks(const TrackList& newTracks)
     {
+        ++pendingUpdates;
+
         return recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), newTracks)
             .then(self, [this](const TrackList& sortedTracks) {
-                std::ranges::copy(sortedTracks, std::back_inserter(tracks));
-                resortTracks(tracks).then(self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-                    tracks = sortedLibraryTracks;
-                    emit self->tracksAdded(sortedTracks);
+                const TrackList addedTracks = tracks.addTracks(sortedTracks);
+                resortTracks(tracks.tracks()).then(self, [this, addedTracks](const TrackList& sortedLibraryTracks) {
+                    tracks.setTracks(sortedLibraryTracks);
+                    --pendingUpdates;
+                    invalidateSnapshot();
+                    emit self->tracksAdded(addedTracks);
                 });
             });
     }
 
     QFuture<void> updateTracks(const TrackList& tracksToUpdate)
     {
+        ++pendingUpdates;
+
         return recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksToUpdate)
-            .then(self, [this](const TrackList& sortedTracks) {
-                for(const auto& track : sortedTracks) {
-                    auto trackIt = std::ranges::find_if(
-                        tracks, [&track](const Track& oldTrack) { return oldTrack.id() == track.id(); });
-                    if(trackIt != tracks.end()) {
-                        *trackIt = track;
-                        trackIt->clearWasModified();
-                    }
+            .then(self, [this](TrackList sortedTracks) {
+                for(auto& track : sortedTracks) {
+                    track.clearWasModified();
                 }
+                tracks.updateTracks(sortedTracks);
 
-                resortTracks(tracks).then(self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
-                    tracks = sortedLibraryTracks;
+                resortTracks(tracks.tracks()).then(self, [this, sortedTracks](const TrackList& sortedLibraryTracks) {
+                    tracks.setTracks(sortedLibraryTracks);
+                    --pendingUpdates;
+                    invalidateSnapshot();
                     emit self->tracksUpdated(sortedTracks);
                 });
             });
     }
 
+    /*!
+     * Tracks are loaded without checking their files exist, so check them in the background
+     * and update any which were added or removed since last run.
+     */
+    void checkAvailability()
+    {
+        auto* watcher = new QFutureWatcher<TrackList>(self);
+        QObject::connect(watcher, &QFutureWatcher<TrackList>::resultReadyAt, self,
+                         [this, watcher](int index) { updateAvailability(watcher->resultAt(index)); });
+        QObject::connect(watcher, &QFutureWatcher<TrackList>::finished, watcher, &QObject::deleteLater);
+
+        watcher->setFuture(Utils::asyncExec([libraryTracks = tracks.tracks()](QPromise<TrackList>& promise) {
+            TrackAvailability::checkTracks(promise, libraryTracks);
+        }));
+    }
+
+    void updateAvailability(const TrackList& checkedTracks)
+    {
+        TrackList updatedTracks;
+
+        // Only take the enabled state, as the tracks may have changed since being checked
+        for(const Track& checkedTrack : checkedTracks) {
+            Track track = tracks.trackForId(checkedTrack.id());
+            if(track.isValid() && track.isEnabled() != checkedTrack.isEnabled()) {
+                track.setIsEnabled(checkedTrack.isEnabled());
+                updatedTracks.push_back(track);
+            }
+        }
+
+        if(updatedTracks.empty()) {
+            return;
+        }
+
+        tracks.updateTracks(updatedTracks);
+        invalidateSnapshot();
+        emit self->tracksUpdated(updatedTracks);
+    }
+
     void handleScanResult(const ScanResult& result)
     {
+        resultReceived(result.revision);
+
         if(!result.addedTracks.empty()) {
+            // Held until the updated tracks are pending too, so the result is never half applied
+            ++pendingUpdates;
             addTracks(result.addedTracks).then(self, [this, result]() {
                 if(!result.updatedTracks.empty()) {
                     updateTracks(result.updatedTracks);
                 }
+                --pendingUpdates;
             });
         }
         else if(!result.updatedTracks.empty()) {
@@ -128,13 +271,17 @@ struct UnifiedMusicLibrary::Private
         }
     }
 
-    void scannedTracks(int id, const TrackList& tracksScanned)
+    void scannedTracks(int id, const TrackList& tracksScanned, uint64_t scanRevision)
     {
+        resultReceived(scanRevision);
+        ++pendingUpdates;
+
         recalSortTracks(settings->value<Settings::Core::LibrarySortScript>(), tracksScanned)
             .then(self, [this, id](const TrackList& scannedTracks) {
                 addTracks(scannedTracks).then(self, [this, id, scannedTracks]() {
                     emit self->tracksScanned(id, scannedTracks);
                 });
+                --pendingUpdates;
             });
     }
 
@@ -144,26 +291,31 @@ struct UnifiedMusicLibrary::Private
             return;
         }
 
-        TrackList newTracks;
+        TrackIds removedIds;
         TrackList removedTracks;
         TrackList updatedTracks;
 
-        for(auto& track : tracks) {
+        for(const auto& track : tracks.tracks()) {
             if(track.libraryId() == id) {
                 if(tracksRemoved.contains(track.id())) {
+                    removedIds.push_back(track.id());
                     removedTracks.push_back(track);
                     continue;
                 }
-                track.setLibraryId(-1);
-                updatedTracks.push_back(track);
-                newTracks.push_back(track);
+                Track updatedTrack{track};
+                updatedTrack.setLibraryId(-1);
+                updatedTracks.push_back(updatedTrack);
             }
-            newTracks.push_back(track);
         }
 
-        tracks = newTracks;
+        tracks.removeTracks(removedIds);
+        tracks.updateTracks(updatedTracks);
+
+        // The library's tracks were removed from the database on this thread, at an unknown revision
+        revision.reset();
 
         threadHandler.libraryRemoved(id);
+        invalidateSnapshot();
 
         emit self->tracksDeleted(removedTracks);
         emit self->tracksUpdated(updatedTracks);
@@ -176,9 +328,13 @@ struct UnifiedMusicLibrary::Private
 
     void changeSort(const QString& sort)
     {
-        recalSortTracks(sort, tracks).then(self, [this](const TrackList& sortedTracks) {
-            tracks = sortedTracks;
-            emit self->tracksSorted(tracks);
+        ++pendingUpdates;
+
+        recalSortTracks(sort, tracks.tracks()).then(self, [this](const TrackList& sortedTracks) {
+            tracks.setTracks(sortedTracks);
+            --pendingUpdates;
+            invalidateSnapshot();
+            emit self->tracksSorted(tracks.tracks());
         });
     }
 };
@@ -199,11 +355,23 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
     connect(&p->threadHandler, &LibraryThreadHandler::scanUpdate, this,
             [this](const ScanResult& result) { p->handleScanResult(result); });
     connect(&p->threadHandler, &LibraryThreadHandler::scannedTracks, this,
-            [this](int id, const TrackList& tracks) { p->scannedTracks(id, tracks); });
+            [this](int id, const TrackList& tracks, uint64_t revision) { p->scannedTracks(id, tracks, revision); });
     connect(&p->threadHandler, &LibraryThreadHandler::tracksUpdated, this,
-            [this](const TrackList& tracks) { p->updateTracks(tracks); });
+            [this](const TrackList& tracks, uint64_t revision) {
+                p->resultReceived(revision);
+                p->updateTracks(tracks);
+            });
+    connect(&p->threadHandler, &LibraryThreadHandler::revisionChanged, this,
+            [this](uint64_t revision) { p->resultReceived(revision); });
     connect(&p->threadHandler, &LibraryThreadHandler::gotTracks, this,
-            [this](const TrackList& tracks) { p->loadTracks(tracks); });
+            [this](const TrackList& tracks, uint64_t revision) {
+                p->revision = revision;
+                p->loadTracks(tracks);
+            });
+    connect(&p->threadHandler, &LibraryThreadHandler::gotSnapshot, this,
+            [this](const TrackList& tracks, const QString& sort, uint64_t revision) {
+                p->loadSnapshot(tracks, sort, revision);
+            });
 
     p->settings->subscribe<Settings::Core::LibrarySortScript>(this,
                                                               [this](const QString& sort) { p->changeSort(sort); });
@@ -211,6 +379,7 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
     connect(
         this, &MusicLibrary::tracksLoaded, this,
         [this]() {
+            p->checkAvailability();
             p->threadHandler.setupWatchers(p->libraryManager->allLibraries(),
                                            p->settings->value<Settings::Core::Internal::MonitorLibraries>());
             if(p->settings->value<Settings::Core::AutoRefresh>()) {
@@ -225,12 +394,37 @@ UnifiedMusicLibrary::UnifiedMusicLibrary(LibraryManager* libraryManager, DbConne
 
 UnifiedMusicLibrary::~UnifiedMusicLibrary()
 {
+    bool snapshotOutdated = p->snapshotTimer.isActive();
+
+    // The tracks only match the database if every update has been applied, and no change
+    // stored by the library thread is still waiting to be received
+    const uint64_t databaseRevision = p->trackDatabase.revision();
+    bool snapshotValid = p->pendingUpdates == 0 && p->revision == databaseRevision;
+
     if(!p->pendingStatUpdates.empty()) {
         TrackList tracksToUpdate;
         for(const Track& track : p->pendingStatUpdates | std::views::values) {
             tracksToUpdate.emplace_back(track);
         }
-        p->threadHandler.saveUpdatedTrackStats(tracksToUpdate);
+        // Saved here rather than on the library thread, so the snapshot below is taken after them
+        p->trackDatabase.updateTrackStats(tracksToUpdate);
+        snapshotOutdated = true;
+
+        // Anything other than our own single increase means another change was stored meanwhile
+        const uint64_t statsRevision = p->trackDatabase.revision();
+        snapshotValid                = snapshotValid && statsRevision == databaseRevision + 1;
+        p->revision                  = statsRevision;
+    }
+
+    // Don't write over a snapshot still being written
+    p->snapshotWrite.waitForFinished();
+
+    if(!snapshotValid) {
+        LibrarySnapshot::remove(p->snapshotPath);
+    }
+    else if(snapshotOutdated) {
+        LibrarySnapshot::write(p->snapshotPath, p->tracks.tracks(),
+                               p->settings->value<Settings::Core::LibrarySortScript>(), p->revision.value());
     }
 }
 
@@ -247,9 +441,17 @@ void UnifiedMusicLibrary::rescanAll()
     }
 }
 
+void UnifiedMusicLibrary::rescanAllFull()
+{
+    const LibraryInfoMap& libraries = p->libraryManager->allLibraries();
+    for(const auto& library : libraries | std::views::values) {
+        p->threadHandler.scanLibrary(library, true);
+    }
+}
+
 ScanRequest UnifiedMusicLibrary::rescan(const LibraryInfo& library)
 {
-    return p->threadHandler.scanLibrary(library);
+    return p->threadHandler.scanLibrary(library, false);
 }
 
 ScanRequest UnifiedMusicLibrary::scanTracks(const TrackList& tracks)
@@ -269,19 +471,40 @@ bool UnifiedMusicLibrary::isEmpty() const
 
 TrackList UnifiedMusicLibrary::tracks() const
 {
-    return p->tracks;
+    return p->tracks.tracks();
+}
+
+Track UnifiedMusicLibrary::trackForId(int id) const
+{
+    return p->tracks.trackForId(id);
 }
 
 TrackList UnifiedMusicLibrary::tracksForIds(const TrackIds& ids) const
+{
+    return p->tracks.tracksForIds(ids);
+}
+
+TrackList UnifiedMusicLibrary::tracksForHashes(const QStringList& hashes) const
 {
     TrackList tracks;
-    tracks.reserve(ids.size());
 
-    for(const int id : ids) {
-        auto trackIt
-            = std::ranges::find_if(std::as_const(p->tracks), [id](const Track& track) { return track.id() == id; });
-        if(trackIt != p->tracks.cend()) {
-            tracks.push_back(*trackIt);
+    for(const QString& hash : hashes) {
+        const TrackList hashTracks = p->tracks.tracksForHash(hash);
+        tracks.insert(tracks.end(), hashTracks.cbegin(), hashTracks.cend());
+    }
+
+    return tracks;
+}
+
+TrackList UnifiedMusicLibrary::tracksForFilepaths(const QStringList& filepaths) const
+{
+    TrackList tracks;
+    tracks.reserve(filepaths.size());
+
+    for(const QString& filepath : filepaths) {
+        Track track = p->tracks.trackForFilepath(filepath);
+        if(track.isValid()) {
+            tracks.push_back(track);
         }
     }
 
@@ -321,18 +544,17 @@ void UnifiedMusicLibrary::trackWasPlayed(const Track& track)
     }
 
     TrackList tracksToUpdate;
-    for(const auto& libraryTrack : p->tracks) {
-        if(libraryTrack.hash() == hash) {
-            Track sameHashTrack{libraryTrack};
-            sameHashTrack.setFirstPlayed(currTime);
-            sameHashTrack.setLastPlayed(currTime);
-            sameHashTrack.setPlayCount(playCount > 0 ? playCount : sameHashTrack.playCount() + 1);
-
-            tracksToUpdate.emplace_back(sameHashTrack);
-            if(!isPending) {
-                p->pendingStatUpdates.emplace(hash, sameHashTrack);
-                isPending = true;
-            }
+    const TrackList sameHashTracks = p->tracks.tracksForHash(hash);
+    for(const auto& libraryTrack : sameHashTracks) {
+        Track sameHashTrack{libraryTrack};
+        sameHashTrack.setFirstPlayed(currTime);
+        sameHashTrack.setLastPlayed(currTime);
+        sameHashTrack.setPlayCount(playCount > 0 ? playCount : sameHashTrack.playCount() + 1);
+
+        tracksToUpdate.emplace_back(sameHashTrack);
+        if(!isPending) {
+            p->pendingStatUpdates.emplace(hash, sameHashTrack);
+            isPending = true;
         }
     }
 
@@ -341,6 +563,7 @@ void UnifiedMusicLibrary::trackWasPlayed(const Track& track)
 
 void UnifiedMusicLibrary::cleanupTracks()
 {
+    p->invalidateSnapshot();
     p->threadHandler.cleanupTracks();
 }
 } // namespace Fooyin
@@ -39,6 +39,7 @@ public:
     void loadAllTracks() override;
 
     void rescanAll() override;
+    void rescanAllFull() override;
     ScanRequest rescan(const LibraryInfo& library) override;
     ScanRequest scanTracks(const TrackList& tracks) override;
 
@@ -46,7 +47,10 @@ public:
     [[nodiscard]] bool isEmpty() const override;
 
     [[nodiscard]] TrackList tracks() const override;
+    [[nodiscard]] Track trackForId(int id) const override;
     [[nodiscard]] TrackList tracksForIds(const TrackIds& ids) const override;
+    [[nodiscard]] TrackList tracksForHashes(const QStringList& hashes) const override;
+    [[nodiscard]] TrackList tracksForFilepaths(const QStringList& filepaths) const override;
 
     void updateTrackMetadata(const TrackList& tracks) override;
     void updateTrackStats(const Track& track) override;
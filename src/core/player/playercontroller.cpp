@@ -173,6 +173,13 @@ void PlayerController::updateCurrentTrackIndex(int index)
     }
 }
 
+void PlayerController::preloadNextTrack(const Track& track)
+{
+    if(track.isValid()) {
+        emit nextTrackPreloading(track);
+    }
+}
+
 PlaybackQueue PlayerController::playbackQueue() const
 {
     return p->queue;
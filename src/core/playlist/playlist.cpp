@@ -27,6 +27,7 @@
 #include <random>
 #include <ranges>
 #include <set>
+#include <unordered_map>
 
 namespace Fooyin {
 struct Playlist::PrivateKey
@@ -53,6 +54,12 @@ struct Playlist::Private
     bool modified{false};
     bool tracksModified{false};
 
+    std::optional<std::vector<int>> savedTrackIds;
+
+    // Indexes of each track id, built when first needed and discarded when tracks are added or removed
+    mutable std::unordered_map<int, std::vector<int>> trackIdIndexes;
+    mutable bool trackIdIndexesValid{false};
+
     explicit Private(QString name_)
         : id{Utils::generateUniqueHash()}
         , name{std::move(name_)}
@@ -66,6 +73,28 @@ struct Playlist::Private
         , index{index_}
     { }
 
+    const std::unordered_map<int, std::vector<int>>& indexesById() const
+    {
+        if(!trackIdIndexesValid) {
+            trackIdIndexes.clear();
+            for(int i{0}; const Track& track : tracks) {
+                if(track.isInDatabase()) {
+                    trackIdIndexes[track.id()].push_back(i);
+                }
+                ++i;
+            }
+            trackIdIndexesValid = true;
+        }
+
+        return trackIdIndexes;
+    }
+
+    void invalidateIndexes()
+    {
+        trackIdIndexesValid = false;
+        trackIdIndexes.clear();
+    }
+
     void readTrack(int trackIndex)
     {
         if(trackIndex < 0 || std::cmp_greater_equal(trackIndex, tracks.size())) {
@@ -326,6 +355,7 @@ void Playlist::setTracksModified(bool modified)
 void Playlist::replaceTracks(const TrackList& tracks)
 {
     if(std::exchange(p->tracks, tracks) != tracks) {
+        p->invalidateIndexes();
         p->tracksModified = true;
         p->shuffleOrder.clear();
         p->nextTrackIndex = -1;
@@ -339,6 +369,7 @@ void Playlist::appendTracks(const TrackList& tracks)
     }
 
     std::ranges::copy(tracks, std::back_inserter(p->tracks));
+    p->invalidateIndexes();
     p->tracksModified = true;
     p->shuffleOrder.clear();
 }
@@ -381,17 +412,76 @@ std::vector<int> Playlist::removeTracks(const std::vector<int>& indexes)
         p->nextTrackIndex = -1;
     }
 
+    p->invalidateIndexes();
     p->tracksModified = true;
 
     return removedIndexes;
 }
 
+std::vector<int> Playlist::updateTracks(const TrackList& tracks)
+{
+    std::vector<int> updatedIndexes;
+
+    const auto& indexesById = p->indexesById();
+
+    for(const Track& track : tracks) {
+        if(!track.isInDatabase()) {
+            continue;
+        }
+        if(const auto indexesIt = indexesById.find(track.id()); indexesIt != indexesById.cend()) {
+            for(const int index : indexesIt->second) {
+                p->tracks.at(index) = track;
+                updatedIndexes.push_back(index);
+            }
+        }
+    }
+
+    std::ranges::sort(updatedIndexes);
+    const auto duplicates = std::ranges::unique(updatedIndexes);
+    updatedIndexes.erase(duplicates.begin(), duplicates.end());
+
+    return updatedIndexes;
+}
+
+std::vector<int> Playlist::indexesOfTracks(const TrackList& tracks) const
+{
+    std::vector<int> indexes;
+
+    const auto& indexesById = p->indexesById();
+
+    for(const Track& track : tracks) {
+        if(!track.isInDatabase()) {
+            continue;
+        }
+        if(const auto indexesIt = indexesById.find(track.id()); indexesIt != indexesById.cend()) {
+            indexes.insert(indexes.end(), indexesIt->second.cbegin(), indexesIt->second.cend());
+        }
+    }
+
+    std::ranges::sort(indexes);
+    const auto duplicates = std::ranges::unique(indexes);
+    indexes.erase(duplicates.begin(), duplicates.end());
+
+    return indexes;
+}
+
 void Playlist::clear()
 {
     if(!p->tracks.empty()) {
         p->tracks.clear();
+        p->invalidateIndexes();
         p->tracksModified = true;
         p->shuffleOrder.clear();
     }
 }
+
+const std::optional<std::vector<int>>& Playlist::savedTrackIds() const
+{
+    return p->savedTrackIds;
+}
+
+void Playlist::setSavedTrackIds(std::optional<std::vector<int>> trackIds)
+{
+    p->savedTrackIds = std::move(trackIds);
+}
 } // namespace Fooyin
@@ -33,41 +33,6 @@
 
 constexpr auto ActiveIndex = "Player/ActivePlaylistIndex";
 
-namespace {
-enum class CommonOperation : uint8_t
-{
-    Update = 0,
-    Remove
-};
-
-std::vector<int> updateCommonTracks(Fooyin::TrackList& tracks, const Fooyin::TrackList& updatedTracks,
-                                    CommonOperation operation)
-{
-    std::vector<int> indexes;
-
-    Fooyin::TrackList result;
-    result.reserve(tracks.size());
-
-    for(auto trackIt{tracks.begin()}; trackIt != tracks.end(); ++trackIt) {
-        auto updatedIt = std::ranges::find_if(updatedTracks, [&trackIt](const Fooyin::Track& updatedTrack) {
-            return updatedTrack.isInDatabase() && trackIt->id() == updatedTrack.id();
-        });
-        if(updatedIt != updatedTracks.end()) {
-            indexes.push_back(static_cast<int>(std::distance(tracks.begin(), trackIt)));
-            if(operation == CommonOperation::Update) {
-                result.push_back(*updatedIt);
-            }
-        }
-        else {
-            result.push_back(*trackIt);
-        }
-    }
-
-    tracks = result;
-    return indexes;
-}
-} // namespace
-
 namespace Fooyin {
 struct PlaylistHandler::Private
 {
@@ -689,11 +654,9 @@ void PlaylistHandler::populatePlaylists(const TrackList& tracks)
 void PlaylistHandler::tracksUpdated(const TrackList& tracks)
 {
     for(auto& playlist : p->playlists) {
-        TrackList playlistTracks  = playlist->tracks();
-        const auto updatedIndexes = updateCommonTracks(playlistTracks, tracks, CommonOperation::Update);
+        const auto updatedIndexes = playlist->updateTracks(tracks);
 
         if(!updatedIndexes.empty()) {
-            playlist->replaceTracks(playlistTracks);
             emit playlistTracksChanged(playlist.get(), updatedIndexes);
         }
     }
@@ -702,19 +665,44 @@ void PlaylistHandler::tracksUpdated(const TrackList& tracks)
 void PlaylistHandler::tracksRemoved(const TrackList& tracks)
 {
     for(auto& playlist : p->playlists) {
-        TrackList playlistTracks  = playlist->tracks();
-        const auto updatedIndexes = updateCommonTracks(playlistTracks, tracks, CommonOperation::Remove);
+        const auto removedIndexes = playlist->indexesOfTracks(tracks);
 
-        if(!updatedIndexes.empty()) {
-            playlist->replaceTracks(playlistTracks);
-            emit playlistTracksChanged(playlist.get(), updatedIndexes);
+        if(removedIndexes.empty()) {
+            continue;
+        }
+
+        const TrackList currentTracks = playlist->tracks();
+
+        TrackList playlistTracks;
+        playlistTracks.reserve(currentTracks.size() - removedIndexes.size());
+
+        auto removedIt = removedIndexes.cbegin();
+        for(int i{0}; std::cmp_less(i, currentTracks.size()); ++i) {
+            if(removedIt != removedIndexes.cend() && *removedIt == i) {
+                ++removedIt;
+                continue;
+            }
+            playlistTracks.push_back(currentTracks.at(i));
         }
+
+        playlist->replaceTracks(playlistTracks);
+        emit playlistTracksChanged(playlist.get(), removedIndexes);
     }
 }
 
 void PlaylistHandler::trackAboutToFinish()
 {
-    p->nextTrack(1);
+    // Queued tracks take priority, matching PlayerController::next
+    const PlaybackQueue queue = p->playerController->playbackQueue();
+    if(!queue.empty()) {
+        p->playerController->preloadNextTrack(queue.track(0).track);
+        return;
+    }
+
+    auto* playlist = p->scheduledPlaylist ? p->scheduledPlaylist : p->activePlaylist;
+    if(playlist) {
+        p->playerController->preloadNextTrack(playlist->nextTrack(1, p->playerController->playMode()));
+    }
 }
 } // namespace Fooyin
 
@@ -25,29 +25,174 @@
 
 #include <QDebug>
 
+#include <deque>
+#include <optional>
+#include <utility>
+
 using TokenType = Fooyin::ScriptScanner::TokenType;
 
 namespace {
-QStringList evalStringList(const Fooyin::ScriptResult& evalExpr, const QStringList& result)
+/*!
+ * Concatenates the results of a sequence of expressions.
+ * Values are appended in place to a single string, which only becomes a list once a
+ * multi-value (\037 separated) result is appended, at which point every combination is built.
+ */
+class ResultBuilder
 {
-    QStringList listResult;
-    const QStringList values = evalExpr.value.split(QStringLiteral("\037"));
-    const bool isEmpty       = result.empty();
+public:
+    void append(const QString& value)
+    {
+        const bool isMultiValue = value.contains(u'\037');
 
-    for(const QString& value : values) {
-        if(isEmpty) {
-            listResult.append(value);
+        if(!m_isList && !isMultiValue) {
+            if(m_hasValue) {
+                m_value += value;
+            }
+            else {
+                m_value    = value;
+                m_hasValue = true;
+            }
+            return;
         }
-        else {
-            std::ranges::transform(result, std::back_inserter(listResult),
-                                   [&](const QString& retValue) -> QString { return retValue + value; });
+
+        if(!m_isList) {
+            if(m_hasValue) {
+                m_list.append(std::exchange(m_value, {}));
+            }
+            m_isList = true;
+        }
+
+        if(!isMultiValue) {
+            for(QString& result : m_list) {
+                result += value;
+            }
+            return;
+        }
+
+        const QStringList values = value.split(u'\037');
+
+        if(m_list.empty()) {
+            m_list = values;
+            return;
+        }
+
+        QStringList combined;
+        combined.reserve(values.size() * m_list.size());
+        for(const QString& subValue : values) {
+            for(const QString& result : std::as_const(m_list)) {
+                combined.append(result + subValue);
+            }
         }
+        m_list = std::move(combined);
     }
-    return listResult;
-}
+
+    QString take()
+    {
+        if(!m_isList) {
+            return std::exchange(m_value, {});
+        }
+        if(m_list.size() == 1) {
+            // Calling join on a QStringList with a single empty string will return a null QString
+            return m_list.constFirst();
+        }
+        return m_list.join(u'\037');
+    }
+
+private:
+    QString m_value;
+    QStringList m_list;
+    bool m_hasValue{false};
+    bool m_isList{false};
+};
+
+/*!
+ * Argument lists for function calls, kept per thread so their storage is reused between calls.
+ * Each level of nesting has its own list; a deque keeps the outer lists in place as it grows.
+ */
+class ArgumentStack
+{
+public:
+    Fooyin::ScriptValueList& push()
+    {
+        if(m_depth == m_levels.size()) {
+            m_levels.emplace_back();
+        }
+        return m_levels[m_depth++];
+    }
+
+    void pop()
+    {
+        // Keeps the capacity, but releases the values
+        m_levels[--m_depth].clear();
+    }
+
+private:
+    std::deque<Fooyin::ScriptValueList> m_levels;
+    size_t m_depth{0};
+};
+
+thread_local ArgumentStack argumentStack;
 } // namespace
 
 namespace Fooyin {
+/*!
+ * An expression with its variable or function resolved when parsed,
+ * so evaluation doesn't need to look anything up by name.
+ */
+struct CompiledExpr
+{
+    Expr::Type type{Expr::Null};
+    // The literal, or the variable or function name
+    QString value;
+    ScriptRegistry::ResolvedVariable variable;
+    const ScriptFunction* function{nullptr};
+    std::vector<CompiledExpr> args;
+    // Set if the expression doesn't depend on the track, so was evaluated when compiled
+    std::optional<ScriptResult> constant;
+    // Only depends on the track, so can be shared between scripts through a ScriptCache
+    bool pure{false};
+    // Identifies the expression's structure across scripts, if pure
+    QString key;
+    size_t keyHash{0};
+};
+
+struct CompiledScript
+{
+    std::vector<CompiledExpr> expressions;
+};
+
+struct ScriptCache::Private
+{
+    struct Key
+    {
+        size_t hash;
+        QString key;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            return key.hash;
+        }
+    };
+
+    std::unordered_map<Key, ScriptResult, KeyHash> results;
+};
+
+ScriptCache::ScriptCache()
+    : p{std::make_unique<Private>()}
+{ }
+
+ScriptCache::~ScriptCache() = default;
+
+void ScriptCache::clear()
+{
+    p->results.clear();
+}
+
 struct ScriptParser::Private
 {
     ScriptParser* self;
@@ -61,7 +206,6 @@ struct ScriptParser::Private
 
     QString currentInput;
     std::unordered_map<QString, ParsedScript> parsedScripts;
-    QStringList currentResult;
 
     explicit Private(ScriptParser* self_)
         : self{self_}
@@ -292,7 +436,126 @@ struct ScriptParser::Private
         return expr;
     }
 
-    ScriptResult evalExpression(const Expression& exp, const auto& tracks) const
+    CompiledExpr compile(const Expression& exp) const
+    {
+        CompiledExpr compiled{.type = exp.type, .value = {}, .variable = {}, .function = nullptr, .args = {}};
+
+        switch(exp.type) {
+            case(Expr::Literal):
+            case(Expr::VariableList):
+                compiled.value = std::get<QString>(exp.value);
+                break;
+            case(Expr::Variable):
+                compiled.value    = std::get<QString>(exp.value);
+                compiled.variable = registry->resolveVariable(compiled.value);
+                break;
+            case(Expr::Function): {
+                const auto& func  = std::get<FuncValue>(exp.value);
+                compiled.value    = func.name;
+                compiled.function = registry->resolveFunction(func.name);
+                compiled.args     = compile(func.args);
+                break;
+            }
+            case(Expr::FunctionArg):
+            case(Expr::Conditional):
+                compiled.args = compile(std::get<ExpressionList>(exp.value));
+                break;
+            case(Expr::Null):
+            default:
+                break;
+        }
+
+        fold(compiled);
+
+        return compiled;
+    }
+
+    /*!
+     * Evaluates @p exp now if it doesn't depend on the track.
+     * All registered functions are pure, so a function is constant if its arguments are.
+     */
+    void fold(CompiledExpr& exp) const
+    {
+        const bool argsPure     = std::ranges::all_of(exp.args, [](const CompiledExpr& arg) { return arg.pure; });
+        const bool argsConstant = std::ranges::all_of(exp.args, [](const CompiledExpr& arg) {
+            return arg.constant.has_value();
+        });
+
+        switch(exp.type) {
+            case(Expr::Literal):
+                exp.pure     = true;
+                exp.constant = evalLiteral(exp);
+                break;
+            case(Expr::Variable):
+                exp.pure = exp.variable.isValid();
+                break;
+            case(Expr::Function):
+                exp.pure = exp.function && argsPure;
+                if(exp.function && argsConstant) {
+                    exp.constant = evalFunction(exp, Track{}, nullptr);
+                }
+                break;
+            case(Expr::FunctionArg):
+                exp.pure = argsPure;
+                if(argsConstant) {
+                    exp.constant = evalFunctionArg(exp, Track{}, nullptr);
+                }
+                break;
+            case(Expr::Conditional):
+                exp.pure = argsPure;
+                if(argsConstant) {
+                    exp.constant = evalConditional(exp, Track{}, nullptr);
+                }
+                break;
+            case(Expr::VariableList):
+            case(Expr::Null):
+            default:
+                break;
+        }
+
+        if(exp.pure) {
+            exp.key = QString::number(exp.type) + u'(' + QString::number(exp.value.size()) + u':' + exp.value;
+            for(const CompiledExpr& arg : exp.args) {
+                exp.key += arg.key;
+            }
+            exp.key += u')';
+            exp.keyHash = qHash(exp.key);
+        }
+    }
+
+    std::vector<CompiledExpr> compile(const ExpressionList& expressions) const
+    {
+        std::vector<CompiledExpr> compiled;
+        compiled.reserve(expressions.size());
+
+        for(const Expression& exp : expressions) {
+            compiled.emplace_back(compile(exp));
+        }
+
+        return compiled;
+    }
+
+    ScriptResult evalExpression(const CompiledExpr& exp, const auto& tracks, ScriptCache::Private* cache) const
+    {
+        if(exp.constant) {
+            return exp.constant.value();
+        }
+
+        // Only worth caching expressions which do more than read a variable
+        if(cache && exp.pure && (exp.type == Expr::Function || exp.type == Expr::Conditional)) {
+            const ScriptCache::Private::Key key{.hash = exp.keyHash, .key = exp.key};
+            if(const auto resultIt = cache->results.find(key); resultIt != cache->results.cend()) {
+                return resultIt->second;
+            }
+            ScriptResult result = evalNode(exp, tracks, cache);
+            cache->results.emplace(key, result);
+            return result;
+        }
+
+        return evalNode(exp, tracks, cache);
+    }
+
+    ScriptResult evalNode(const CompiledExpr& exp, const auto& tracks, ScriptCache::Private* cache) const
     {
         switch(exp.type) {
             case(Expr::Literal):
@@ -302,91 +565,109 @@ struct ScriptParser::Private
             case(Expr::VariableList):
                 return evalVariableList(exp, tracks);
             case(Expr::Function):
-                return evalFunction(exp, tracks);
+                return evalFunction(exp, tracks, cache);
             case(Expr::FunctionArg):
-                return evalFunctionArg(exp, tracks);
+                return evalFunctionArg(exp, tracks, cache);
             case(Expr::Conditional):
-                return evalConditional(exp, tracks);
+                return evalConditional(exp, tracks, cache);
             case(Expr::Null):
             default:
                 return {};
         }
     }
 
-    ScriptResult evalLiteral(const Expression& exp) const
+    static ScriptResult evalLiteral(const CompiledExpr& exp)
     {
         ScriptResult result;
-        result.value = std::get<QString>(exp.value);
+        result.value = exp.value;
         result.cond  = true;
         return result;
     }
 
-    ScriptResult evalVariable(const Expression& exp, const auto& tracks) const
+    ScriptResult variableValue(const CompiledExpr& exp, const Track& track) const
+    {
+        if(exp.variable.isValid()) {
+            return registry->value(exp.variable, track);
+        }
+        return registry->value(exp.value, track);
+    }
+
+    ScriptResult variableValue(const CompiledExpr& exp, const TrackList& tracks) const
+    {
+        if(exp.variable.isValid()) {
+            return tracks.empty() ? ScriptResult{} : registry->value(exp.variable, tracks.front());
+        }
+        return registry->value(exp.value, tracks);
+    }
+
+    ScriptResult evalVariable(const CompiledExpr& exp, const auto& tracks) const
     {
-        const QString var   = std::get<QString>(exp.value);
-        ScriptResult result = registry->value(var, tracks);
+        ScriptResult result = variableValue(exp, tracks);
 
         if(!result.cond) {
             return {};
         }
 
-        if(result.value.contains(u"\037")) {
-            result.value = result.value.replace(QStringLiteral("\037"), QStringLiteral(", "));
-        }
+        // Only detaches if a separator is found
+        result.value.replace(u'\037', QStringLiteral(", "));
 
         return result;
     }
 
-    ScriptResult evalVariableList(const Expression& exp, const auto& tracks) const
+    ScriptResult evalVariableList(const CompiledExpr& exp, const auto& tracks) const
     {
-        const QString var = std::get<QString>(exp.value);
-        return registry->value(var, tracks);
+        return registry->value(exp.value, tracks);
     }
 
-    ScriptResult evalFunction(const Expression& exp, const auto& tracks) const
+    ScriptResult evalFunction(const CompiledExpr& exp, const auto& tracks, ScriptCache::Private* cache) const
     {
-        auto func = std::get<FuncValue>(exp.value);
-        ScriptValueList args;
-        std::ranges::transform(func.args, std::back_inserter(args),
-                               [this, &tracks](const Expression& arg) { return evalExpression(arg, tracks); });
-        return registry->function(func.name, args);
+        ScriptValueList& args = argumentStack.push();
+        for(const CompiledExpr& arg : exp.args) {
+            args.push_back(evalExpression(arg, tracks, cache));
+        }
+
+        ScriptResult result
+            = exp.function ? registry->function(exp.function, args) : registry->function(exp.value, args);
+
+        argumentStack.pop();
+
+        return result;
     }
 
-    ScriptResult evalFunctionArg(const Expression& exp, const auto& tracks) const
+    ScriptResult evalFunctionArg(const CompiledExpr& exp, const auto& tracks, ScriptCache::Private* cache) const
     {
         ScriptResult result;
         bool allPassed{true};
 
-        auto arg = std::get<ExpressionList>(exp.value);
-        for(const Expression& subArg : arg) {
-            const auto subExpr = evalExpression(subArg, tracks);
+        for(const CompiledExpr& subArg : exp.args) {
+            const auto subExpr = evalExpression(subArg, tracks, cache);
             if(!subExpr.cond) {
                 allPassed = false;
             }
-            if(subExpr.value.contains(u"\037")) {
+            if(subExpr.value.contains(u'\037')) {
                 QStringList newResult;
-                const auto values = subExpr.value.split(QStringLiteral("\037"));
+                const auto values = subExpr.value.split(u'\037');
+                newResult.reserve(values.size());
                 std::ranges::transform(values, std::back_inserter(newResult),
                                        [&](const auto& value) { return result.value + value; });
-                result.value = newResult.join(u"\037");
+                result.value = newResult.join(u'\037');
             }
             else {
-                result.value = result.value + subExpr.value;
+                result.value += subExpr.value;
             }
         }
         result.cond = allPassed;
         return result;
     }
 
-    ScriptResult evalConditional(const Expression& exp, const auto& tracks) const
+    ScriptResult evalConditional(const CompiledExpr& exp, const auto& tracks, ScriptCache::Private* cache) const
     {
         ScriptResult result;
-        QStringList exprResult;
+        ResultBuilder exprResult;
         result.cond = true;
 
-        auto arg = std::get<ExpressionList>(exp.value);
-        for(const Expression& subArg : arg) {
-            const auto subExpr = evalExpression(subArg, tracks);
+        for(const CompiledExpr& subArg : exp.args) {
+            const auto subExpr = evalExpression(subArg, tracks, cache);
 
             // Literals return false
             if(subArg.type != Expr::Literal) {
@@ -397,29 +678,9 @@ struct ScriptParser::Private
                     return result;
                 }
             }
-            if(subExpr.value.contains(u"\037")) {
-                const QStringList evalList = evalStringList(subExpr, exprResult);
-                if(!evalList.empty()) {
-                    exprResult = evalList;
-                }
-            }
-            else {
-                if(exprResult.empty()) {
-                    exprResult.append(subExpr.value);
-                }
-                else {
-                    std::ranges::transform(exprResult, exprResult.begin(), [&](const QString& retValue) -> QString {
-                        return retValue + subExpr.value;
-                    });
-                }
-            }
-        }
-        if(exprResult.size() == 1) {
-            result.value = exprResult.constFirst();
-        }
-        else if(exprResult.size() > 1) {
-            result.value = exprResult.join(u"\037");
+            exprResult.append(subExpr.value);
         }
+        result.value = exprResult.take();
         return result;
     }
 
@@ -446,54 +707,38 @@ struct ScriptParser::Private
 
         consume(TokenType::TokEos, QStringLiteral("Expected end of expression"));
 
+        script.program = std::make_shared<const CompiledScript>(compile(script.expressions));
+
         return script;
     }
 
-    QString evaluate(const ParsedScript& input, const auto& tracks)
+    QString evaluate(const ParsedScript& input, const auto& tracks, ScriptCache::Private* cache = nullptr) const
     {
         if(!input.isValid() || !registry) {
             return {};
         }
 
-        currentResult.clear();
-
-        const ExpressionList expressions = input.expressions;
-        for(const auto& expr : expressions) {
-            const auto evalExpr = evalExpression(expr, tracks);
+        if(input.program) {
+            return evaluate(*input.program, tracks, cache);
+        }
 
-            if(evalExpr.value.isNull()) {
-                continue;
-            }
+        // Not produced by parse, so resolve everything now
+        return evaluate(CompiledScript{compile(input.expressions)}, tracks, cache);
+    }
 
-            if(evalExpr.value.contains(u"\037")) {
-                const QStringList evalList = evalStringList(evalExpr, currentResult);
-                if(!evalList.empty()) {
-                    currentResult = evalList;
-                }
-            }
-            else {
-                if(currentResult.empty()) {
-                    currentResult.push_back(evalExpr.value);
-                }
-                else {
-                    std::ranges::transform(
-                        currentResult, currentResult.begin(),
-                        [&](const QString& retValue) -> QString { return retValue + evalExpr.value; });
-                }
-            }
-        }
+    QString evaluate(const CompiledScript& script, const auto& tracks, ScriptCache::Private* cache) const
+    {
+        ResultBuilder result;
 
-        if(currentResult.size() == 1) {
-            // Calling join on a QStringList with a single empty string will return a null QString, so return the first
-            // result.
-            return currentResult.constFirst();
-        }
+        for(const auto& expr : script.expressions) {
+            const auto evalExpr = evalExpression(expr, tracks, cache);
 
-        if(currentResult.size() > 1) {
-            return currentResult.join(u"\037");
+            if(!evalExpr.value.isNull()) {
+                result.append(evalExpr.value);
+            }
         }
 
-        return {};
+        return result.take();
     }
 };
 
@@ -527,7 +772,7 @@ QString ScriptParser::evaluate(const QString& input)
     return evaluate(input, Track{});
 }
 
-QString ScriptParser::evaluate(const ParsedScript& input)
+QString ScriptParser::evaluate(const ParsedScript& input) const
 {
     return evaluate(input, Track{});
 }
@@ -538,18 +783,29 @@ QString ScriptParser::evaluate(const QString& input, const Track& track)
     return p->evaluate(script, track);
 }
 
-QString ScriptParser::evaluate(const ParsedScript& input, const Track& track)
+QString ScriptParser::evaluate(const ParsedScript& input, const Track& track) const
 {
     return p->evaluate(input, track);
 }
 
+QString ScriptParser::evaluate(const QString& input, const Track& track, ScriptCache& cache)
+{
+    const auto script = parse(input, track);
+    return p->evaluate(script, track, cache.p.get());
+}
+
+QString ScriptParser::evaluate(const ParsedScript& input, const Track& track, ScriptCache& cache) const
+{
+    return p->evaluate(input, track, cache.p.get());
+}
+
 QString ScriptParser::evaluate(const QString& input, const TrackList& tracks)
 {
     const auto script = parse(input, tracks);
     return p->evaluate(script, tracks);
 }
 
-QString ScriptParser::evaluate(const ParsedScript& input, const TrackList& tracks)
+QString ScriptParser::evaluate(const ParsedScript& input, const TrackList& tracks) const
 {
     return p->evaluate(input, tracks);
 }
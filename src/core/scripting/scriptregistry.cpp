@@ -35,10 +35,33 @@ using NativeBoolFunc = std::function<Fooyin::ScriptResult(const QStringList&)>;
 using NativeCondFunc = std::function<Fooyin::ScriptResult(const Fooyin::ScriptValueList&)>;
 using Func           = std::variant<NativeFunc, NativeVoidFunc, NativeBoolFunc, NativeCondFunc>;
 
-using TrackFunc     = std::function<Fooyin::ScriptRegistry::FuncRet(const Fooyin::Track&)>;
 using TrackSetFunc  = std::function<void(Fooyin::Track&, const Fooyin::ScriptRegistry::FuncRet&)>;
 using TrackListFunc = std::function<Fooyin::ScriptRegistry::FuncRet(const Fooyin::TrackList&)>;
 
+/*!
+ * Returns the values of @p args as a list which is reused between calls on the same thread,
+ * so calling a function doesn't allocate. Only valid until the next call.
+ */
+const QStringList& argumentList(const Fooyin::ScriptValueList& args)
+{
+    thread_local QStringList list;
+
+    list.clear();
+    list.reserve(static_cast<qsizetype>(args.size()));
+    for(const auto& arg : args) {
+        list.append(arg.value);
+    }
+
+    return list;
+}
+
+// A plain function pointer for each getter, so resolved variables are a single direct call
+template <auto Getter>
+Fooyin::ScriptRegistry::FuncRet trackValue(const Fooyin::Track& track)
+{
+    return (track.*Getter)();
+}
+
 template <typename FuncType>
 auto generateSetFunc(FuncType func)
 {
@@ -68,14 +91,25 @@ auto generateSetFunc(FuncType func)
 } // namespace
 
 namespace Fooyin {
-struct ScriptRegistry::Private
+struct ScriptFunction
 {
-    std::unordered_map<QString, TrackFunc> metadata;
+    Func func;
+};
+
+namespace {
+/*!
+ * The default variables and functions.
+ * These never change, so they're built once and shared by every registry. This also
+ * keeps resolved variables and functions valid for the lifetime of the program.
+ */
+struct ScriptTables
+{
+    std::unordered_map<QString, ScriptRegistry::TrackValueFunc> metadata;
     std::unordered_map<QString, TrackSetFunc> setMetadata;
     std::unordered_map<QString, TrackListFunc> listProperties;
-    std::unordered_map<QString, Func> funcs;
+    std::unordered_map<QString, ScriptFunction> funcs;
 
-    Private()
+    ScriptTables()
     {
         addDefaultFunctions();
         addDefaultListFuncs();
@@ -84,34 +118,34 @@ struct ScriptRegistry::Private
 
     void addDefaultFunctions()
     {
-        funcs.emplace(QStringLiteral("add"), Fooyin::Scripting::add);
-        funcs.emplace(QStringLiteral("sub"), Fooyin::Scripting::sub);
-        funcs.emplace(QStringLiteral("mul"), Fooyin::Scripting::mul);
-        funcs.emplace(QStringLiteral("div"), Fooyin::Scripting::div);
-        funcs.emplace(QStringLiteral("min"), Fooyin::Scripting::min);
-        funcs.emplace(QStringLiteral("max"), Fooyin::Scripting::max);
-        funcs.emplace(QStringLiteral("mod"), Fooyin::Scripting::mod);
-
-        funcs.emplace(QStringLiteral("num"), Fooyin::Scripting::num);
-        funcs.emplace(QStringLiteral("replace"), Fooyin::Scripting::replace);
-        funcs.emplace(QStringLiteral("chop"), Fooyin::Scripting::chop);
-        funcs.emplace(QStringLiteral("slice"), Fooyin::Scripting::slice);
-        funcs.emplace(QStringLiteral("left"), Fooyin::Scripting::left);
-        funcs.emplace(QStringLiteral("right"), Fooyin::Scripting::right);
-        funcs.emplace(QStringLiteral("strcmp"), Fooyin::Scripting::strcmp);
-        funcs.emplace(QStringLiteral("strcmpi"), Fooyin::Scripting::strcmpi);
-        funcs.emplace(QStringLiteral("sep"), Fooyin::Scripting::sep);
-        funcs.emplace(QStringLiteral("swapprefix"), Fooyin::Scripting::swapPrefix);
-        funcs.emplace(QStringLiteral("pad"), Fooyin::Scripting::pad);
-        funcs.emplace(QStringLiteral("padright"), Fooyin::Scripting::padRight);
-
-        funcs.emplace(QStringLiteral("timems"), Fooyin::Scripting::msToString);
-
-        funcs.emplace(QStringLiteral("if"), Fooyin::Scripting::cif);
-        funcs.emplace(QStringLiteral("if2"), Fooyin::Scripting::cif2);
-        funcs.emplace(QStringLiteral("ifgreater"), Fooyin::Scripting::ifgreater);
-        funcs.emplace(QStringLiteral("iflonger"), Fooyin::Scripting::iflonger);
-        funcs.emplace(QStringLiteral("ifequal"), Fooyin::Scripting::ifequal);
+        funcs.emplace(QStringLiteral("add"), ScriptFunction{Fooyin::Scripting::add});
+        funcs.emplace(QStringLiteral("sub"), ScriptFunction{Fooyin::Scripting::sub});
+        funcs.emplace(QStringLiteral("mul"), ScriptFunction{Fooyin::Scripting::mul});
+        funcs.emplace(QStringLiteral("div"), ScriptFunction{Fooyin::Scripting::div});
+        funcs.emplace(QStringLiteral("min"), ScriptFunction{Fooyin::Scripting::min});
+        funcs.emplace(QStringLiteral("max"), ScriptFunction{Fooyin::Scripting::max});
+        funcs.emplace(QStringLiteral("mod"), ScriptFunction{Fooyin::Scripting::mod});
+
+        funcs.emplace(QStringLiteral("num"), ScriptFunction{Fooyin::Scripting::num});
+        funcs.emplace(QStringLiteral("replace"), ScriptFunction{Fooyin::Scripting::replace});
+        funcs.emplace(QStringLiteral("chop"), ScriptFunction{Fooyin::Scripting::chop});
+        funcs.emplace(QStringLiteral("slice"), ScriptFunction{Fooyin::Scripting::slice});
+        funcs.emplace(QStringLiteral("left"), ScriptFunction{Fooyin::Scripting::left});
+        funcs.emplace(QStringLiteral("right"), ScriptFunction{Fooyin::Scripting::right});
+        funcs.emplace(QStringLiteral("strcmp"), ScriptFunction{Fooyin::Scripting::strcmp});
+        funcs.emplace(QStringLiteral("strcmpi"), ScriptFunction{Fooyin::Scripting::strcmpi});
+        funcs.emplace(QStringLiteral("sep"), ScriptFunction{Fooyin::Scripting::sep});
+        funcs.emplace(QStringLiteral("swapprefix"), ScriptFunction{Fooyin::Scripting::swapPrefix});
+        funcs.emplace(QStringLiteral("pad"), ScriptFunction{Fooyin::Scripting::pad});
+        funcs.emplace(QStringLiteral("padright"), ScriptFunction{Fooyin::Scripting::padRight});
+
+        funcs.emplace(QStringLiteral("timems"), ScriptFunction{Fooyin::Scripting::msToString});
+
+        funcs.emplace(QStringLiteral("if"), ScriptFunction{Fooyin::Scripting::cif});
+        funcs.emplace(QStringLiteral("if2"), ScriptFunction{Fooyin::Scripting::cif2});
+        funcs.emplace(QStringLiteral("ifgreater"), ScriptFunction{Fooyin::Scripting::ifgreater});
+        funcs.emplace(QStringLiteral("iflonger"), ScriptFunction{Fooyin::Scripting::iflonger});
+        funcs.emplace(QStringLiteral("ifequal"), ScriptFunction{Fooyin::Scripting::ifequal});
     }
 
     void addDefaultListFuncs()
@@ -126,34 +160,34 @@ struct ScriptRegistry::Private
         using namespace Fooyin::Constants;
         using Fooyin::Track;
 
-        metadata[QString::fromLatin1(MetaData::Title)]        = &Track::title;
-        metadata[QString::fromLatin1(MetaData::Artist)]       = &Track::artists;
-        metadata[QString::fromLatin1(MetaData::UniqueArtist)] = &Track::uniqueArtists;
-        metadata[QString::fromLatin1(MetaData::Album)]        = &Track::album;
-        metadata[QString::fromLatin1(MetaData::AlbumArtist)]  = &Track::albumArtists;
-        metadata[QString::fromLatin1(MetaData::Track)]        = &Track::trackNumber;
-        metadata[QString::fromLatin1(MetaData::TrackTotal)]   = &Track::trackTotal;
-        metadata[QString::fromLatin1(MetaData::Disc)]         = &Track::discNumber;
-        metadata[QString::fromLatin1(MetaData::DiscTotal)]    = &Track::discTotal;
-        metadata[QString::fromLatin1(MetaData::Genre)]        = &Track::genres;
-        metadata[QString::fromLatin1(MetaData::Composer)]     = &Track::composer;
-        metadata[QString::fromLatin1(MetaData::Performer)]    = &Track::performer;
-        metadata[QString::fromLatin1(MetaData::Duration)]     = &Track::duration;
-        metadata[QString::fromLatin1(MetaData::Comment)]      = &Track::comment;
-        metadata[QString::fromLatin1(MetaData::Date)]         = &Track::date;
-        metadata[QString::fromLatin1(MetaData::Year)]         = &Track::year;
-        metadata[QString::fromLatin1(MetaData::FileSize)]     = &Track::fileSize;
-        metadata[QString::fromLatin1(MetaData::Bitrate)]      = &Track::bitrate;
-        metadata[QString::fromLatin1(MetaData::SampleRate)]   = &Track::sampleRate;
-        metadata[QString::fromLatin1(MetaData::PlayCount)]    = &Track::playCount;
-        metadata[QString::fromLatin1(MetaData::Codec)]        = &Track::typeString;
-        metadata[QString::fromLatin1(MetaData::AddedTime)]    = &Track::addedTime;
-        metadata[QString::fromLatin1(MetaData::ModifiedTime)] = &Track::modifiedTime;
-        metadata[QString::fromLatin1(MetaData::FilePath)]     = &Track::filepath;
-        metadata[QString::fromLatin1(MetaData::RelativePath)] = &Track::relativePath;
-        metadata[QString::fromLatin1(MetaData::FileName)]     = &Track::filename;
-        metadata[QString::fromLatin1(MetaData::Extension)]    = &Track::extension;
-        metadata[QString::fromLatin1(MetaData::Path)]         = &Track::path;
+        metadata[QString::fromLatin1(MetaData::Title)]        = &trackValue<&Track::title>;
+        metadata[QString::fromLatin1(MetaData::Artist)]       = &trackValue<&Track::artists>;
+        metadata[QString::fromLatin1(MetaData::UniqueArtist)] = &trackValue<&Track::uniqueArtists>;
+        metadata[QString::fromLatin1(MetaData::Album)]        = &trackValue<&Track::album>;
+        metadata[QString::fromLatin1(MetaData::AlbumArtist)]  = &trackValue<&Track::albumArtists>;
+        metadata[QString::fromLatin1(MetaData::Track)]        = &trackValue<&Track::trackNumber>;
+        metadata[QString::fromLatin1(MetaData::TrackTotal)]   = &trackValue<&Track::trackTotal>;
+        metadata[QString::fromLatin1(MetaData::Disc)]         = &trackValue<&Track::discNumber>;
+        metadata[QString::fromLatin1(MetaData::DiscTotal)]    = &trackValue<&Track::discTotal>;
+        metadata[QString::fromLatin1(MetaData::Genre)]        = &trackValue<&Track::genres>;
+        metadata[QString::fromLatin1(MetaData::Composer)]     = &trackValue<&Track::composer>;
+        metadata[QString::fromLatin1(MetaData::Performer)]    = &trackValue<&Track::performer>;
+        metadata[QString::fromLatin1(MetaData::Duration)]     = &trackValue<&Track::duration>;
+        metadata[QString::fromLatin1(MetaData::Comment)]      = &trackValue<&Track::comment>;
+        metadata[QString::fromLatin1(MetaData::Date)]         = &trackValue<&Track::date>;
+        metadata[QString::fromLatin1(MetaData::Year)]         = &trackValue<&Track::year>;
+        metadata[QString::fromLatin1(MetaData::FileSize)]     = &trackValue<&Track::fileSize>;
+        metadata[QString::fromLatin1(MetaData::Bitrate)]      = &trackValue<&Track::bitrate>;
+        metadata[QString::fromLatin1(MetaData::SampleRate)]   = &trackValue<&Track::sampleRate>;
+        metadata[QString::fromLatin1(MetaData::PlayCount)]    = &trackValue<&Track::playCount>;
+        metadata[QString::fromLatin1(MetaData::Codec)]        = &trackValue<&Track::typeString>;
+        metadata[QString::fromLatin1(MetaData::AddedTime)]    = &trackValue<&Track::addedTime>;
+        metadata[QString::fromLatin1(MetaData::ModifiedTime)] = &trackValue<&Track::modifiedTime>;
+        metadata[QString::fromLatin1(MetaData::FilePath)]     = &trackValue<&Track::filepath>;
+        metadata[QString::fromLatin1(MetaData::RelativePath)] = &trackValue<&Track::relativePath>;
+        metadata[QString::fromLatin1(MetaData::FileName)]     = &trackValue<&Track::filename>;
+        metadata[QString::fromLatin1(MetaData::Extension)]    = &trackValue<&Track::extension>;
+        metadata[QString::fromLatin1(MetaData::Path)]         = &trackValue<&Track::path>;
 
         setMetadata[QString::fromLatin1(MetaData::Title)]        = generateSetFunc(&Track::setTitle);
         setMetadata[QString::fromLatin1(MetaData::Artist)]       = generateSetFunc(&Track::setArtists);
@@ -179,6 +213,22 @@ struct ScriptRegistry::Private
     }
 };
 
+const ScriptTables& scriptTables()
+{
+    static const ScriptTables tables;
+    return tables;
+}
+} // namespace
+
+struct ScriptRegistry::Private
+{
+    const ScriptTables& tables{scriptTables()};
+    const std::unordered_map<QString, ScriptRegistry::TrackValueFunc>& metadata{tables.metadata};
+    const std::unordered_map<QString, TrackSetFunc>& setMetadata{tables.setMetadata};
+    const std::unordered_map<QString, TrackListFunc>& listProperties{tables.listProperties};
+    const std::unordered_map<QString, ScriptFunction>& funcs{tables.funcs};
+};
+
 ScriptRegistry::ScriptRegistry()
     : p{std::make_unique<Private>()}
 { }
@@ -239,24 +289,65 @@ ScriptResult ScriptRegistry::value(const QString& var, const TrackList& tracks)
 
 ScriptResult ScriptRegistry::function(const QString& func, const ScriptValueList& args) const
 {
-    if(func.isEmpty() || !p->funcs.contains(func)) {
+    if(func.isEmpty()) {
+        return {};
+    }
+
+    return function(resolveFunction(func), args);
+}
+
+ScriptRegistry::ResolvedVariable ScriptRegistry::resolveVariable(const QString& var) const
+{
+    if(var.isEmpty() || isListVariable(var)) {
+        return {};
+    }
+
+    if(const auto metaIt = p->metadata.find(var); metaIt != p->metadata.cend()) {
+        return {.accessor = metaIt->second, .extraTag = {}};
+    }
+
+    return {.accessor = nullptr, .extraTag = var.toUpper()};
+}
+
+const ScriptFunction* ScriptRegistry::resolveFunction(const QString& func) const
+{
+    const auto funcIt = p->funcs.find(func);
+    return funcIt != p->funcs.cend() ? &funcIt->second : nullptr;
+}
+
+ScriptResult ScriptRegistry::value(const ResolvedVariable& var, const Track& track) const
+{
+    if(var.accessor) {
+        return calculateResult(var.accessor(track));
+    }
+
+    if(var.extraTag.isEmpty() || !track.hasExtraTag(var.extraTag)) {
+        return {};
+    }
+
+    return calculateResult(track.extraTag(var.extraTag));
+}
+
+ScriptResult ScriptRegistry::function(const ScriptFunction* func, const ScriptValueList& args) const
+{
+    if(!func) {
         return {};
     }
 
-    auto function = p->funcs.at(func);
-    if(std::holds_alternative<NativeFunc>(function)) {
-        const QString value = std::get<NativeFunc>(function)(containerCast<QStringList>(args));
+    const auto& function = func->func;
+    if(const auto* nativeFunc = std::get_if<NativeFunc>(&function)) {
+        const QString value = (*nativeFunc)(argumentList(args));
         return {.value = value, .cond = !value.isEmpty()};
     }
-    if(std::holds_alternative<NativeVoidFunc>(function)) {
-        const QString value = std::get<NativeVoidFunc>(function)();
+    if(const auto* nativeVoidFunc = std::get_if<NativeVoidFunc>(&function)) {
+        const QString value = (*nativeVoidFunc)();
         return {.value = value, .cond = !value.isEmpty()};
     }
-    if(std::holds_alternative<NativeBoolFunc>(function)) {
-        return std::get<NativeBoolFunc>(function)(containerCast<QStringList>(args));
+    if(const auto* nativeBoolFunc = std::get_if<NativeBoolFunc>(&function)) {
+        return (*nativeBoolFunc)(argumentList(args));
     }
-    if(std::holds_alternative<NativeCondFunc>(function)) {
-        return std::get<NativeCondFunc>(function)(args);
+    if(const auto* nativeCondFunc = std::get_if<NativeCondFunc>(&function)) {
+        return (*nativeCondFunc)(args);
     }
 
     return {};
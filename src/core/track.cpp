@@ -21,6 +21,7 @@
 
 #include <core/constants.h>
 #include <utils/crypto.h>
+#include <utils/stringpool.h>
 
 #include <QFileInfo>
 #include <QIODevice>
@@ -689,6 +690,46 @@ void Track::clearWasModified()
     p->metadataWasModified = false;
 }
 
+void Track::shareStrings(StringPool& pool)
+{
+    // Avoid detaching if the strings are already shared
+    const auto share = [this, &pool]<typename T>(T Private::*member) {
+        const T& current = p.constData()->*member;
+        T interned       = pool.intern(current);
+        if(!interned.isSharedWith(current)) {
+            p->*member = std::move(interned);
+        }
+    };
+
+    share(&Private::extension);
+    share(&Private::artists);
+    share(&Private::album);
+    share(&Private::albumArtists);
+    share(&Private::genres);
+    share(&Private::composer);
+    share(&Private::performer);
+    share(&Private::comment);
+    share(&Private::date);
+
+    const ExtraTags& currentTags = p.constData()->extraTags;
+    if(currentTags.isEmpty()) {
+        return;
+    }
+
+    bool allShared{true};
+    ExtraTags tags;
+    for(auto tagIt = currentTags.cbegin(); tagIt != currentTags.cend(); ++tagIt) {
+        const QString tag       = pool.intern(tagIt.key());
+        const QStringList value = pool.intern(tagIt.value());
+        allShared = allShared && tag.isSharedWith(tagIt.key()) && value.isSharedWith(tagIt.value());
+        tags.insert(tag, value);
+    }
+
+    if(!allShared) {
+        p->extraTags = std::move(tags);
+    }
+}
+
 QStringList Track::supportedFileExtensions()
 {
     static const QStringList supportedExtensions
@@ -44,6 +44,10 @@ LibraryMenu::LibraryMenu(ActionManager* actionManager, MusicLibrary* library, Se
     libraryMenu->addAction(m_actionManager->registerAction(rescanLibrary, Constants::Actions::Rescan));
     QObject::connect(rescanLibrary, &QAction::triggered, m_library, &MusicLibrary::rescanAll);
 
+    auto* rescanLibraryFull = new QAction(tr("Rescan Libraries (&Full)"), this);
+    libraryMenu->addAction(m_actionManager->registerAction(rescanLibraryFull, Constants::Actions::RescanFull));
+    QObject::connect(rescanLibraryFull, &QAction::triggered, m_library, &MusicLibrary::rescanAllFull);
+
     auto* openSettings = new QAction(Utils::iconFromTheme(Constants::Icons::Settings), tr("&Configure"), this);
     libraryMenu->addAction(actionManager->registerAction(openSettings, "Library.Configure"));
     QObject::connect(openSettings, &QAction::triggered, this,
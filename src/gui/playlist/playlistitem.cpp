@@ -34,8 +34,8 @@ PlaylistItem::PlaylistItem(ItemType type, Data data, PlaylistItem* parent)
     , m_state{State::None}
     , m_type{type}
     , m_data{std::move(data)}
-    , m_baseKey{QStringLiteral("0")}
-    , m_key{QStringLiteral("0")}
+    , m_baseKey{0}
+    , m_key{0}
     , m_index{-1}
 { }
 
@@ -59,12 +59,12 @@ Data& PlaylistItem::data() const
     return m_data;
 }
 
-QString PlaylistItem::baseKey() const
+ItemKey PlaylistItem::baseKey() const
 {
     return m_baseKey;
 }
 
-QString PlaylistItem::key() const
+ItemKey PlaylistItem::key() const
 {
     return m_key;
 }
@@ -84,12 +84,12 @@ void PlaylistItem::setState(State state)
     m_state = state;
 }
 
-void PlaylistItem::setBaseKey(const QString& key)
+void PlaylistItem::setBaseKey(ItemKey key)
 {
     m_baseKey = key;
 }
 
-void PlaylistItem::setKey(const QString& key)
+void PlaylistItem::setKey(ItemKey key)
 {
     m_key = key;
 }
@@ -25,6 +25,8 @@
 
 namespace Fooyin {
 using Data = std::variant<PlaylistTrackItem, PlaylistContainerItem>;
+// Identifies an item in the playlist model, with 0 being the root
+using ItemKey = quint64;
 
 class PlaylistItem : public TreeItem<PlaylistItem>
 {
@@ -71,14 +73,14 @@ public:
     [[nodiscard]] State state() const;
     [[nodiscard]] ItemType type() const;
     [[nodiscard]] Data& data() const;
-    [[nodiscard]] QString baseKey() const;
-    [[nodiscard]] QString key() const;
+    [[nodiscard]] ItemKey baseKey() const;
+    [[nodiscard]] ItemKey key() const;
     [[nodiscard]] int index() const;
 
     void setPending(bool pending);
     void setState(State state);
-    void setBaseKey(const QString& key);
-    void setKey(const QString& key);
+    void setBaseKey(ItemKey key);
+    void setKey(ItemKey key);
     void setIndex(int index);
 
     void removeColumn(int column);
@@ -92,8 +94,8 @@ private:
     State m_state;
     ItemType m_type;
     mutable Data m_data;
-    QString m_baseKey;
-    QString m_key;
+    ItemKey m_baseKey;
+    ItemKey m_key;
     int m_index;
 };
 using PlaylistItemList = std::vector<PlaylistItem*>;
@@ -32,7 +32,6 @@
 #include <gui/coverprovider.h>
 #include <gui/guiconstants.h>
 #include <gui/guisettings.h>
-#include <utils/crypto.h>
 #include <utils/settings/settingsmanager.h>
 #include <utils/utils.h>
 
@@ -42,6 +41,7 @@
 #include <QIcon>
 #include <QMimeData>
 #include <QPalette>
+#include <QRandomGenerator>
 
 #include <queue>
 #include <span>
@@ -155,8 +155,8 @@ int determineDropIndex(const QAbstractItemModel* model, const QModelIndex& paren
 
 Fooyin::PlaylistItem* cloneParent(Fooyin::ItemKeyMap& nodes, Fooyin::PlaylistItem* parent)
 {
-    const QString parentKey = Fooyin::Utils::generateRandomHash();
-    auto* newParent         = &nodes.emplace(parentKey, *parent).first->second;
+    const Fooyin::ItemKey parentKey = QRandomGenerator::global()->generate64();
+    auto* newParent                 = &nodes.emplace(parentKey, *parent).first->second;
     newParent->setKey(parentKey);
     newParent->resetRow();
     newParent->clearChildren();
@@ -164,6 +164,25 @@ Fooyin::PlaylistItem* cloneParent(Fooyin::ItemKeyMap& nodes, Fooyin::PlaylistIte
     return newParent;
 }
 
+bool itemTextChanged(const Fooyin::Data& current, const Fooyin::Data& updated)
+{
+    if(current.index() != updated.index()) {
+        return true;
+    }
+
+    if(const auto* track = std::get_if<Fooyin::PlaylistTrackItem>(&current)) {
+        const auto& updatedTrack = std::get<Fooyin::PlaylistTrackItem>(updated);
+        return track->columns() != updatedTrack.columns() || track->left() != updatedTrack.left()
+            || track->right() != updatedTrack.right() || track->rowHeight() != updatedTrack.rowHeight();
+    }
+
+    const auto& container        = std::get<Fooyin::PlaylistContainerItem>(current);
+    const auto& updatedContainer = std::get<Fooyin::PlaylistContainerItem>(updated);
+    return container.title() != updatedContainer.title() || container.subtitle() != updatedContainer.subtitle()
+        || container.sideText() != updatedContainer.sideText() || container.info() != updatedContainer.info()
+        || container.rowHeight() != updatedContainer.rowHeight();
+}
+
 QModelIndexList optimiseSelection(QAbstractItemModel* model, const QModelIndexList& selection)
 {
     std::queue<QModelIndex> stack;
@@ -540,6 +559,7 @@ PlaylistModel::PlaylistModel(MusicLibrary* library, PlayerController* playerCont
     , m_settings{settings}
     , m_coverProvider{new CoverProvider(settings, this)}
     , m_resetting{false}
+    , m_refreshing{false}
     , m_playingColour{QApplication::palette().highlight().color()}
     , m_disabledColour{Qt::red}
     , m_altColours{settings->value<Settings::Gui::Internal::PlaylistAltColours>()}
@@ -593,6 +613,9 @@ PlaylistModel::PlaylistModel(MusicLibrary* library, PlayerController* playerCont
     });
 
     QObject::connect(&m_populator, &PlaylistPopulator::finished, this, [this]() {
+        if(m_refreshing) {
+            refreshModel();
+        }
         m_playlistLoaded = true;
         emit dataChanged({}, {});
         emit playlistLoaded();
@@ -730,7 +753,7 @@ void PlaylistModel::fetchMore(const QModelIndex& parent)
     const auto rowsToInsert = std::views::take(rows, rowCount);
 
     beginInsertRows(parent, row, row + rowCount - 1);
-    for(const QString& pendingRow : rowsToInsert) {
+    for(const ItemKey pendingRow : rowsToInsert) {
         PlaylistItem& child = m_nodes.at(pendingRow);
         fetchChildren(parentItem, &child);
     }
@@ -955,6 +978,10 @@ void PlaylistModel::resetColumnAlignments()
 
 void PlaylistModel::reset(const PlaylistPreset& preset, const PlaylistColumnList& columns, Playlist* playlist)
 {
+    // Repopulating the same playlist with the same layout can update rows in place once finished
+    const bool refresh = playlist && playlist == m_currentPlaylist && m_playlistLoaded && !m_nodes.empty()
+                      && (!preset.isValid() || preset == m_currentPreset) && columns == m_columns;
+
     if(preset.isValid()) {
         m_currentPreset = preset;
     }
@@ -969,8 +996,10 @@ void PlaylistModel::reset(const PlaylistPreset& preset, const PlaylistColumnList
     m_populator.stopThread();
 
     m_playlistLoaded  = false;
-    m_resetting       = true;
+    m_resetting       = !refresh;
+    m_refreshing      = refresh;
     m_currentPlaylist = playlist;
+    m_refreshBatches.clear();
 
     updateHeader(playlist);
 
@@ -993,7 +1022,7 @@ TrackIndexResult PlaylistModel::trackIndexAtPlaylistIndex(int index, bool fetch)
         }
 
         if(m_trackIndexes.contains(index)) {
-            const QString key = m_trackIndexes.at(index);
+            const ItemKey key = m_trackIndexes.at(index);
             if(m_nodes.contains(key)) {
                 auto& item = m_nodes.at(key);
                 return {indexOfItem(&item), false};
@@ -1003,7 +1032,7 @@ TrackIndexResult PlaylistModel::trackIndexAtPlaylistIndex(int index, bool fetch)
 
     // End of playlist - return last track index
     const auto lastIndex = static_cast<int>(m_trackIndexes.size()) - 1;
-    const QString key    = m_trackIndexes.at(lastIndex);
+    const ItemKey key    = m_trackIndexes.at(lastIndex);
     if(m_nodes.contains(key)) {
         auto& item = m_nodes.at(key);
         return {indexOfItem(&item), true};
@@ -1198,6 +1227,12 @@ void PlaylistModel::populateModel(PendingData& data)
         return;
     }
 
+    if(m_refreshing) {
+        // Compared against the current tree once every batch has arrived
+        m_refreshBatches.push_back(std::move(data));
+        return;
+    }
+
     if(m_resetting) {
         beginResetModel();
         resetRoot();
@@ -1211,9 +1246,9 @@ void PlaylistModel::populateModel(PendingData& data)
 
     if(m_resetting) {
         for(const auto& [parentKey, rows] : data.nodes) {
-            auto* parent = parentKey == QStringLiteral("0") ? itemForIndex({}) : &m_nodes.at(parentKey);
+            auto* parent = parentKey == 0 ? itemForIndex({}) : &m_nodes.at(parentKey);
 
-            for(const QString& row : rows) {
+            for(const ItemKey row : rows) {
                 PlaylistItem* child = &m_nodes.at(row);
                 parent->appendChild(child);
                 child->setPending(false);
@@ -1230,6 +1265,72 @@ void PlaylistModel::populateModel(PendingData& data)
     }
 }
 
+void PlaylistModel::refreshModel()
+{
+    m_refreshing = false;
+
+    std::vector<PendingData> batches;
+    std::swap(batches, m_refreshBatches);
+
+    if(batches.empty()) {
+        return;
+    }
+
+    // Items are kept between batches, so the last batch has all of them
+    ItemKeyMap& items = batches.back().items;
+
+    NodeKeyMap nodes;
+    for(const PendingData& batch : batches) {
+        for(const auto& [parentKey, rows] : batch.nodes) {
+            std::ranges::copy(rows, std::back_inserter(nodes[parentKey]));
+        }
+    }
+
+    auto sameChildren = [this](ItemKey parentKey, const std::vector<ItemKey>& rows) {
+        const PlaylistItem* parent = itemForKey(parentKey);
+        if(!parent) {
+            return false;
+        }
+
+        std::vector<ItemKey> children;
+        for(const PlaylistItem* child : parent->children()) {
+            children.push_back(child->key());
+        }
+        if(m_pendingNodes.contains(parentKey)) {
+            std::ranges::copy(m_pendingNodes.at(parentKey), std::back_inserter(children));
+        }
+        return children == rows;
+    };
+
+    // Keys are derived from each item's parent, position and contents,
+    // so an unchanged tree is repopulated with the same keys in the same places
+    const bool sameTree
+        = items.size() == m_nodes.size() && std::ranges::all_of(nodes, [&sameChildren](const auto& parentRows) {
+              return sameChildren(parentRows.first, parentRows.second);
+          });
+
+    if(!sameTree) {
+        m_resetting = true;
+        for(PendingData& batch : batches) {
+            populateModel(batch);
+        }
+        return;
+    }
+
+    for(auto& [key, item] : items) {
+        PlaylistItem& node = m_nodes.at(key);
+        const bool changed = itemTextChanged(node.data(), item.data());
+
+        node.data() = std::move(item.data());
+        node.setBaseKey(item.baseKey());
+
+        if(changed && !node.pending()) {
+            const QModelIndex nodeIndex = indexOfItem(&node);
+            emit dataChanged(nodeIndex, nodeIndex.siblingAtColumn(columnCount(nodeIndex) - 1));
+        }
+    }
+}
+
 void PlaylistModel::populateTrackGroup(PendingData& data)
 {
     if(m_currentPlaylist && m_currentPlaylist->id() != data.playlistId) {
@@ -1281,7 +1382,7 @@ void PlaylistModel::mergeTrackParents(const TrackIdNodeMap& parents)
 
         auto trackIt = m_trackParents.find(id);
         if(trackIt != m_trackParents.end()) {
-            for(const QString& key : nodes) {
+            for(const ItemKey key : nodes) {
                 if(m_nodes.contains(key)) {
                     trackIt->second.emplace_back(key);
                 }
@@ -1460,9 +1561,9 @@ QVariant PlaylistModel::subheaderData(PlaylistItem* item, int column, int role)
     return {};
 }
 
-PlaylistItem* PlaylistModel::itemForKey(const QString& key)
+PlaylistItem* PlaylistModel::itemForKey(ItemKey key)
 {
-    if(key == QStringLiteral("0")) {
+    if(key == 0) {
         return rootItem();
     }
     if(m_nodes.contains(key)) {
@@ -1711,17 +1812,17 @@ void PlaylistModel::handleTrackGroup(PendingData& data)
 {
     updateTrackIndexes();
 
-    auto cmpParentKeys = [data](const QString& key1, const QString& key2) {
+    auto cmpParentKeys = [data](const ItemKey key1, const ItemKey key2) {
         if(key1 == key2) {
             return false;
         }
         return std::ranges::find(data.containerOrder, key1) < std::ranges::find(data.containerOrder, key2);
     };
-    using ParentItemMap = std::map<QString, PlaylistItemList, decltype(cmpParentKeys)>;
+    using ParentItemMap = std::map<ItemKey, PlaylistItemList, decltype(cmpParentKeys)>;
     std::map<int, ParentItemMap> itemData;
 
-    auto nodeForKey = [this, &data](const QString& key) -> PlaylistItem* {
-        if(key == QStringLiteral("0")) {
+    auto nodeForKey = [this, &data](const ItemKey key) -> PlaylistItem* {
+        if(key == 0) {
             return rootItem();
         }
         if(data.items.contains(key)) {
@@ -1732,7 +1833,7 @@ void PlaylistModel::handleTrackGroup(PendingData& data)
 
     for(const auto& [index, childKeys] : data.indexNodes) {
         ParentItemMap childrenMap(cmpParentKeys);
-        for(const QString& childKey : childKeys) {
+        for(const ItemKey childKey : childKeys) {
             if(PlaylistItem* child = nodeForKey(childKey)) {
                 if(child->parent()) {
                     childrenMap[child->parent()->key()].push_back(child);
@@ -1858,7 +1959,7 @@ int PlaylistModel::dropCopyRowsRecursive(const QModelIndex& source, const Playli
     auto* sourceParent = itemForIndex(source);
     for(Fooyin::PlaylistItem* childItem : rows) {
         childItem->resetRow();
-        const QString newKey = Fooyin::Utils::generateRandomHash();
+        const ItemKey newKey = QRandomGenerator::global()->generate64();
         auto* newChild       = &m_nodes.emplace(newKey, *childItem).first->second;
         newChild->clearChildren();
         newChild->setKey(newKey);
@@ -1942,12 +2043,12 @@ bool PlaylistModel::removePlaylistRows(int row, int count, const QModelIndex& pa
 
 void PlaylistModel::fetchChildren(PlaylistItem* parent, PlaylistItem* child)
 {
-    const QString key = child->key();
+    const ItemKey key = child->key();
 
     if(m_pendingNodes.contains(key)) {
         auto& childRows = m_pendingNodes.at(key);
 
-        for(const QString& childRow : childRows) {
+        for(const ItemKey childRow : childRows) {
             PlaylistItem& childItem = m_nodes.at(childRow);
             fetchChildren(child, &childItem);
         }
@@ -2140,7 +2241,7 @@ void PlaylistModel::coverUpdated(const Track& track)
     const auto parents   = m_trackParents.at(track.id());
     const bool hasPixmap = !m_pixmapColumns.empty();
 
-    for(const QString& parentKey : parents) {
+    for(const ItemKey parentKey : parents) {
         if(m_nodes.contains(parentKey)) {
             auto* parentItem = &m_nodes.at(parentKey);
 
@@ -2200,7 +2301,7 @@ PlaylistModel::TrackItemResult PlaylistModel::itemForTrackIndex(int index)
     }
 
     if(m_trackIndexes.contains(index)) {
-        const QString key = m_trackIndexes.at(index);
+        const ItemKey key = m_trackIndexes.at(index);
         if(m_nodes.contains(key)) {
             return {&m_nodes.at(key), false};
         }
@@ -133,6 +133,7 @@ public slots:
 
 private:
     void populateModel(PendingData& data);
+    void refreshModel();
     void populateTrackGroup(PendingData& data);
     void updateModel(ItemKeyMap& data);
     void mergeTrackParents(const TrackIdNodeMap& parents);
@@ -141,7 +142,7 @@ private:
     QVariant headerData(PlaylistItem* item, int column, int role) const;
     QVariant subheaderData(PlaylistItem* item, int column, int role) const;
 
-    PlaylistItem* itemForKey(const QString& key);
+    PlaylistItem* itemForKey(ItemKey key);
 
     struct DropTargetResult
     {
@@ -217,6 +218,7 @@ private:
     CoverProvider* m_coverProvider;
 
     bool m_resetting;
+    bool m_refreshing;
     QString m_headerText;
 
     QPixmap m_playingIcon;
@@ -233,9 +235,10 @@ private:
 
     bool m_playlistLoaded;
     NodeKeyMap m_pendingNodes;
+    std::vector<PendingData> m_refreshBatches;
     ItemKeyMap m_nodes;
     TrackIdNodeMap m_trackParents;
-    std::map<int, QString> m_trackIndexes;
+    std::map<int, ItemKey> m_trackIndexes;
 
     PlaylistPreset m_currentPreset;
     PlaylistColumnList m_columns;
@@ -23,16 +23,169 @@
 #include "playlistscriptregistry.h"
 
 #include <core/player/playercontroller.h>
-#include <utils/crypto.h>
 
-#include <QCryptographicHash>
+#include <QRandomGenerator>
+#include <QThread>
 #include <QTimer>
 
-#include <ranges>
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <thread>
 
-constexpr int TrackPreloadSize = 2000;
+constexpr size_t TrackPreloadSize = 2000;
+// Below this many tracks per thread, starting threads costs more than it saves
+constexpr size_t MinTracksPerThread = 250;
 
 namespace Fooyin {
+namespace {
+// Script state for a single thread, as registries hold per-track properties
+struct TrackEvaluator
+{
+    PlaylistScriptRegistry registry;
+    ScriptParser parser;
+    ScriptCache cache;
+    ScriptFormatter formatter;
+
+    TrackEvaluator(const Id& playlistId, const PlaybackQueue& queue)
+        : parser{&registry}
+    {
+        registry.setup(playlistId, queue);
+    }
+
+    QString evaluate(const QString& script, const Track& track)
+    {
+        return parser.evaluate(script, track, cache);
+    }
+
+    QString evaluate(RichScript& script, const Track& track)
+    {
+        script.text.clear();
+        const QString evalScript = evaluate(script.script, track);
+        if(!evalScript.isEmpty()) {
+            script.text = formatter.evaluate(evalScript);
+        }
+        return evalScript;
+    }
+};
+
+/*!
+ * The evaluated scripts of a track, ready to be merged into the playlist in order.
+ * Header and subheader rows are only kept when they differ from the previous track in the same chunk,
+ * as only the first track of each group needs them.
+ * Sizes aren't calculated until the rows are merged, as font metrics aren't safe to use from several threads.
+ */
+struct EvaluatedTrack
+{
+    Track track;
+    ItemKey headerKey{0};
+    std::optional<HeaderRow> header;
+    std::vector<QString> subheaderKeys;
+    std::vector<PlaylistContainerItem> subheaders;
+    std::optional<PlaylistTrackItem> item;
+};
+
+// Set on every track key and cleared on every container key, so the two can't clash
+constexpr ItemKey TrackKeyTag = ItemKey{1} << 63;
+
+ItemKey containerKey(ItemKey seed, ItemKey baseKey, int index)
+{
+    return qHashMulti(seed, baseKey, index) & ~TrackKeyTag;
+}
+
+/*!
+ * Track keys are exact rather than hashed: the index is unique within a run and,
+ * along with the track id, fits in the bits below the tag.
+ */
+ItemKey trackKey(ItemKey seed, int index, int trackId)
+{
+    const ItemKey position
+        = (static_cast<ItemKey>(static_cast<uint32_t>(index)) << 32) | static_cast<uint32_t>(trackId);
+    return TrackKeyTag | ((seed ^ position) & ~TrackKeyTag);
+}
+
+QString subheaderKey(const PlaylistContainerItem& subheader)
+{
+    QString key;
+    for(const auto& block : subheader.title().text) {
+        key += block.text;
+    }
+    for(const auto& block : subheader.subtitle().text) {
+        key += block.text;
+    }
+    return key;
+}
+
+void evaluateTrack(TrackEvaluator& evaluator, const PlaylistPreset& preset, const PlaylistColumnList& columns,
+                   int index, const EvaluatedTrack* prevTrack, EvaluatedTrack& result)
+{
+    const Track& track = result.track;
+    int depth{0};
+
+    evaluator.cache.clear();
+
+    HeaderRow header{preset.header};
+    if(header.isValid()) {
+        result.headerKey
+            = qHashMulti(0, evaluator.evaluate(header.title, track), evaluator.evaluate(header.subtitle, track),
+                         evaluator.evaluate(header.sideText, track), evaluator.evaluate(header.info, track));
+        if(!prevTrack || prevTrack->headerKey != result.headerKey) {
+            result.header = std::move(header);
+        }
+        ++depth;
+    }
+
+    for(SubheaderRow subheader : preset.subHeaders) {
+        subheader.leftText.text  = evaluator.formatter.evaluate(evaluator.evaluate(subheader.leftText.script, track));
+        subheader.rightText.text = evaluator.formatter.evaluate(evaluator.evaluate(subheader.rightText.script, track));
+
+        PlaylistContainerItem container{false};
+        container.setTitle(subheader.leftText);
+        container.setSubtitle(subheader.rightText);
+        container.setRowHeight(subheader.rowHeight);
+
+        QString key = subheaderKey(container);
+        if(!key.isEmpty()) {
+            ++depth;
+        }
+        result.subheaderKeys.push_back(std::move(key));
+        result.subheaders.push_back(std::move(container));
+    }
+
+    if(prevTrack && !result.header && prevTrack->subheaderKeys == result.subheaderKeys) {
+        // Same groups as the previous track
+        result.subheaders.clear();
+    }
+
+    if(!preset.track.isValid()) {
+        return;
+    }
+
+    evaluator.registry.setTrackProperties(index, depth);
+
+    TrackRow trackRow{preset.track};
+    PlaylistTrackItem playlistTrack;
+
+    if(!columns.empty()) {
+        for(const auto& column : columns) {
+            const auto evalScript = evaluator.evaluate(column.field, track);
+            trackRow.columns.emplace_back(column.field, evaluator.formatter.evaluate(evalScript));
+        }
+        playlistTrack = {trackRow.columns, track};
+    }
+    else {
+        evaluator.evaluate(trackRow.leftText, track);
+        evaluator.evaluate(trackRow.rightText, track);
+
+        playlistTrack = {trackRow.leftText, trackRow.rightText, track};
+    }
+
+    playlistTrack.setRowHeight(trackRow.rowHeight);
+
+    result.item = std::move(playlistTrack);
+}
+} // namespace
+
 struct PlaylistPopulator::Private
 {
     PlaylistPopulator* self;
@@ -40,24 +193,23 @@ struct PlaylistPopulator::Private
 
     PlaylistPreset currentPreset;
     PlaylistColumnList columns;
+    PlaybackQueue queue;
 
     std::unique_ptr<PlaylistScriptRegistry> registry;
     ScriptParser parser;
 
     ScriptFormatter formatter;
 
-    int trackDepth{0};
-    QString prevBaseHeaderKey;
-    QString prevHeaderKey;
-    std::vector<QString> prevBaseSubheaderKey;
-    std::vector<QString> prevSubheaderKey;
-
-    std::vector<PlaylistContainerItem> subheaders;
+    // Mixed into every item key; 0 for full runs so repopulating gives the same keys
+    ItemKey keySeed{0};
+    ItemKey prevBaseHeaderKey{0};
+    ItemKey prevHeaderKey{0};
+    std::vector<ItemKey> prevBaseSubheaderKey;
+    std::vector<ItemKey> prevSubheaderKey;
 
     PlaylistItem root;
     PendingData data;
     ContainerKeyMap headers;
-    TrackList pendingTracks;
 
     explicit Private(PlaylistPopulator* self_, PlayerController* playerController_)
         : self{self_}
@@ -70,15 +222,14 @@ struct PlaylistPopulator::Private
     {
         data.clear();
         headers.clear();
-        trackDepth = 0;
         prevBaseSubheaderKey.clear();
         prevSubheaderKey.clear();
-        prevBaseHeaderKey.clear();
-        prevHeaderKey.clear();
+        prevBaseHeaderKey = 0;
+        prevHeaderKey     = 0;
     }
 
-    PlaylistItem* getOrInsertItem(const QString& key, PlaylistItem::ItemType type, const Data& item,
-                                  PlaylistItem* parent, const QString& baseKey)
+    PlaylistItem* getOrInsertItem(ItemKey key, PlaylistItem::ItemType type, const Data& item, PlaylistItem* parent,
+                                  ItemKey baseKey)
     {
         auto [node, inserted] = data.items.try_emplace(key, PlaylistItem{type, item, parent});
         if(inserted) {
@@ -104,36 +255,67 @@ struct PlaylistPopulator::Private
         }
     }
 
-    void iterateHeader(const Track& track, PlaylistItem*& parent)
+    /*!
+     * Evaluates the scripts of @p tracks, starting at playlist index @p firstIndex.
+     * Tracks are split into contiguous chunks evaluated in parallel.
+     */
+    std::vector<EvaluatedTrack> evaluateTracks(std::span<const Track> tracks, int firstIndex)
     {
-        HeaderRow row{currentPreset.header};
-        if(!row.isValid()) {
-            return;
+        std::vector<EvaluatedTrack> results(tracks.size());
+        for(size_t i{0}; i < tracks.size(); ++i) {
+            results[i].track = tracks[i];
         }
 
-        auto evaluateBlocks = [this, track](RichScript& script) -> QString {
-            script.text.clear();
-            const auto evalScript = parser.evaluate(script.script, track);
-            if(!evalScript.isEmpty()) {
-                script.text = formatter.evaluate(evalScript);
+        const size_t threadCount = std::clamp(tracks.size() / MinTracksPerThread, size_t{1},
+                                              static_cast<size_t>(std::max(1, QThread::idealThreadCount())));
+        const size_t chunkSize   = (tracks.size() + threadCount - 1) / threadCount;
+
+        auto evaluateChunk = [this, &results, firstIndex](size_t begin, size_t end) {
+            TrackEvaluator evaluator{data.playlistId, queue};
+
+            for(size_t i{begin}; i < end; ++i) {
+                if(!self->mayRun()) {
+                    return;
+                }
+                evaluateTrack(evaluator, currentPreset, columns, firstIndex + static_cast<int>(i),
+                              i > begin ? &results[i - 1] : nullptr, results[i]);
             }
-            return evalScript;
         };
 
-        auto generateHeaderKey = [&row, &evaluateBlocks]() {
-            return Utils::generateHash(evaluateBlocks(row.title), evaluateBlocks(row.subtitle),
-                                       evaluateBlocks(row.sideText), evaluateBlocks(row.info));
-        };
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
 
-        const QString baseKey = generateHeaderKey();
-        QString key           = Utils::generateRandomHash();
-        if(!prevHeaderKey.isEmpty() && prevBaseHeaderKey == baseKey) {
-            key = prevHeaderKey;
+        for(size_t begin{chunkSize}; begin < tracks.size(); begin += chunkSize) {
+            threads.emplace_back(evaluateChunk, begin, std::min(begin + chunkSize, tracks.size()));
+        }
+
+        evaluateChunk(0, std::min(chunkSize, tracks.size()));
+
+        for(auto& thread : threads) {
+            thread.join();
+        }
+
+        return results;
+    }
+
+    void mergeHeader(const EvaluatedTrack& evaluated, int index, PlaylistItem*& parent)
+    {
+        if(!currentPreset.header.isValid()) {
+            return;
+        }
+
+        const ItemKey baseKey = evaluated.headerKey;
+        ItemKey key           = prevHeaderKey;
+        if(prevHeaderKey == 0 || prevBaseHeaderKey != baseKey) {
+            key = containerKey(keySeed, baseKey, index);
         }
         prevBaseHeaderKey = baseKey;
         prevHeaderKey     = key;
 
         if(!headers.contains(key)) {
+            // A new group always starts with a track which kept its header row
+            const HeaderRow& row = evaluated.header.value();
+
             PlaylistContainerItem header{currentPreset.header.simple};
             header.setTitle(row.title);
             header.setSubtitle(row.subtitle);
@@ -147,176 +329,119 @@ struct PlaylistPopulator::Private
             headers.emplace(key, &headerContainer);
         }
         PlaylistContainerItem* header = headers.at(key);
-        header->addTrack(track);
-        data.trackParents[track.id()].push_back(key);
+        header->addTrack(evaluated.track);
+        data.trackParents[evaluated.track.id()].push_back(key);
 
-        auto* headerItem = &data.items.at(key);
-        parent           = headerItem;
-        ++trackDepth;
+        parent = &data.items.at(key);
     }
 
-    void iterateSubheaders(const Track& track, PlaylistItem*& parent)
+    void mergeSubheaders(const EvaluatedTrack& evaluated, int index, PlaylistItem*& parent)
     {
-        for(auto& subheader : currentPreset.subHeaders) {
-            const auto leftScript    = parser.evaluate(subheader.leftText.script, track);
-            subheader.leftText.text  = formatter.evaluate(leftScript);
-            const auto rightScript   = parser.evaluate(subheader.rightText.script, track);
-            subheader.rightText.text = formatter.evaluate(rightScript);
-
-            PlaylistContainerItem currentContainer{false};
-            currentContainer.setTitle(subheader.leftText);
-            currentContainer.setSubtitle(subheader.rightText);
-            currentContainer.setRowHeight(subheader.rowHeight);
-            currentContainer.calculateSize();
-            subheaders.push_back(currentContainer);
-        }
-
-        const int subheaderCount = static_cast<int>(subheaders.size());
+        const size_t subheaderCount = evaluated.subheaderKeys.size();
         prevSubheaderKey.resize(subheaderCount);
         prevBaseSubheaderKey.resize(subheaderCount);
 
-        auto generateSubheaderKey = [](const PlaylistContainerItem& subheader) {
-            QString subheaderKey;
-            for(const auto& block : subheader.title().text) {
-                subheaderKey += block.text;
-            }
-            for(const auto& block : subheader.subtitle().text) {
-                subheaderKey += block.text;
-            }
-            return subheaderKey;
-        };
-
-        for(int i{0}; const auto& subheader : subheaders) {
-            const QString subheaderKey = generateSubheaderKey(subheader);
+        for(size_t subheaderIndex{0}, i{0}; subheaderIndex < subheaderCount; ++subheaderIndex) {
+            const QString& subheaderKey = evaluated.subheaderKeys.at(subheaderIndex);
 
             if(subheaderKey.isEmpty()) {
-                prevBaseSubheaderKey[i].clear();
-                prevSubheaderKey[i].clear();
+                prevBaseSubheaderKey[i] = 0;
+                prevSubheaderKey[i]     = 0;
                 continue;
             }
 
-            const QString baseKey = Utils::generateHash(parent->baseKey(), subheaderKey);
-            QString key           = Utils::generateRandomHash();
-            if(static_cast<int>(prevSubheaderKey.size()) > i && prevBaseSubheaderKey.at(i) == baseKey) {
-                key = prevSubheaderKey.at(i);
+            const ItemKey baseKey = qHashMulti(parent->baseKey(), subheaderKey);
+            ItemKey key           = prevSubheaderKey.at(i);
+            if(prevBaseSubheaderKey.at(i) != baseKey) {
+                key = containerKey(keySeed, baseKey, index);
             }
             prevBaseSubheaderKey[i] = baseKey;
             prevSubheaderKey[i]     = key;
 
             if(!headers.contains(key)) {
+                // As with headers, only the first track of a group is needed
+                const auto& subheader    = evaluated.subheaders.at(subheaderIndex);
                 auto* subheaderItem      = getOrInsertItem(key, PlaylistItem::Subheader, subheader, parent, baseKey);
                 auto& subheaderContainer = std::get<1>(subheaderItem->data());
+                subheaderContainer.calculateSize();
                 headers.emplace(key, &subheaderContainer);
             }
             PlaylistContainerItem* subheaderContainer = headers.at(key);
-            subheaderContainer->addTrack(track);
-            data.trackParents[track.id()].push_back(key);
+            subheaderContainer->addTrack(evaluated.track);
+            data.trackParents[evaluated.track.id()].push_back(key);
 
-            auto* subheaderItem = &data.items.at(key);
-            parent              = subheaderItem;
+            parent = &data.items.at(key);
             ++i;
-            ++trackDepth;
         }
-        subheaders.clear();
     }
 
-    PlaylistItem* iterateTrack(const Track& track, int index)
+    PlaylistItem* mergeTrack(const EvaluatedTrack& evaluated, int index)
     {
         PlaylistItem* parent = &root;
 
-        iterateHeader(track, parent);
-        iterateSubheaders(track, parent);
+        mergeHeader(evaluated, index, parent);
+        mergeSubheaders(evaluated, index, parent);
 
-        if(!currentPreset.track.isValid()) {
+        if(!evaluated.item) {
             return nullptr;
         }
 
-        auto evaluateTrack = [this, &track](RichScript& script) {
-            script.text.clear();
-            const auto evalScript = parser.evaluate(script.script, track);
-            if(!evalScript.isEmpty()) {
-                script.text = formatter.evaluate(evalScript);
-            }
-        };
-
-        registry->setTrackProperties(index, trackDepth);
-
-        TrackRow trackRow{currentPreset.track};
-        PlaylistTrackItem playlistTrack;
-
-        if(!columns.empty()) {
-            for(const auto& column : columns) {
-                const auto evalScript = parser.evaluate(column.field, track);
-                trackRow.columns.emplace_back(column.field, formatter.evaluate(evalScript));
-            }
-            playlistTrack = {trackRow.columns, track};
-        }
-        else {
-            evaluateTrack(trackRow.leftText);
-            evaluateTrack(trackRow.rightText);
-
-            playlistTrack = {trackRow.leftText, trackRow.rightText, track};
-        }
-
-        playlistTrack.setRowHeight(trackRow.rowHeight);
-        playlistTrack.calculateSize();
-
-        const QString baseKey = Utils::generateHash(parent->key(), track.hash(), QString::number(index));
-        const QString key     = Utils::generateRandomHash();
+        const Track& track    = evaluated.track;
+        const ItemKey baseKey = qHashMulti(parent->key(), track.hash(), index);
+        const ItemKey key     = trackKey(keySeed, index, track.id());
 
-        auto* trackItem = getOrInsertItem(key, PlaylistItem::Track, playlistTrack, parent, baseKey);
+        auto* trackItem = getOrInsertItem(key, PlaylistItem::Track, evaluated.item.value(), parent, baseKey);
+        std::get<0>(trackItem->data()).calculateSize();
         data.trackParents[track.id()].push_back(key);
 
-        trackDepth = 0;
         return trackItem;
     }
 
-    void runBatch(int size, int index)
+    void runBatch(const TrackList& tracks)
     {
-        if(size <= 0) {
-            return;
-        }
+        const std::span<const Track> allTracks{tracks};
 
-        auto tracksBatch = std::ranges::views::take(pendingTracks, size);
+        // The first tracks are populated on their own so they can be shown as soon as possible
+        size_t start{0};
+        do {
+            const size_t count = start == 0 ? std::min(TrackPreloadSize, allTracks.size()) : allTracks.size() - start;
+            const auto evaluatedTracks = evaluateTracks(allTracks.subspan(start, count), static_cast<int>(start));
 
-        for(const Track& track : tracksBatch) {
             if(!self->mayRun()) {
                 return;
             }
-            iterateTrack(track, index++);
-        }
 
-        updateContainers();
-
-        if(!self->mayRun()) {
-            return;
-        }
+            for(size_t i{0}; i < evaluatedTracks.size(); ++i) {
+                mergeTrack(evaluatedTracks.at(i), static_cast<int>(start + i));
+            }
 
-        emit self->populated(data);
+            updateContainers();
 
-        auto tracksToKeep = std::ranges::views::drop(pendingTracks, size);
-        TrackList tempTracks;
-        std::ranges::copy(tracksToKeep, std::back_inserter(tempTracks));
-        pendingTracks = std::move(tempTracks);
+            if(!self->mayRun()) {
+                return;
+            }
 
-        data.nodes.clear();
+            emit self->populated(data);
 
-        const auto remaining = static_cast<int>(pendingTracks.size());
-        runBatch(remaining, index);
+            data.nodes.clear();
+            start += count;
+        } while(start < allTracks.size());
     }
 
     void runTracksGroup(const std::map<int, TrackList>& tracks)
     {
         for(const auto& [index, trackGroup] : tracks) {
-            std::vector<QString> trackKeys;
+            const auto evaluatedTracks = evaluateTracks(trackGroup, index);
 
-            int trackIndex{index};
+            if(!self->mayRun()) {
+                return;
+            }
 
-            for(const Track& track : trackGroup) {
-                if(!self->mayRun()) {
-                    return;
-                }
-                if(const auto* trackItem = iterateTrack(track, trackIndex++)) {
+            std::vector<ItemKey> trackKeys;
+
+            int trackIndex{index};
+            for(const auto& evaluated : evaluatedTracks) {
+                if(const auto* trackItem = mergeTrack(evaluated, trackIndex++)) {
                     trackKeys.push_back(trackItem->key());
                 }
             }
@@ -350,10 +475,11 @@ void PlaylistPopulator::run(const Id& playlistId, const PlaylistPreset& preset,
     p->data.playlistId = playlistId;
     p->currentPreset   = preset;
     p->columns         = columns;
-    p->pendingTracks   = tracks;
-    p->registry->setup(playlistId, p->playerController->playbackQueue());
+    p->queue           = p->playerController->playbackQueue();
+    p->keySeed         = 0;
+    p->registry->setup(playlistId, p->queue);
 
-    p->runBatch(TrackPreloadSize, 0);
+    p->runBatch(tracks);
 
     emit finished();
 
@@ -370,7 +496,10 @@ void PlaylistPopulator::runTracks(const Id& playlistId, const PlaylistPreset& pr
     p->data.playlistId = playlistId;
     p->currentPreset   = preset;
     p->columns         = columns;
-    p->registry->setup(playlistId, p->playerController->playbackQueue());
+    p->queue           = p->playerController->playbackQueue();
+    // Inserted items must not clash with those already in the model
+    p->keySeed = QRandomGenerator::global()->generate64();
+    p->registry->setup(playlistId, p->queue);
 
     p->runTracksGroup(tracks);
 
@@ -32,21 +32,21 @@ class PlayerController;
 struct PlaylistPreset;
 
 using ItemList        = std::vector<PlaylistItem>;
-using ItemKeyMap      = std::unordered_map<QString, PlaylistItem>;
-using ContainerKeyMap = std::unordered_map<QString, PlaylistContainerItem*>;
-using NodeKeyMap      = std::unordered_map<QString, std::vector<QString>>;
-using TrackIdNodeMap  = std::unordered_map<int, std::vector<QString>>;
-using IndexGroupMap   = std::map<int, std::vector<QString>>;
+using ItemKeyMap      = std::unordered_map<ItemKey, PlaylistItem>;
+using ContainerKeyMap = std::unordered_map<ItemKey, PlaylistContainerItem*>;
+using NodeKeyMap      = std::unordered_map<ItemKey, std::vector<ItemKey>>;
+using TrackIdNodeMap  = std::unordered_map<int, std::vector<ItemKey>>;
+using IndexGroupMap   = std::map<int, std::vector<ItemKey>>;
 
 struct PendingData
 {
     Id playlistId;
     ItemKeyMap items;
     NodeKeyMap nodes;
-    std::vector<QString> containerOrder;
+    std::vector<ItemKey> containerOrder;
     TrackIdNodeMap trackParents;
 
-    QString parent;
+    ItemKey parent{0};
     int row{-1};
 
     IndexGroupMap indexNodes;
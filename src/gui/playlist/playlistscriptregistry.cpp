@@ -145,4 +145,14 @@ ScriptResult PlaylistScriptRegistry::value(const QString& var, const Track& trac
 
     return ScriptRegistry::value(var, track);
 }
+
+ScriptRegistry::ResolvedVariable PlaylistScriptRegistry::resolveVariable(const QString& var) const
+{
+    // Depends on the current track properties, so must be looked up each time
+    if(p->vars.contains(var)) {
+        return {};
+    }
+
+    return ScriptRegistry::resolveVariable(var);
+}
 } // namespace Fooyin
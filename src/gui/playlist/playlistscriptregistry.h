@@ -44,6 +44,8 @@ public:
     bool isVariable(const QString& var, const Track& track) const override;
     ScriptResult value(const QString& var, const Track& track) const override;
 
+    ResolvedVariable resolveVariable(const QString& var) const override;
+
 private:
     struct Private;
     std::unique_ptr<Private> p;
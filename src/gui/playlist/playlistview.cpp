@@ -22,6 +22,7 @@
 #include "playlistitem.h"
 #include "playlistmodel.h"
 
+#include <utils/fenwicktree.h>
 #include <utils/widgets/autoheaderview.h>
 
 #include <QDrag>
@@ -122,9 +123,18 @@ public:
     int indexWidthHint(const QModelIndex& index, int hint, const QStyleOptionViewItem& option) const;
     int itemHeight(int item) const;
     int itemPadding(int item) const;
+    int estimatedItemHeight(int item) const;
+    void updateItemHeights() const;
+    int itemAtContentsCoordinate(int coordinate) const;
     int coordinateForItem(int item) const;
     void insertViewItems(int pos, int count, const PlaylistViewItem& viewItem);
+    void insertViewItems(int pos, const std::vector<PlaylistViewItem>& viewItems);
+    bool appendViewItems(const QModelIndex& parent, int parentItem, int first, int last, int start,
+                         std::vector<PlaylistViewItem>& viewItems) const;
+    bool insertItems(const QModelIndex& parent, int parentItem, int first, int last);
     bool hasVisibleChildren(const QModelIndex& parent) const;
+    int spanningHeight() const;
+    void updatePadding(PlaylistViewItem& item, int spanHeight, int& rowHeight) const;
     void recalculatePadding();
     void layout(int i, bool afterIsUninitialised = false);
     bool isIndexEnabled(const QModelIndex& index) const;
@@ -181,6 +191,11 @@ public:
     bool m_playlistLoaded{false};
 
     mutable std::vector<PlaylistViewItem> m_viewItems;
+    // Height and padding of each view item, with rows not yet measured estimated
+    mutable FenwickTree<int> m_itemHeights;
+    mutable int m_estimatedHeaderHeight{0};
+    mutable int m_estimatedTrackHeight{0};
+    mutable int m_contentsHeight{0};
     mutable int m_lastViewedItem{0};
     int m_defaultItemHeight{20};
 
@@ -255,12 +270,9 @@ void PlaylistView::Private::updateScrollBars() const
 
     auto* verticalBar = m_self->verticalScrollBar();
 
-    int contentsHeight{0};
-    for(int i{0}; i < itemCount; ++i) {
-        contentsHeight += itemHeight(i) + itemPadding(i);
-    }
+    m_contentsHeight = m_itemHeights.total();
 
-    verticalBar->setRange(0, contentsHeight - viewportSize.height());
+    verticalBar->setRange(0, m_contentsHeight - viewportSize.height());
     verticalBar->setPageStep(viewportSize.height());
     verticalBar->setSingleStep(std::max(viewportSize.height() / (itemsInViewport + 1), 2));
 
@@ -304,21 +316,17 @@ int PlaylistView::Private::itemAtCoordinate(int coordinate, bool includePadding)
 
     const int contentsCoord = coordinate + m_self->verticalScrollBar()->value();
 
-    int itemCoord{0};
-    for(int index{0}; index < itemCount; ++index) {
-        const int height  = itemHeight(index);
-        const int padding = itemPadding(index);
-        itemCoord += height + padding;
+    const int index = itemAtContentsCoordinate(contentsCoord);
+    if(index < 0) {
+        return -1;
+    }
 
-        if(itemCoord > contentsCoord) {
-            if(includePadding && (itemCoord - padding) < contentsCoord) {
-                return -1;
-            }
-            return index >= itemCount ? -1 : index;
-        }
+    const int itemCoord = m_itemHeights.prefixSum(index + 1);
+    if(includePadding && (itemCoord - itemPadding(index)) < contentsCoord) {
+        return -1;
     }
 
-    return -1;
+    return index;
 }
 
 QModelIndex PlaylistView::Private::modelIndex(int i, int column) const
@@ -583,10 +591,18 @@ int PlaylistView::Private::itemHeight(int item) const
         return 0;
     }
 
-    int height = m_viewItems.at(item).height;
+    auto& viewItem = m_viewItems[item];
+    int height     = viewItem.height;
     if(height <= 0) {
-        height                   = indexRowSizeHint(index);
-        m_viewItems[item].height = height;
+        height          = indexRowSizeHint(index);
+        viewItem.height = height;
+
+        if(height > 0) {
+            (viewItem.hasChildren ? m_estimatedHeaderHeight : m_estimatedTrackHeight) = height;
+        }
+        if(item < m_itemHeights.size()) {
+            m_itemHeights.set(item, std::max(height, 0) + viewItem.padding);
+        }
     }
 
     return std::max(height, 0);
@@ -601,22 +617,65 @@ int PlaylistView::Private::itemPadding(int item) const
     return m_viewItems.at(item).padding;
 }
 
-int PlaylistView::Private::coordinateForItem(int item) const
+int PlaylistView::Private::estimatedItemHeight(int item) const
+{
+    const auto& viewItem = m_viewItems.at(item);
+    if(viewItem.height > 0) {
+        return viewItem.height;
+    }
+
+    // Rows are only measured once visited, so assume they match the last measured row of the same kind
+    const int estimate = viewItem.hasChildren ? m_estimatedHeaderHeight : m_estimatedTrackHeight;
+    return estimate > 0 ? estimate : m_defaultItemHeight;
+}
+
+void PlaylistView::Private::updateItemHeights() const
+{
+    std::vector<int> heights(m_viewItems.size());
+    for(int item{0}; item < itemCount(); ++item) {
+        heights[item] = estimatedItemHeight(item) + m_viewItems.at(item).padding;
+    }
+    m_itemHeights.assign(std::move(heights));
+}
+
+int PlaylistView::Private::itemAtContentsCoordinate(int coordinate) const
 {
-    for(int index{0}, y{0}; const auto& viewItem : m_viewItems) {
-        if(index == item) {
-            return y - m_self->verticalScrollBar()->value();
+    const int count = std::min(m_itemHeights.size(), itemCount());
+
+    int item = m_itemHeights.upperBound(coordinate);
+    while(item < count) {
+        // Measuring an estimated row may move the coordinate into a later one.
+        // The entry is always made exact (only padding for rows which can't be measured),
+        // so if the row doesn't cover the coordinate the next search starts after it.
+        m_itemHeights.set(item, itemHeight(item) + itemPadding(item));
+        if(m_itemHeights.prefixSum(item + 1) > coordinate) {
+            return item;
         }
-        y += itemHeight(index++) + viewItem.padding;
+        item = m_itemHeights.upperBound(coordinate);
+    }
+
+    return -1;
+}
+
+int PlaylistView::Private::coordinateForItem(int item) const
+{
+    if(item < 0 || item >= m_itemHeights.size()) {
+        return 0;
     }
 
-    return 0;
+    return m_itemHeights.prefixSum(item) - m_self->verticalScrollBar()->value();
 }
 
 void PlaylistView::Private::insertViewItems(int pos, int count, const PlaylistViewItem& viewItem)
 {
-    m_viewItems.insert(m_viewItems.begin() + pos, count, viewItem);
+    insertViewItems(pos, std::vector<PlaylistViewItem>(count, viewItem));
+}
+
+void PlaylistView::Private::insertViewItems(int pos, const std::vector<PlaylistViewItem>& viewItems)
+{
+    m_viewItems.insert(m_viewItems.begin() + pos, viewItems.cbegin(), viewItems.cend());
 
+    const auto count    = static_cast<int>(viewItems.size());
     const int itemCount = this->itemCount();
     for(int i{pos + count}; i < itemCount; i++) {
         if(m_viewItems.at(i).parentItem >= pos) {
@@ -625,6 +684,109 @@ void PlaylistView::Private::insertViewItems(int pos, int count, const PlaylistVi
     }
 }
 
+/*!
+ * Appends view items for rows @p first to @p last of @p parent, and all of their children,
+ * to @p viewItems, as though @p viewItems will be inserted at view index @p start.
+ * Returns false if a row still has children to fetch, which only a full layout handles.
+ */
+bool PlaylistView::Private::appendViewItems(const QModelIndex& parent, int parentItem, int first, int last, int start,
+                                            std::vector<PlaylistViewItem>& viewItems) const
+{
+    const int rowCount = m_model->rowCount(parent);
+
+    for(int row{first}; row <= last; ++row) {
+        const auto item = static_cast<int>(viewItems.size());
+
+        PlaylistViewItem& viewItem = viewItems.emplace_back();
+        viewItem.index             = m_model->index(row, 0, parent);
+        viewItem.parentItem        = parentItem;
+        viewItem.hasMoreSiblings   = row < rowCount - 1;
+        viewItem.hasChildren       = m_model->hasChildren(viewItem.index);
+
+        if(viewItem.hasChildren) {
+            const QModelIndex index = viewItem.index;
+            if(m_model->canFetchMore(index)) {
+                return false;
+            }
+
+            const int childCount = m_model->rowCount(index);
+            if(childCount > 0 && !appendViewItems(index, start + item, 0, childCount - 1, start, viewItems)) {
+                return false;
+            }
+            viewItems[item].childCount = static_cast<int>(viewItems.size()) - item - 1;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * Inserts view items for rows @p first to @p last of @p parent without laying out the other rows.
+ * Only the rows after the insertion under the same parent are revisited, to update their indexes.
+ * Returns false if the rows can't be inserted in place, in which case a full layout is needed.
+ */
+bool PlaylistView::Private::insertItems(const QModelIndex& parent, int parentItem, int first, int last)
+{
+    if(m_layingOutItems || m_viewItems.empty() || m_model->canFetchMore(parent)) {
+        return false;
+    }
+
+    int pos{parentItem + 1};
+    int prevItem{-1};
+    if(first > 0) {
+        prevItem = viewIndex(m_model->index(first - 1, 0, parent));
+        if(prevItem < 0) {
+            return false;
+        }
+        pos = prevItem + m_viewItems.at(prevItem).childCount + 1;
+    }
+
+    std::vector<PlaylistViewItem> viewItems;
+    if(!appendViewItems(parent, parentItem, first, last, pos, viewItems)) {
+        return false;
+    }
+
+    const auto count = static_cast<int>(viewItems.size());
+    insertViewItems(pos, viewItems);
+
+    if(parentItem >= 0) {
+        m_viewItems[parentItem].hasChildren = true;
+        m_viewItems[parentItem].padding     = 0;
+    }
+    for(int i{parentItem}; i > -1; i = m_viewItems.at(i).parentItem) {
+        m_viewItems[i].childCount += count;
+    }
+    if(m_lastViewedItem >= pos) {
+        m_lastViewedItem += count;
+    }
+
+    const int spanHeight = spanningHeight();
+    int rowHeight{0};
+
+    if(prevItem >= 0) {
+        m_viewItems[prevItem].hasMoreSiblings = true;
+        updatePadding(m_viewItems[prevItem], spanHeight, rowHeight);
+    }
+    for(int i{pos}; i < pos + count; ++i) {
+        updatePadding(m_viewItems[i], spanHeight, rowHeight);
+    }
+
+    // The rows after the inserted ones have moved down
+    const int rowCount = m_model->rowCount(parent);
+    for(int row{last + 1}, item{pos + count}; row < rowCount && item < itemCount(); ++row) {
+        PlaylistViewItem& viewItem = m_viewItems[item];
+        viewItem.index             = m_model->index(row, 0, parent);
+        if(row == rowCount - 1) {
+            updatePadding(viewItem, spanHeight, rowHeight);
+        }
+        item += viewItem.childCount + 1;
+    }
+
+    updateItemHeights();
+
+    return true;
+}
+
 bool PlaylistView::Private::hasVisibleChildren(const QModelIndex& parent) const
 {
     if(parent.flags() & Qt::ItemNeverHasChildren) {
@@ -634,12 +796,8 @@ bool PlaylistView::Private::hasVisibleChildren(const QModelIndex& parent) const
     return m_model->hasChildren(parent);
 }
 
-void PlaylistView::Private::recalculatePadding()
+int PlaylistView::Private::spanningHeight() const
 {
-    if(m_viewItems.empty()) {
-        return;
-    }
-
     int max{0};
 
     const int sectionCount = m_header->count();
@@ -652,28 +810,43 @@ void PlaylistView::Private::recalculatePadding()
         }
     }
 
-    int rowHeight{0};
+    return max;
+}
 
-    for(auto& item : m_viewItems) {
-        item.padding = 0;
+void PlaylistView::Private::updatePadding(PlaylistViewItem& item, int spanHeight, int& rowHeight) const
+{
+    item.padding = 0;
 
-        if(item.hasChildren) {
-            continue;
+    if(item.hasChildren) {
+        return;
+    }
+
+    const QModelIndex parent = modelIndex(item.parentItem);
+    const int rowCount       = m_model->rowCount(parent);
+    const int row            = item.index.row();
+
+    if(row == rowCount - 1) {
+        if(rowHeight == 0) {
+            // Assume all track rows have the same height
+            rowHeight = indexRowSizeHint(item.index);
         }
 
-        const QModelIndex parent = modelIndex(item.parentItem);
-        const int rowCount       = m_model->rowCount(parent);
-        const int row            = item.index.row();
+        const int sectionHeight = rowCount * rowHeight;
+        item.padding            = (spanHeight > sectionHeight) ? spanHeight - sectionHeight : 0;
+    }
+}
 
-        if(row == rowCount - 1) {
-            if(rowHeight == 0) {
-                // Assume all track rows have the same height
-                rowHeight = indexRowSizeHint(item.index);
-            }
+void PlaylistView::Private::recalculatePadding()
+{
+    if(m_viewItems.empty()) {
+        return;
+    }
 
-            const int sectionHeight = rowCount * rowHeight;
-            item.padding            = (max > sectionHeight) ? max - sectionHeight : 0;
-        }
+    const int spanHeight = spanningHeight();
+    int rowHeight{0};
+
+    for(auto& item : m_viewItems) {
+        updatePadding(item, spanHeight, rowHeight);
     }
 }
 
@@ -793,6 +966,10 @@ int PlaylistView::Private::itemBelow(int item) const
 void PlaylistView::Private::invalidateHeightCache(int item) const
 {
     m_viewItems[item].height = 0;
+
+    if(item < m_itemHeights.size()) {
+        m_itemHeights.set(item, estimatedItemHeight(item) + m_viewItems.at(item).padding);
+    }
 }
 
 int PlaylistView::Private::pageUp(int i) const
@@ -1325,6 +1502,11 @@ void PlaylistView::Private::drawTree(QPainter* painter, const QRegion& region) c
             paintAlternatingRowColors(painter, &opt, y, area.bottom());
         }
     }
+
+    if(m_itemHeights.total() != m_contentsHeight) {
+        // Rows measured while painting changed the height of the contents
+        QMetaObject::invokeMethod(m_self, [this]() { updateScrollBars(); }, Qt::QueuedConnection);
+    }
 }
 
 void PlaylistView::Private::drawRow(QPainter* painter, const QStyleOptionViewItem& option,
@@ -1590,18 +1772,11 @@ int PlaylistView::Private::firstVisibleItem(int* offset) const
 {
     const int value = m_self->verticalScrollBar()->value();
 
-    int y{0};
-    for(int i{0}; i < itemCount(); ++i) {
-        const int itemHeight = this->itemHeight(i) + itemPadding(i);
-        y += itemHeight;
-        if(y > value) {
-            if(offset) {
-                *offset = y - value - itemHeight;
-            }
-            return i;
-        }
+    const int item = itemAtContentsCoordinate(value);
+    if(item >= 0 && offset) {
+        *offset = m_itemHeights.prefixSum(item) - value;
     }
-    return -1;
+    return item;
 }
 
 int PlaylistView::Private::lastVisibleItem(int firstVisual, int offset) const
@@ -1731,8 +1906,8 @@ int PlaylistView::sizeHintForColumn(int column) const
 
     QStyleOptionViewItem option;
     initViewItemOption(&option);
-    const auto viewItems = p->m_viewItems;
-    const int itemCount  = p->itemCount();
+    const auto& viewItems = p->m_viewItems;
+    const int itemCount   = p->itemCount();
 
     const int maximumProcessRows = p->m_header->resizeContentsPrecision();
 
@@ -1957,10 +2132,12 @@ void PlaylistView::doItemsLayout()
 
     p->m_layingOutItems = true;
     p->m_viewItems.clear();
+    p->m_itemHeights.clear();
 
     if(p->m_model && p->m_model->hasChildren(rootIndex())) {
         p->layout(-1);
         p->recalculatePadding();
+        p->updateItemHeights();
     }
 
     QAbstractItemView::doItemsLayout();
@@ -2271,6 +2448,7 @@ void PlaylistView::timerEvent(QTimerEvent* event)
         killTimer(p->m_columnResizeTimerId);
         p->m_columnResizeTimerId = 0;
         p->recalculatePadding();
+        p->updateItemHeights();
         updateGeometries();
         viewport()->update();
     }
@@ -2322,7 +2500,13 @@ void PlaylistView::rowsInserted(const QModelIndex& parent, int start, int end)
     const int parentItem     = p->viewIndex(parent);
 
     if(parentItem != -1 || parent == rootIndex()) {
-        p->doDelayedItemsLayout();
+        if(p->insertItems(parent, parentItem, start, end)) {
+            updateGeometries();
+            viewport()->update();
+        }
+        else {
+            p->doDelayedItemsLayout();
+        }
     }
     else if(parentItem != -1 && parentRowCount == delta) {
         p->m_viewItems[parentItem].hasChildren = true;
@@ -2335,6 +2519,7 @@ void PlaylistView::rowsInserted(const QModelIndex& parent, int start, int end)
 void PlaylistView::rowsRemoved(const QModelIndex& /*parent*/, int /*first*/, int /*last*/)
 {
     p->m_viewItems.clear();
+    p->m_itemHeights.clear();
     p->doDelayedItemsLayout();
 
     setState(QAbstractItemView::NoState);
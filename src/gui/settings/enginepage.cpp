@@ -20,6 +20,7 @@
 #include "enginepage.h"
 
 #include <core/coresettings.h>
+#include <core/engine/audioengine.h>
 #include <core/engine/enginehandler.h>
 #include <gui/guiconstants.h>
 #include <utils/expandingcombobox.h>
@@ -27,6 +28,7 @@
 
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QGridLayout>
 #include <QGroupBox>
 #include <QLabel>
@@ -56,7 +58,12 @@ private:
     ExpandingComboBox* m_deviceBox;
 
     QCheckBox* m_gaplessPlayback;
+    QSpinBox* m_preloadTime;
     QSpinBox* m_bufferSize;
+
+    QComboBox* m_replayGainType;
+    QDoubleSpinBox* m_replayGainPreAmp;
+    QCheckBox* m_preventClipping;
 };
 
 EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController* engine)
@@ -65,7 +72,11 @@ EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController*
     , m_outputBox{new ExpandingComboBox(this)}
     , m_deviceBox{new ExpandingComboBox(this)}
     , m_gaplessPlayback{new QCheckBox(tr("Gapless Playback"), this)}
+    , m_preloadTime{new QSpinBox(this)}
     , m_bufferSize{new QSpinBox(this)}
+    , m_replayGainType{new QComboBox(this)}
+    , m_replayGainPreAmp{new QDoubleSpinBox(this)}
+    , m_preventClipping{new QCheckBox(tr("Prevent clipping"), this)}
 {
     auto* outputLabel = new QLabel(tr("Output") + QStringLiteral(":"), this);
     auto* deviceLabel = new QLabel(tr("Device") + QStringLiteral(":"), this);
@@ -78,6 +89,17 @@ EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController*
 
     generalLayout->addWidget(m_gaplessPlayback, 0, 0, 1, 3);
 
+    auto* preloadLabel = new QLabel(tr("Preload next track") + QStringLiteral(":"), this);
+    preloadLabel->setToolTip(tr("How long before the end of the current track to open the next track"));
+
+    m_preloadTime->setSuffix(QStringLiteral(" ms"));
+    m_preloadTime->setSingleStep(500);
+    m_preloadTime->setMinimum(0);
+    m_preloadTime->setMaximum(30000);
+
+    generalLayout->addWidget(preloadLabel, 1, 0);
+    generalLayout->addWidget(m_preloadTime, 1, 1);
+
     auto* bufferLabel = new QLabel(tr("Buffer length") + QStringLiteral(":"), this);
 
     m_bufferSize->setSuffix(QStringLiteral(" ms"));
@@ -85,20 +107,46 @@ EnginePageWidget::EnginePageWidget(SettingsManager* settings, EngineController*
     m_bufferSize->setMinimum(50);
     m_bufferSize->setMaximum(30000);
 
-    generalLayout->addWidget(bufferLabel, 1, 0);
-    generalLayout->addWidget(m_bufferSize, 1, 1);
+    generalLayout->addWidget(bufferLabel, 2, 0);
+    generalLayout->addWidget(m_bufferSize, 2, 1);
 
     generalLayout->setColumnStretch(2, 1);
 
+    auto* replayGainBox    = new QGroupBox(tr("ReplayGain"), this);
+    auto* replayGainLayout = new QGridLayout(replayGainBox);
+
+    auto* typeLabel   = new QLabel(tr("Mode") + QStringLiteral(":"), this);
+    auto* preAmpLabel = new QLabel(tr("Pre-amplification") + QStringLiteral(":"), this);
+
+    m_replayGainType->addItem(tr("Disabled"), static_cast<int>(ReplayGainType::Disabled));
+    m_replayGainType->addItem(tr("Track gain"), static_cast<int>(ReplayGainType::Track));
+    m_replayGainType->addItem(tr("Album gain"), static_cast<int>(ReplayGainType::Album));
+
+    m_replayGainPreAmp->setSuffix(QStringLiteral(" dB"));
+    m_replayGainPreAmp->setSingleStep(0.5);
+    m_replayGainPreAmp->setMinimum(-20.0);
+    m_replayGainPreAmp->setMaximum(20.0);
+
+    m_preventClipping->setToolTip(tr("Reduce the gain of tracks whose peak would otherwise exceed full scale"));
+
+    replayGainLayout->addWidget(typeLabel, 0, 0);
+    replayGainLayout->addWidget(m_replayGainType, 0, 1);
+    replayGainLayout->addWidget(preAmpLabel, 1, 0);
+    replayGainLayout->addWidget(m_replayGainPreAmp, 1, 1);
+    replayGainLayout->addWidget(m_preventClipping, 2, 0, 1, 3);
+
+    replayGainLayout->setColumnStretch(2, 1);
+
     auto* mainLayout = new QGridLayout(this);
     mainLayout->addWidget(outputLabel, 0, 0);
     mainLayout->addWidget(m_outputBox, 0, 1);
     mainLayout->addWidget(deviceLabel, 1, 0);
     mainLayout->addWidget(m_deviceBox, 1, 1);
     mainLayout->addWidget(generalBox, 2, 0, 1, 2);
+    mainLayout->addWidget(replayGainBox, 3, 0, 1, 2);
 
     mainLayout->setColumnStretch(1, 1);
-    mainLayout->setRowStretch(3, 1);
+    mainLayout->setRowStretch(4, 1);
 
     QObject::connect(m_outputBox, &QComboBox::currentTextChanged, this, &EnginePageWidget::setupDevices);
 }
@@ -108,7 +156,13 @@ void EnginePageWidget::load()
     setupOutputs();
     setupDevices(m_outputBox->currentText());
     m_gaplessPlayback->setChecked(m_settings->value<Settings::Core::GaplessPlayback>());
+    m_preloadTime->setValue(m_settings->value<Settings::Core::PreloadTime>());
     m_bufferSize->setValue(m_settings->value<Settings::Core::BufferLength>());
+
+    m_replayGainType->setCurrentIndex(
+        m_replayGainType->findData(m_settings->value<Settings::Core::ReplayGainMode>()));
+    m_replayGainPreAmp->setValue(m_settings->value<Settings::Core::ReplayGainPreAmp>());
+    m_preventClipping->setChecked(m_settings->value<Settings::Core::ReplayGainNoClip>());
 }
 
 void EnginePageWidget::apply()
@@ -116,14 +170,22 @@ void EnginePageWidget::apply()
     const QString output = m_outputBox->currentText() + QStringLiteral("|") + m_deviceBox->currentData().toString();
     m_settings->set<Settings::Core::AudioOutput>(output);
     m_settings->set<Settings::Core::GaplessPlayback>(m_gaplessPlayback->isChecked());
+    m_settings->set<Settings::Core::PreloadTime>(m_preloadTime->value());
     m_settings->set<Settings::Core::BufferLength>(m_bufferSize->value());
+    m_settings->set<Settings::Core::ReplayGainMode>(m_replayGainType->currentData().toInt());
+    m_settings->set<Settings::Core::ReplayGainPreAmp>(m_replayGainPreAmp->value());
+    m_settings->set<Settings::Core::ReplayGainNoClip>(m_preventClipping->isChecked());
 }
 
 void EnginePageWidget::reset()
 {
     m_settings->reset<Settings::Core::AudioOutput>();
     m_settings->reset<Settings::Core::GaplessPlayback>();
+    m_settings->reset<Settings::Core::PreloadTime>();
     m_settings->reset<Settings::Core::BufferLength>();
+    m_settings->reset<Settings::Core::ReplayGainMode>();
+    m_settings->reset<Settings::Core::ReplayGainPreAmp>();
+    m_settings->reset<Settings::Core::ReplayGainNoClip>();
 }
 
 void EnginePageWidget::setupOutputs()
@@ -104,9 +104,7 @@ struct PipeWireOutput::Private
     bool pendingVolumeChange{false};
 
     AudioFormat format;
-
-    AudioBuffer buffer;
-    uint32_t bufferPos{0};
+    AudioSource source;
 
     std::unique_ptr<PipewireThreadLoop> loop;
     std::unique_ptr<PipewireContext> context;
@@ -144,9 +142,6 @@ struct PipeWireOutput::Private
         if(registry) {
             registry.reset(nullptr);
         }
-
-        buffer.clear();
-        bufferPos = 0;
     }
 
     bool initCore()
@@ -237,11 +232,6 @@ struct PipeWireOutput::Private
     {
         auto* self = static_cast<PipeWireOutput::Private*>(userData);
 
-        if(!self->bufferPos) {
-            self->loop->signal(false);
-            return;
-        }
-
         auto* pwBuffer = self->stream->dequeueBuffer();
         if(!pwBuffer) {
             qWarning() << "PW: No available output buffers";
@@ -249,17 +239,33 @@ struct PipeWireOutput::Private
         }
 
         const spa_data& data = pwBuffer->buffer->datas[0];
+        if(!data.data) {
+            self->stream->queueBuffer(pwBuffer);
+            return;
+        }
 
-        const auto size = std::min(data.maxsize, self->bufferPos);
-        auto* dst       = data.data;
+        const int stride = self->format.bytesPerFrame();
+        auto frames = static_cast<int>(std::min(data.maxsize, static_cast<uint32_t>(self->stream->bufferSize())))
+                    / stride;
+#if PW_CHECK_VERSION(0, 3, 49)
+        if(pwBuffer->requested > 0) {
+            frames = std::min(frames, static_cast<int>(pwBuffer->requested));
+        }
+#endif
 
-        std::memcpy(dst, self->buffer.data(), self->bufferPos);
-        self->bufferPos -= size;
-        self->buffer.erase(size);
+        auto* dst = static_cast<std::byte*>(data.data);
+
+        if(self->source) {
+            self->source(dst, frames);
+        }
+        else {
+            const bool unsignedFormat = self->format.sampleFormat() == SampleFormat::U8;
+            std::fill(dst, dst + frames * stride, unsignedFormat ? std::byte{0x80} : std::byte{0});
+        }
 
         data.chunk->offset = 0;
-        data.chunk->stride = self->format.bytesPerFrame();
-        data.chunk->size   = self->stream->bufferSize();
+        data.chunk->stride = stride;
+        data.chunk->size   = static_cast<uint32_t>(frames * stride);
 
         self->stream->queueBuffer(pwBuffer);
         self->loop->signal(false);
@@ -294,7 +300,6 @@ PipeWireOutput::~PipeWireOutput() = default;
 bool PipeWireOutput::init(const AudioFormat& format)
 {
     p->format = format;
-    p->buffer = {format, 0};
 
     pw_init(nullptr, nullptr);
 
@@ -342,6 +347,11 @@ QString PipeWireOutput::device() const
     return p->device;
 }
 
+bool PipeWireOutput::pullsAudio() const
+{
+    return true;
+}
+
 bool PipeWireOutput::canHandleVolume() const
 {
     return true;
@@ -373,10 +383,10 @@ OutputDevices PipeWireOutput::getAllDevices() const
 
 OutputState PipeWireOutput::currentState()
 {
+    // Audio is pulled directly from the renderer, so nothing is ever queued here
     OutputState state;
 
-    state.queuedSamples = p->buffer.frameCount();
-    state.freeSamples   = (p->stream->bufferSize() / p->format.bytesPerFrame()) - state.queuedSamples;
+    state.freeSamples = bufferSize();
 
     return state;
 }
@@ -386,14 +396,10 @@ int PipeWireOutput::bufferSize() const
     return p->stream ? (p->stream->bufferSize() / p->format.bytesPerFrame()) : 0;
 }
 
-int PipeWireOutput::write(const AudioBuffer& buffer)
+void PipeWireOutput::setAudioSource(const AudioSource& source)
 {
     const ThreadLoopGuard guard{p->loop.get()};
-
-    p->buffer.append(buffer.constData());
-    p->bufferPos += buffer.byteCount();
-
-    return buffer.sampleCount();
+    p->source = source;
 }
 
 void PipeWireOutput::setPaused(bool pause)
@@ -37,12 +37,13 @@ public:
 
     [[nodiscard]] bool initialised() const override;
     [[nodiscard]] QString device() const override;
+    [[nodiscard]] bool pullsAudio() const override;
     [[nodiscard]] bool canHandleVolume() const override;
     [[nodiscard]] OutputDevices getAllDevices() const override;
 
     OutputState currentState() override;
     int bufferSize() const override;
-    int write(const AudioBuffer& buffer) override;
+    void setAudioSource(const AudioSource& source) override;
     void setPaused(bool pause) override;
 
     void setVolume(double volume) override;
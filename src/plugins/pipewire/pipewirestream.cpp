@@ -37,11 +37,12 @@ PipewireStream::PipewireStream(PipewireCore* core, const AudioFormat& format, co
                                                     PW_KEY_MEDIA_ROLE, "Music", PW_KEY_APP_ID, "fooyin",
                                                     PW_KEY_APP_ICON_NAME, "fooyin", PW_KEY_APP_NAME, "fooyin", nullptr);
 
-    const auto frames = std::clamp<int>(64, std::ceil(static_cast<float>(2048 * format.sampleRate()) / 48000.0), 8192);
+    // Audio is pulled straight from the renderer, so we can request a small quantum
+    const auto frames = std::clamp<int>(64, std::ceil(static_cast<float>(1024 * format.sampleRate()) / 48000.0), 8192);
     m_bufferSize      = frames * format.bytesPerFrame();
 
     pw_properties_setf(props, PW_KEY_NODE_RATE, "1/%u", format.sampleRate());
-    // pw_properties_setf(props, PW_KEY_NODE_LATENCY, "%u/%u", frames, format.sampleRate());
+    pw_properties_setf(props, PW_KEY_NODE_LATENCY, "%u/%u", frames, format.sampleRate());
 
     if(!device.isEmpty()) {
         pw_properties_setf(props, PW_KEY_TARGET_OBJECT, "%s", device.toUtf8().constData());
@@ -44,8 +44,23 @@ SDL_AudioFormat findFormat(Fooyin::SampleFormat format)
 } // namespace
 
 namespace Fooyin::Sdl {
+void SdlOutput::audioCallback(void* userData, uint8_t* stream, int len)
+{
+    auto* self = static_cast<SdlOutput*>(userData);
+
+    auto* data       = reinterpret_cast<std::byte*>(stream);
+    const int frames = len / self->m_format.bytesPerFrame();
+
+    if(self->m_source) {
+        self->m_source(data, frames);
+    }
+    else {
+        std::fill(data, data + len, std::byte{self->m_obtainedSpec.silence});
+    }
+}
+
 SdlOutput::SdlOutput()
-    : m_bufferSize{4096}
+    : m_bufferSize{1024}
     , m_initialised{false}
     , m_device{QStringLiteral("default")}
 { }
@@ -60,14 +75,17 @@ bool SdlOutput::init(const AudioFormat& format)
     m_desiredSpec.format   = findFormat(format.sampleFormat());
     m_desiredSpec.channels = format.channelCount();
     m_desiredSpec.samples  = m_bufferSize;
-    m_desiredSpec.callback = nullptr;
+    m_desiredSpec.callback = audioCallback;
+    m_desiredSpec.userdata = this;
 
+    // Audio is written directly in the callback, so only allow changes SDL can convert for us
     if(m_device == QStringLiteral("default")) {
-        m_audioDeviceId = SDL_OpenAudioDevice(nullptr, 0, &m_desiredSpec, &m_obtainedSpec, SDL_AUDIO_ALLOW_ANY_CHANGE);
+        m_audioDeviceId
+            = SDL_OpenAudioDevice(nullptr, 0, &m_desiredSpec, &m_obtainedSpec, SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
     }
     else {
         m_audioDeviceId = SDL_OpenAudioDevice(m_device.toLocal8Bit().constData(), 0, &m_desiredSpec, &m_obtainedSpec,
-                                              SDL_AUDIO_ALLOW_ANY_CHANGE);
+                                              SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
     }
 
     if(m_audioDeviceId == 0) {
@@ -75,6 +93,8 @@ bool SdlOutput::init(const AudioFormat& format)
         return false;
     }
 
+    m_bufferSize = m_obtainedSpec.samples;
+
     m_initialised = true;
     return true;
 }
@@ -90,7 +110,6 @@ void SdlOutput::uninit()
 void SdlOutput::reset()
 {
     SDL_PauseAudioDevice(m_audioDeviceId, 1);
-    SDL_ClearQueuedAudio(m_audioDeviceId);
 }
 
 void SdlOutput::start()
@@ -110,6 +129,11 @@ QString SdlOutput::device() const
     return m_device;
 }
 
+bool SdlOutput::pullsAudio() const
+{
+    return true;
+}
+
 bool SdlOutput::canHandleVolume() const
 {
     return false;
@@ -122,10 +146,10 @@ int SdlOutput::bufferSize() const
 
 OutputState SdlOutput::currentState()
 {
+    // Audio is pulled directly from the renderer, so nothing is ever queued here
     OutputState state;
 
-    state.queuedSamples = static_cast<int>(SDL_GetQueuedAudioSize(m_audioDeviceId) / m_format.bytesPerFrame());
-    state.freeSamples   = m_bufferSize - state.queuedSamples;
+    state.freeSamples = m_bufferSize;
 
     return state;
 }
@@ -157,13 +181,11 @@ OutputDevices SdlOutput::getAllDevices() const
     return devices;
 }
 
-int SdlOutput::write(const AudioBuffer& buffer)
+void SdlOutput::setAudioSource(const AudioSource& source)
 {
-    if(SDL_QueueAudio(m_audioDeviceId, buffer.constData().data(), buffer.byteCount()) == 0) {
-        return buffer.sampleCount();
-    }
-
-    return 0;
+    SDL_LockAudioDevice(m_audioDeviceId);
+    m_source = source;
+    SDL_UnlockAudioDevice(m_audioDeviceId);
 }
 
 void SdlOutput::setPaused(bool pause)
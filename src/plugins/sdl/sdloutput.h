@@ -38,17 +38,21 @@ public:
 
     [[nodiscard]] bool initialised() const override;
     [[nodiscard]] QString device() const override;
+    [[nodiscard]] bool pullsAudio() const override;
     [[nodiscard]] bool canHandleVolume() const override;
     int bufferSize() const override;
     OutputState currentState() override;
     [[nodiscard]] OutputDevices getAllDevices() const override;
 
-    int write(const AudioBuffer& buffer) override;
+    void setAudioSource(const AudioSource& source) override;
     void setPaused(bool pause) override;
     void setDevice(const QString& device) override;
 
 private:
+    static void audioCallback(void* userData, uint8_t* stream, int len);
+
     AudioFormat m_format;
+    AudioSource m_source;
     int m_bufferSize;
     bool m_initialised;
     QString m_device;
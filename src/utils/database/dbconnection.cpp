@@ -75,6 +75,8 @@ bool DbConnection::open()
 
 void DbConnection::close()
 {
+    m_queries.clear();
+
     auto db = this->db();
     if(db.isOpen()) {
         if(db.rollback()) {
@@ -93,4 +95,22 @@ QSqlDatabase DbConnection::db() const
 {
     return QSqlDatabase::database(m_name);
 }
+
+DbQuery DbConnection::cachedQuery(const QString& statement)
+{
+    auto& cachedQuery = m_queries[statement];
+
+    if(cachedQuery && cachedQuery.use_count() == 1) {
+        return DbQuery{cachedQuery};
+    }
+
+    DbQuery query{db(), statement};
+
+    if(cachedQuery || query.status() != DbQuery::Status::Prepared) {
+        return query;
+    }
+
+    cachedQuery = std::make_shared<QSqlQuery>(std::move(*query.m_query));
+    return DbQuery{cachedQuery};
+}
 } // namespace Fooyin
@@ -19,16 +19,24 @@
 
 #include <utils/database/dbconnectionpool.h>
 
+#include <QSqlError>
 #include <QSqlQuery>
 
 namespace {
-bool updatePragmas(Fooyin::DbConnection* connection)
+bool updatePragmas(Fooyin::DbConnection* connection, const QStringList& pragmas)
 {
-    QSqlQuery foreignKeys{connection->db()};
-    if(!foreignKeys.exec(QStringLiteral("PRAGMA foreign_keys = ON;"))) {
+    QSqlQuery query{connection->db()};
+    if(!query.exec(QStringLiteral("PRAGMA foreign_keys = ON;"))) {
         return false;
     }
 
+    // The rest only affect performance, so continue without any that aren't supported
+    for(const QString& pragma : pragmas) {
+        if(!query.exec(QStringLiteral("PRAGMA %1;").arg(pragma))) {
+            qWarning() << "[DB] Failed to set pragma" << pragma << ":" << query.lastError();
+        }
+    }
+
     return true;
 }
 } // namespace
@@ -44,6 +52,7 @@ DbConnectionPool::DbConnectionPool(PrivateKey /*key*/, const DbConnection::DbPar
                                    const QString& connectionName)
     : m_connectionCount{0}
     , m_prototype{params, connectionName}
+    , m_pragmas{params.pragmas}
 { }
 
 DbConnectionPoolPtr DbConnectionPool::create(const DbConnection::DbParams& params, const QString& connectionName)
@@ -72,7 +81,7 @@ bool DbConnectionPool::createThreadConnection()
         return false;
     }
 
-    if(!updatePragmas(connection.get())) {
+    if(!updatePragmas(connection.get(), m_pragmas)) {
         qCritical() << "[DB] Failed to set pragmas:" << connectionName;
         return false;
     }
@@ -31,24 +31,36 @@ DbConnectionProvider::DbConnectionProvider(DbConnectionPoolPtr pool)
 { }
 
 QSqlDatabase DbConnectionProvider::db() const
+{
+    const DbConnection* connection = threadConnection();
+    return connection ? connection->db() : QSqlDatabase{};
+}
+
+DbQuery DbConnectionProvider::cachedQuery(const QString& statement) const
+{
+    DbConnection* connection = threadConnection();
+    return connection ? connection->cachedQuery(statement) : DbQuery{};
+}
+
+DbConnection* DbConnectionProvider::threadConnection() const
 {
     if(!m_connectionPool) {
         qCritical() << "[DB] No connection pool";
-        return {};
+        return nullptr;
     }
 
-    const DbConnection* connection = m_connectionPool->threadConnection();
+    DbConnection* connection = m_connectionPool->threadConnection();
 
     if(!connection) {
         qCritical() << "[DB] Thread connection not found";
-        return {};
+        return nullptr;
     }
 
     if(!connection->isOpen() && !connection->db().open()) {
         qCritical() << "[DB] Thread connection could not be opened";
-        return {};
+        return nullptr;
     }
 
-    return connection->db();
+    return connection;
 }
 } // namespace Fooyin
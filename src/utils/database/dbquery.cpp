@@ -36,14 +36,15 @@ bool prepareQuery(QSqlQuery& query, const QString& statement)
 
 namespace Fooyin {
 DbQuery::DbQuery()
-    : m_status{Status::None}
+    : m_query{std::in_place}
+    , m_status{Status::None}
 { }
 
 DbQuery::DbQuery(const QSqlDatabase& database, const QString& statement)
-    : m_query{database}
+    : m_query{std::in_place, database}
     , m_status{Status::None}
 {
-    if(prepareQuery(m_query, statement)) {
+    if(prepareQuery(*m_query, statement)) {
         m_status = Status::Prepared;
     }
     else if(lastError().isValid() && lastError().type() != QSqlError::NoError) {
@@ -58,6 +59,19 @@ DbQuery::DbQuery(const QSqlDatabase& database, const QString& statement)
     }
 }
 
+DbQuery::DbQuery(std::shared_ptr<QSqlQuery> cachedQuery)
+    : m_cachedQuery{std::move(cachedQuery)}
+    , m_status{Status::Prepared}
+{ }
+
+DbQuery::~DbQuery()
+{
+    if(m_cachedQuery) {
+        // Release any results so the statement doesn't hold locks while cached
+        m_cachedQuery->finish();
+    }
+}
+
 DbQuery::Status DbQuery::status() const
 {
     return m_status;
@@ -65,48 +79,63 @@ DbQuery::Status DbQuery::status() const
 
 QSqlError DbQuery::lastError() const
 {
-    return m_query.lastError();
+    return query().lastError();
 }
 
 void DbQuery::bindValue(const QString& placeholder, const QVariant& value)
 {
-    m_query.bindValue(placeholder, value);
+    query().bindValue(placeholder, value);
+}
+
+void DbQuery::addBindValue(const QVariant& value)
+{
+    query().addBindValue(value);
 }
 
 QString DbQuery::executedQuery() const
 {
-    return m_query.executedQuery();
+    return query().executedQuery();
 }
 
 bool DbQuery::exec()
 {
-    if(m_query.exec()) {
+    if(query().exec()) {
         m_status = Status::Success;
         return true;
     }
 
-    qWarning() << "[DB] Failed to execute" << m_query.lastQuery() << ":" << lastError();
+    qWarning() << "[DB] Failed to execute" << query().lastQuery() << ":" << lastError();
     m_status = Status::Error;
     return false;
 }
 
 int DbQuery::numRowsAffected() const
 {
-    return m_query.numRowsAffected();
+    return query().numRowsAffected();
 }
 
 QVariant DbQuery::lastInsertId() const
 {
-    return m_query.lastInsertId();
+    return query().lastInsertId();
 }
 
 bool DbQuery::next()
 {
-    return m_query.next();
+    return query().next();
 }
 
 QVariant DbQuery::value(int index) const
 {
-    return m_query.value(index);
+    return query().value(index);
+}
+
+QSqlQuery& DbQuery::query()
+{
+    return m_cachedQuery ? *m_cachedQuery : *m_query;
+}
+
+const QSqlQuery& DbQuery::query() const
+{
+    return m_cachedQuery ? *m_cachedQuery : *m_query;
 }
 } // namespace Fooyin
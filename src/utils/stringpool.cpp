@@ -0,0 +1,81 @@
+/*
+ * Fooyin
+ * Copyright © 2023, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/stringpool.h>
+
+namespace Fooyin {
+QString StringPool::intern(const QString& str)
+{
+    if(str.isEmpty()) {
+        return str;
+    }
+
+    const auto strIt = m_strings.constFind(str);
+    if(strIt != m_strings.cend()) {
+        return *strIt;
+    }
+
+    m_strings.insert(str);
+    return str;
+}
+
+QStringList StringPool::intern(const QStringList& strings)
+{
+    if(strings.isEmpty()) {
+        return strings;
+    }
+
+    const auto listIt = m_lists.constFind(strings);
+    if(listIt != m_lists.cend()) {
+        return *listIt;
+    }
+
+    QStringList interned;
+    interned.reserve(strings.size());
+    for(const QString& str : strings) {
+        interned.append(intern(str));
+    }
+
+    m_lists.insert(interned);
+    return interned;
+}
+
+void StringPool::prune()
+{
+    // Lists hold references to their strings, so remove unused lists first
+    for(auto listIt = m_lists.begin(); listIt != m_lists.end();) {
+        listIt = listIt->isDetached() ? m_lists.erase(listIt) : std::next(listIt);
+    }
+
+    for(auto strIt = m_strings.begin(); strIt != m_strings.end();) {
+        strIt = strIt->isDetached() ? m_strings.erase(strIt) : std::next(strIt);
+    }
+}
+
+size_t StringPool::size() const
+{
+    return static_cast<size_t>(m_strings.size());
+}
+
+void StringPool::clear()
+{
+    m_strings.clear();
+    m_lists.clear();
+}
+} // namespace Fooyin
@@ -0,0 +1,97 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <core/engine/audiobuffer.h>
+
+#include <gtest/gtest.h>
+
+namespace Fooyin::Testing {
+class AudioBufferTest : public ::testing::Test
+{
+protected:
+    AudioBufferTest()
+        : m_format{SampleFormat::S16, 44100, 2}
+        , m_data(4096)
+    {
+        for(size_t i{0}; i < m_data.size(); ++i) {
+            m_data[i] = static_cast<std::byte>(i % 256);
+        }
+    }
+
+    AudioFormat m_format;
+    std::vector<std::byte> m_data;
+};
+
+TEST_F(AudioBufferTest, CopiesData)
+{
+    const AudioBuffer buffer{m_data, m_format, 100};
+
+    EXPECT_TRUE(buffer.isValid());
+    EXPECT_EQ(buffer.byteCount(), static_cast<int>(m_data.size()));
+    EXPECT_EQ(buffer.frameCount(), static_cast<int>(m_data.size()) / m_format.bytesPerFrame());
+    EXPECT_EQ(buffer.startTime(), 100U);
+    EXPECT_TRUE(std::ranges::equal(buffer.constData(), m_data));
+}
+
+TEST_F(AudioBufferTest, DetachCopiesData)
+{
+    AudioBuffer buffer{m_data, m_format, 0};
+    AudioBuffer copy{buffer};
+    copy.detach();
+    copy.fillSilence();
+
+    EXPECT_TRUE(std::ranges::equal(buffer.constData(), m_data));
+    EXPECT_NE(buffer.constData().data(), copy.constData().data());
+}
+
+TEST_F(AudioBufferTest, SteadyStateDoesNotAllocate)
+{
+    {
+        // Prime the pool
+        const AudioBuffer buffer1{m_data, m_format, 0};
+        const AudioBuffer buffer2{m_data, m_format, 0};
+    }
+
+    const uint64_t allocations = AudioBuffer::allocationCount();
+
+    for(uint64_t i{0}; i < 1000; ++i) {
+        AudioBuffer buffer{m_format, i};
+        buffer.resize(m_data.size());
+        buffer.adjustVolumeOfSamples(0.5);
+
+        const AudioBuffer copy{m_data, m_format, i};
+        EXPECT_TRUE(copy.isValid());
+    }
+
+    EXPECT_EQ(allocations, AudioBuffer::allocationCount());
+}
+
+TEST_F(AudioBufferTest, GrowingAllocates)
+{
+    AudioBuffer buffer{m_data, m_format, 0};
+
+    const uint64_t allocations = AudioBuffer::allocationCount();
+
+    buffer.append(m_data);
+    buffer.append(m_data);
+
+    EXPECT_GT(AudioBuffer::allocationCount(), allocations);
+    EXPECT_EQ(buffer.byteCount(), static_cast<int>(m_data.size() * 3));
+}
+} // namespace Fooyin::Testing
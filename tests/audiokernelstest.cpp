@@ -0,0 +1,184 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engine/audiokernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace Fooyin::Testing {
+namespace Kernels = Audio::Kernels;
+
+class AudioKernelsTest : public ::testing::TestWithParam<Kernels::Level>
+{
+protected:
+    AudioKernelsTest()
+        : m_samples(1037)
+    {
+        std::mt19937 gen{42};
+        std::uniform_real_distribution<float> dist{-1.5F, 1.5F};
+        for(float& sample : m_samples) {
+            sample = dist(gen);
+        }
+        m_samples[0] = 1.0F;
+        m_samples[1] = -1.0F;
+    }
+
+    void SetUp() override
+    {
+        Kernels::setLevel(GetParam());
+        if(Kernels::level() != GetParam()) {
+            GTEST_SKIP() << "Instruction set not supported";
+        }
+    }
+
+    void TearDown() override
+    {
+        Kernels::setLevel(Kernels::Level::AVX2);
+    }
+
+    // Runs @p func with the scalar kernels so results can be compared against them
+    template <typename Func>
+    static auto scalar(Func&& func)
+    {
+        const Kernels::Level level = Kernels::level();
+        Kernels::setLevel(Kernels::Level::Scalar);
+        auto result = func();
+        Kernels::setLevel(level);
+        return result;
+    }
+
+    std::vector<float> m_samples;
+};
+
+TEST_P(AudioKernelsTest, Interleave)
+{
+    for(const int bps : {1, 2, 4}) {
+        for(const int channels : {1, 2, 6}) {
+            const int frames = 203;
+
+            std::vector<std::vector<uint8_t>> planes(channels, std::vector<uint8_t>(frames * bps));
+            std::vector<const uint8_t*> planePtrs;
+            for(int ch{0}; ch < channels; ++ch) {
+                for(size_t i{0}; i < planes[ch].size(); ++i) {
+                    planes[ch][i] = static_cast<uint8_t>((i * 7) + ch);
+                }
+                planePtrs.push_back(planes[ch].data());
+            }
+
+            const auto run = [&]() {
+                std::vector<std::byte> out(static_cast<size_t>(frames * channels * bps));
+                Kernels::interleave(planePtrs.data(), out.data(), channels, frames, bps);
+                return out;
+            };
+
+            const auto out = run();
+            EXPECT_EQ(out, scalar(run));
+            // Second sample of the first frame comes from the second channel
+            if(channels > 1) {
+                EXPECT_EQ(std::to_integer<uint8_t>(out[bps]), planes[1][0]);
+            }
+        }
+    }
+}
+
+TEST_P(AudioKernelsTest, FloatToInt)
+{
+    const auto toS16 = [this]() {
+        std::vector<int16_t> out(m_samples.size());
+        Kernels::floatToS16(m_samples.data(), out.data(), out.size());
+        return out;
+    };
+    const auto toS32 = [this]() {
+        std::vector<int32_t> out(m_samples.size());
+        Kernels::floatToS32(m_samples.data(), out.data(), out.size());
+        return out;
+    };
+
+    const auto s16 = toS16();
+    const auto s32 = toS32();
+
+    EXPECT_EQ(s16, scalar(toS16));
+    EXPECT_EQ(s32, scalar(toS32));
+    EXPECT_EQ(s16[0], std::numeric_limits<int16_t>::max());
+    EXPECT_EQ(s16[1], std::numeric_limits<int16_t>::min());
+    EXPECT_EQ(s32[1], std::numeric_limits<int32_t>::min());
+}
+
+TEST_P(AudioKernelsTest, IntToFloat)
+{
+    const std::vector<int16_t> s16{0, 32767, -32767, 16384, -1, 5, 6, 7, 8, 9, 10};
+    const std::vector<int32_t> s32{0, std::numeric_limits<int32_t>::max(), -std::numeric_limits<int32_t>::max(), 1, 2};
+
+    const auto fromS16 = [&]() {
+        std::vector<float> out(s16.size());
+        Kernels::s16ToFloat(s16.data(), out.data(), out.size());
+        return out;
+    };
+    const auto fromS32 = [&]() {
+        std::vector<float> out(s32.size());
+        Kernels::s32ToFloat(s32.data(), out.data(), out.size());
+        return out;
+    };
+
+    const auto floats16 = fromS16();
+    const auto floats32 = fromS32();
+
+    EXPECT_EQ(floats16, scalar(fromS16));
+    EXPECT_EQ(floats32, scalar(fromS32));
+    EXPECT_FLOAT_EQ(floats16[1], 1.0F);
+    EXPECT_FLOAT_EQ(floats16[2], -1.0F);
+    EXPECT_FLOAT_EQ(floats32[1], 1.0F);
+}
+
+TEST_P(AudioKernelsTest, ScaleSaturates)
+{
+    std::vector<int16_t> s16(37, 30000);
+    s16[3] = -30000;
+    std::vector<int32_t> s32(37, 2000000000);
+
+    Kernels::scaleS16(s16.data(), s16.size(), 2.0F);
+    Kernels::scaleS32(s32.data(), s32.size(), 2.0);
+
+    EXPECT_EQ(s16[0], std::numeric_limits<int16_t>::max());
+    EXPECT_EQ(s16[3], std::numeric_limits<int16_t>::min());
+    EXPECT_EQ(s16[36], std::numeric_limits<int16_t>::max());
+    EXPECT_EQ(s32[0], std::numeric_limits<int32_t>::max());
+
+    std::vector<float> samples = m_samples;
+    Kernels::scaleFloat(samples.data(), samples.size(), 0.5F);
+    EXPECT_FLOAT_EQ(samples[0], 0.5F);
+    EXPECT_FLOAT_EQ(samples.back(), m_samples.back() * 0.5F);
+}
+
+TEST_P(AudioKernelsTest, ApplyGainUnsigned)
+{
+    std::vector<uint8_t> samples{128, 192, 64, 255, 0};
+
+    Kernels::applyGain(reinterpret_cast<std::byte*>(samples.data()), samples.size(), SampleFormat::U8, 0.5);
+    EXPECT_EQ(samples, (std::vector<uint8_t>{128, 160, 96, 191, 64}));
+
+    Kernels::applyGain(reinterpret_cast<std::byte*>(samples.data()), samples.size(), SampleFormat::U8, 4.0);
+    EXPECT_EQ(samples, (std::vector<uint8_t>{128, 255, 0, 255, 0}));
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, AudioKernelsTest,
+                         ::testing::Values(Kernels::Level::Scalar, Kernels::Level::SSE2, Kernels::Level::AVX2));
+} // namespace Fooyin::Testing
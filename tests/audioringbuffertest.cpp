@@ -0,0 +1,189 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engine/audioringbuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+std::vector<std::byte> sequence(size_t size, int start = 0)
+{
+    std::vector<std::byte> data(size);
+    for(size_t i{0}; i < size; ++i) {
+        data[i] = static_cast<std::byte>((start + static_cast<int>(i)) & 0xFF);
+    }
+    return data;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+TEST(AudioRingBufferTest, StartsEmpty)
+{
+    AudioRingBuffer buffer{16};
+
+    EXPECT_EQ(buffer.capacity(), 16);
+    EXPECT_EQ(buffer.readAvailable(), 0);
+    EXPECT_EQ(buffer.writeAvailable(), 16);
+
+    std::vector<std::byte> out(8);
+    EXPECT_EQ(buffer.read(out.data(), out.size()), 0);
+    EXPECT_EQ(buffer.totalRead(), 0);
+}
+
+TEST(AudioRingBufferTest, UnallocatedBufferIgnoresIo)
+{
+    AudioRingBuffer buffer;
+
+    const auto in = sequence(4);
+    std::vector<std::byte> out(4);
+
+    EXPECT_EQ(buffer.write(in.data(), in.size()), 0);
+    EXPECT_EQ(buffer.read(out.data(), out.size()), 0);
+    EXPECT_EQ(buffer.writeAvailable(), 0);
+}
+
+TEST(AudioRingBufferTest, WriteStopsWhenFull)
+{
+    AudioRingBuffer buffer{16};
+
+    const auto in = sequence(20);
+    EXPECT_EQ(buffer.write(in.data(), in.size()), 16);
+    EXPECT_EQ(buffer.readAvailable(), 16);
+    EXPECT_EQ(buffer.writeAvailable(), 0);
+
+    // Nothing more fits until the consumer catches up
+    EXPECT_EQ(buffer.write(in.data(), 1), 0);
+    EXPECT_EQ(buffer.totalWritten(), 16);
+
+    std::vector<std::byte> out(16);
+    EXPECT_EQ(buffer.read(out.data(), out.size()), 16);
+    EXPECT_TRUE(std::equal(out.cbegin(), out.cend(), in.cbegin()));
+    EXPECT_EQ(buffer.readAvailable(), 0);
+    EXPECT_EQ(buffer.writeAvailable(), 16);
+}
+
+TEST(AudioRingBufferTest, PartialReads)
+{
+    AudioRingBuffer buffer{16};
+
+    const auto in = sequence(10);
+    ASSERT_EQ(buffer.write(in.data(), in.size()), 10);
+
+    std::vector<std::byte> out(4);
+    EXPECT_EQ(buffer.read(out.data(), out.size()), 4);
+    EXPECT_TRUE(std::equal(out.cbegin(), out.cend(), in.cbegin()));
+    EXPECT_EQ(buffer.readAvailable(), 6);
+
+    // Asking for more than is available returns what is left
+    std::vector<std::byte> rest(10);
+    EXPECT_EQ(buffer.read(rest.data(), rest.size()), 6);
+    EXPECT_TRUE(std::equal(rest.cbegin(), rest.cbegin() + 6, in.cbegin() + 4));
+    EXPECT_EQ(buffer.totalRead(), 10);
+}
+
+TEST(AudioRingBufferTest, WrapsAround)
+{
+    AudioRingBuffer buffer{16};
+
+    // Move both positions close to the end of the storage
+    const auto head = sequence(12);
+    std::vector<std::byte> discard(12);
+    ASSERT_EQ(buffer.write(head.data(), head.size()), 12);
+    ASSERT_EQ(buffer.read(discard.data(), discard.size()), 12);
+
+    // This write spans the end of the storage
+    const auto in = sequence(10, 100);
+    EXPECT_EQ(buffer.write(in.data(), in.size()), 10);
+    EXPECT_EQ(buffer.readAvailable(), 10);
+    EXPECT_EQ(buffer.writeAvailable(), 6);
+
+    // As does this read
+    std::vector<std::byte> out(10);
+    EXPECT_EQ(buffer.read(out.data(), out.size()), 10);
+    EXPECT_EQ(out, in);
+    EXPECT_EQ(buffer.totalWritten(), 22);
+    EXPECT_EQ(buffer.totalRead(), 22);
+}
+
+TEST(AudioRingBufferTest, FillsAcrossWrap)
+{
+    AudioRingBuffer buffer{8};
+
+    const auto head = sequence(5);
+    std::vector<std::byte> discard(5);
+    ASSERT_EQ(buffer.write(head.data(), head.size()), 5);
+    ASSERT_EQ(buffer.read(discard.data(), discard.size()), 5);
+
+    // Fill completely while wrapped, in uneven chunks
+    const auto in = sequence(8, 50);
+    EXPECT_EQ(buffer.write(in.data(), 3), 3);
+    EXPECT_EQ(buffer.write(in.data() + 3, 9), 5);
+    EXPECT_EQ(buffer.writeAvailable(), 0);
+
+    std::vector<std::byte> out(8);
+    EXPECT_EQ(buffer.read(out.data(), 2), 2);
+    EXPECT_EQ(buffer.read(out.data() + 2, 6), 6);
+    EXPECT_EQ(out, in);
+    EXPECT_EQ(buffer.readAvailable(), 0);
+}
+
+TEST(AudioRingBufferTest, ManyCyclesKeepOrder)
+{
+    AudioRingBuffer buffer{7};
+
+    std::vector<std::byte> written;
+    std::vector<std::byte> read;
+    int next{0};
+
+    for(int cycle{0}; cycle < 100; ++cycle) {
+        const auto in      = sequence(static_cast<size_t>(cycle % 5) + 1, next);
+        const size_t count = buffer.write(in.data(), in.size());
+        written.insert(written.end(), in.cbegin(), in.cbegin() + static_cast<std::ptrdiff_t>(count));
+        next += static_cast<int>(count);
+
+        std::vector<std::byte> out(static_cast<size_t>(cycle % 3) + 1);
+        const size_t got = buffer.read(out.data(), out.size());
+        read.insert(read.end(), out.cbegin(), out.cbegin() + static_cast<std::ptrdiff_t>(got));
+    }
+
+    std::vector<std::byte> out(buffer.readAvailable());
+    buffer.read(out.data(), out.size());
+    read.insert(read.end(), out.cbegin(), out.cend());
+
+    EXPECT_EQ(read, written);
+    EXPECT_EQ(buffer.totalRead(), buffer.totalWritten());
+}
+
+TEST(AudioRingBufferTest, ClearResetsPositions)
+{
+    AudioRingBuffer buffer{8};
+
+    const auto in = sequence(6);
+    ASSERT_EQ(buffer.write(in.data(), in.size()), 6);
+
+    buffer.clear();
+
+    EXPECT_EQ(buffer.readAvailable(), 0);
+    EXPECT_EQ(buffer.writeAvailable(), 8);
+    EXPECT_EQ(buffer.totalWritten(), 0);
+    EXPECT_EQ(buffer.totalRead(), 0);
+}
+} // namespace Fooyin::Testing
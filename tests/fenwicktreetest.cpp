@@ -0,0 +1,73 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <utils/fenwicktree.h>
+
+#include <gtest/gtest.h>
+
+namespace Fooyin::Testing {
+class FenwickTreeTest : public ::testing::Test
+{
+protected:
+    FenwickTreeTest()
+    {
+        m_tree.assign({20, 40, 0, 20, 60});
+    }
+
+    FenwickTree<int> m_tree;
+};
+
+TEST_F(FenwickTreeTest, PrefixSums)
+{
+    EXPECT_EQ(m_tree.size(), 5);
+    EXPECT_EQ(m_tree.prefixSum(0), 0);
+    EXPECT_EQ(m_tree.prefixSum(2), 60);
+    EXPECT_EQ(m_tree.prefixSum(4), 80);
+    EXPECT_EQ(m_tree.total(), 140);
+    EXPECT_EQ(m_tree.prefixSum(10), 140);
+}
+
+TEST_F(FenwickTreeTest, UpperBound)
+{
+    EXPECT_EQ(m_tree.upperBound(-5), 0);
+    EXPECT_EQ(m_tree.upperBound(0), 0);
+    EXPECT_EQ(m_tree.upperBound(19), 0);
+    EXPECT_EQ(m_tree.upperBound(20), 1);
+    // Empty values are skipped
+    EXPECT_EQ(m_tree.upperBound(60), 3);
+    EXPECT_EQ(m_tree.upperBound(139), 4);
+    EXPECT_EQ(m_tree.upperBound(140), 5);
+}
+
+TEST_F(FenwickTreeTest, SetUpdatesSums)
+{
+    m_tree.set(1, 10);
+    m_tree.set(2, 5);
+
+    EXPECT_EQ(m_tree.value(1), 10);
+    EXPECT_EQ(m_tree.prefixSum(3), 35);
+    EXPECT_EQ(m_tree.total(), 115);
+    EXPECT_EQ(m_tree.upperBound(32), 2);
+
+    m_tree.clear();
+    EXPECT_TRUE(m_tree.empty());
+    EXPECT_EQ(m_tree.total(), 0);
+    EXPECT_EQ(m_tree.upperBound(10), 0);
+}
+} // namespace Fooyin::Testing
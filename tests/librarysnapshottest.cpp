@@ -0,0 +1,96 @@
+/*
+ * Fooyin
+ * Copyright © 2023, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "library/librarysnapshot.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+namespace Fooyin::Testing {
+class LibrarySnapshotTest : public ::testing::Test
+{
+protected:
+    [[nodiscard]] QString snapshotPath() const
+    {
+        return m_dir.filePath(QStringLiteral("library.snapshot"));
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(LibrarySnapshotTest, RoundTrip)
+{
+    Track track{QStringLiteral("/music/Artist/Album/01.flac")};
+    track.setId(7);
+    track.setLibraryId(2);
+    track.setTitle(QStringLiteral("Title"));
+    track.setArtists({QStringLiteral("Artist"), QStringLiteral("Guest")});
+    track.setAlbum(QStringLiteral("Album"));
+    track.setTrackNumber(1);
+    track.setDate(QStringLiteral("2001-02-03"));
+    track.setDuration(180000);
+    track.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Calm"));
+    track.setPlayCount(3);
+    track.setSort(QStringLiteral("artist - album - 01"));
+    track.generateHash();
+
+    ASSERT_TRUE(LibrarySnapshot::write(snapshotPath(), {track}, QStringLiteral("%artist%"), 42));
+
+    const auto snapshot = LibrarySnapshot::read(snapshotPath());
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->sortScript, u"%artist%");
+    EXPECT_EQ(snapshot->revision, 42U);
+    ASSERT_EQ(snapshot->tracks.size(), 1);
+
+    const Track& read = snapshot->tracks.front();
+    EXPECT_EQ(read.id(), 7);
+    EXPECT_EQ(read.libraryId(), 2);
+    EXPECT_EQ(read.filepath(), track.filepath());
+    EXPECT_EQ(read.filename(), track.filename());
+    EXPECT_EQ(read.title(), track.title());
+    EXPECT_EQ(read.artists(), track.artists());
+    EXPECT_EQ(read.album(), track.album());
+    EXPECT_EQ(read.trackNumber(), 1);
+    EXPECT_EQ(read.year(), 2001);
+    EXPECT_EQ(read.duration(), 180000U);
+    EXPECT_EQ(read.extraTag(QStringLiteral("MOOD")), QStringList{QStringLiteral("Calm")});
+    EXPECT_EQ(read.playCount(), 3);
+    EXPECT_EQ(read.sort(), track.sort());
+    EXPECT_EQ(read.hash(), track.hash());
+}
+
+TEST_F(LibrarySnapshotTest, RejectsInvalidFiles)
+{
+    EXPECT_FALSE(LibrarySnapshot::read(snapshotPath()).has_value());
+
+    QFile file{snapshotPath()};
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not a snapshot");
+    file.close();
+
+    EXPECT_FALSE(LibrarySnapshot::read(snapshotPath()).has_value());
+
+    ASSERT_TRUE(LibrarySnapshot::write(snapshotPath(), {Track{QStringLiteral("/music/01.flac")}}, {}, 1));
+    ASSERT_TRUE(file.resize(file.size() - 4));
+
+    EXPECT_FALSE(LibrarySnapshot::read(snapshotPath()).has_value());
+}
+} // namespace Fooyin::Testing
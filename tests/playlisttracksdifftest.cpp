@@ -0,0 +1,168 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "database/playlisttracksdiff.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+
+namespace {
+using TrackIds = std::vector<int>;
+
+/*!
+ * Applies @p diff to @p savedIds the way PlaylistDatabase::updatePlaylistTracks
+ * does to the stored rows, which are keyed by track index.
+ */
+TrackIds applyDiff(const Fooyin::PlaylistTracksDiff& diff, const TrackIds& savedIds, const TrackIds& currentIds)
+{
+    std::map<size_t, int> rows;
+    for(size_t i{0}; i < savedIds.size(); ++i) {
+        rows.emplace(i, savedIds.at(i));
+    }
+
+    for(size_t i{diff.first}; i < diff.replacedEnd(); ++i) {
+        rows.at(i) = currentIds.at(i);
+    }
+
+    if(diff.savedEnd != diff.currentEnd) {
+        for(size_t i{diff.currentEnd}; i < diff.savedEnd; ++i) {
+            rows.erase(i);
+        }
+
+        std::map<size_t, int> shifted;
+        for(const auto& [index, id] : rows) {
+            shifted.emplace(index >= diff.savedEnd ? index + diff.currentEnd - diff.savedEnd : index, id);
+        }
+        rows = std::move(shifted);
+
+        for(size_t i{diff.savedEnd}; i < diff.currentEnd; ++i) {
+            rows.emplace(i, currentIds.at(i));
+        }
+    }
+
+    TrackIds result;
+    for(size_t expected{0}; const auto& [index, id] : rows) {
+        EXPECT_EQ(index, expected++);
+        result.push_back(id);
+    }
+    return result;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+struct DiffCase
+{
+    TrackIds saved;
+    TrackIds current;
+    size_t first;
+    size_t savedEnd;
+    size_t currentEnd;
+};
+
+void checkDiff(const DiffCase& diffCase)
+{
+    const PlaylistTracksDiff diff{diffCase.saved, diffCase.current};
+
+    EXPECT_EQ(diff.first, diffCase.first);
+    EXPECT_EQ(diff.savedEnd, diffCase.savedEnd);
+    EXPECT_EQ(diff.currentEnd, diffCase.currentEnd);
+    EXPECT_EQ(applyDiff(diff, diffCase.saved, diffCase.current), diffCase.current);
+}
+
+TEST(PlaylistTracksDiffTest, Unchanged)
+{
+    checkDiff({{}, {}, 0, 0, 0});
+    checkDiff({{1, 2, 3}, {1, 2, 3}, 3, 3, 3});
+
+    const PlaylistTracksDiff diff{{1, 2, 3}, {1, 2, 3}};
+    EXPECT_EQ(diff.statementCount({1, 2, 3}, {1, 2, 3}, 10), 0);
+}
+
+TEST(PlaylistTracksDiffTest, Insert)
+{
+    checkDiff({{}, {1, 2}, 0, 0, 2});
+    checkDiff({{1, 2}, {1, 2, 3}, 2, 2, 3});
+    checkDiff({{2, 3}, {1, 2, 3}, 0, 0, 1});
+    checkDiff({{1, 3}, {1, 2, 3}, 1, 1, 2});
+    checkDiff({{1, 4}, {1, 2, 3, 4}, 1, 1, 3});
+}
+
+TEST(PlaylistTracksDiffTest, Remove)
+{
+    checkDiff({{1, 2}, {}, 0, 2, 0});
+    checkDiff({{1, 2, 3}, {1, 2}, 2, 3, 2});
+    checkDiff({{1, 2, 3}, {2, 3}, 0, 1, 0});
+    checkDiff({{1, 2, 3}, {1, 3}, 1, 2, 1});
+    checkDiff({{1, 2, 3, 4}, {1, 4}, 1, 3, 1});
+}
+
+TEST(PlaylistTracksDiffTest, Replace)
+{
+    checkDiff({{1, 2, 3}, {1, 5, 3}, 1, 2, 2});
+    checkDiff({{1, 2, 3}, {4, 5, 6}, 0, 3, 3});
+    checkDiff({{1, 2, 3}, {1, 5, 6, 7, 3}, 1, 2, 4});
+}
+
+TEST(PlaylistTracksDiffTest, Move)
+{
+    checkDiff({{1, 2, 3, 4}, {2, 3, 4, 1}, 0, 4, 4});
+    checkDiff({{1, 2, 3, 4}, {4, 1, 2, 3}, 0, 4, 4});
+    checkDiff({{1, 2, 3, 4, 5}, {1, 3, 2, 4, 5}, 1, 3, 3});
+}
+
+TEST(PlaylistTracksDiffTest, PrefixSuffixOverlap)
+{
+    // The suffix can't reuse rows already matched by the prefix
+    checkDiff({{1, 1, 1}, {1, 1}, 2, 3, 2});
+    checkDiff({{1, 1}, {1, 1, 1}, 2, 2, 3});
+    checkDiff({{1, 2, 2, 3}, {1, 2, 3}, 2, 3, 2});
+    checkDiff({{1, 2, 3}, {1, 2, 2, 3}, 2, 2, 3});
+    checkDiff({{1, 2, 1, 2}, {1, 2}, 2, 4, 2});
+}
+
+TEST(PlaylistTracksDiffTest, StatementCount)
+{
+    const TrackIds saved{1, 2, 3, 4, 5, 6};
+
+    // Appending only inserts, in batches
+    const TrackIds appended{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(PlaylistTracksDiff(saved, appended).statementCount(saved, appended, 2), 2);
+
+    // Inserting at the front shifts the rest in one statement
+    const TrackIds prepended{0, 1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(PlaylistTracksDiff(saved, prepended).statementCount(saved, prepended, 2), 2);
+
+    // Removing from the middle deletes and shifts
+    const TrackIds removed{1, 2, 5, 6};
+    EXPECT_EQ(PlaylistTracksDiff(saved, removed).statementCount(saved, removed, 2), 2);
+
+    // Removing from the end only deletes
+    const TrackIds truncated{1, 2, 3};
+    EXPECT_EQ(PlaylistTracksDiff(saved, truncated).statementCount(saved, truncated, 2), 1);
+
+    // Moving the first track to the end updates every row
+    const TrackIds moved{2, 3, 4, 5, 6, 1};
+    EXPECT_EQ(PlaylistTracksDiff(saved, moved).statementCount(saved, moved, 2), 6);
+
+    // Rows which happen to match inside the changed range aren't updated
+    const TrackIds swapped{6, 2, 3, 4, 5, 1};
+    EXPECT_EQ(PlaylistTracksDiff(saved, swapped).statementCount(saved, swapped, 2), 2);
+}
+} // namespace Fooyin::Testing
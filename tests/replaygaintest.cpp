@@ -0,0 +1,67 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engine/replaygain.h"
+
+#include <core/track.h>
+
+#include <gtest/gtest.h>
+
+namespace Fooyin::Testing {
+class ReplayGainTest : public ::testing::Test
+{
+protected:
+    ReplayGainTest()
+        : m_track{QStringLiteral("/music/track.flac")}
+    {
+        m_track.addExtraTag(QStringLiteral("REPLAYGAIN_TRACK_GAIN"), QStringLiteral("-6.00 dB"));
+        m_track.addExtraTag(QStringLiteral("REPLAYGAIN_TRACK_PEAK"), QStringLiteral("0.9"));
+        m_track.addExtraTag(QStringLiteral("REPLAYGAIN_ALBUM_GAIN"), QStringLiteral("+6.00 dB"));
+        m_track.addExtraTag(QStringLiteral("REPLAYGAIN_ALBUM_PEAK"), QStringLiteral("0.8"));
+    }
+
+    Track m_track;
+};
+
+TEST_F(ReplayGainTest, Disabled)
+{
+    EXPECT_DOUBLE_EQ(ReplayGain::trackGain(m_track, ReplayGainType::Disabled, 0.0, false), 1.0);
+}
+
+TEST_F(ReplayGainTest, TrackGain)
+{
+    EXPECT_NEAR(ReplayGain::trackGain(m_track, ReplayGainType::Track, 0.0, false), 0.501, 0.001);
+    EXPECT_NEAR(ReplayGain::trackGain(m_track, ReplayGainType::Track, 6.0, false), 1.0, 0.001);
+}
+
+TEST_F(ReplayGainTest, AlbumGainPreventsClipping)
+{
+    EXPECT_NEAR(ReplayGain::trackGain(m_track, ReplayGainType::Album, 0.0, false), 1.995, 0.001);
+    EXPECT_DOUBLE_EQ(ReplayGain::trackGain(m_track, ReplayGainType::Album, 0.0, true), 1.0 / 0.8);
+}
+
+TEST_F(ReplayGainTest, FallsBackToTrackGain)
+{
+    m_track.removeExtraTag(QStringLiteral("REPLAYGAIN_ALBUM_GAIN"));
+    EXPECT_NEAR(ReplayGain::trackGain(m_track, ReplayGainType::Album, 0.0, false), 0.501, 0.001);
+
+    m_track.clearExtraTags();
+    EXPECT_DOUBLE_EQ(ReplayGain::trackGain(m_track, ReplayGainType::Album, 0.0, false), 1.0);
+}
+} // namespace Fooyin::Testing
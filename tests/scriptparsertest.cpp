@@ -126,4 +126,53 @@ TEST_F(ScriptParserTest, TrackListTest)
     EXPECT_EQ(u"00:05", m_parser.evaluate(QStringLiteral("%playtime%"), tracks));
     EXPECT_EQ(u"Pop / Rock", m_parser.evaluate(QStringLiteral("%genres%"), tracks));
 }
+
+TEST_F(ScriptParserTest, ExtraTagTest)
+{
+    Track track;
+    track.addExtraTag(QStringLiteral("MOOD"), QStringLiteral("Happy"));
+
+    EXPECT_EQ(u"Happy", m_parser.evaluate(QStringLiteral("%mood%"), track));
+}
+
+TEST_F(ScriptParserTest, UncompiledScriptTest)
+{
+    Track track;
+    track.setTitle(QStringLiteral("A Test"));
+    track.setTrackNumber(3);
+
+    auto script = m_parser.parse(QStringLiteral("$num(%track%,2). $if2(%album%,%title%)"));
+    EXPECT_EQ(u"03. A Test", m_parser.evaluate(script, track));
+
+    // Scripts without a compiled program are resolved when evaluated
+    script.program.reset();
+    EXPECT_EQ(u"03. A Test", m_parser.evaluate(script, track));
+}
+
+TEST_F(ScriptParserTest, ConstantFoldingTest)
+{
+    Track track;
+    track.setTitle(QStringLiteral("A Test"));
+
+    EXPECT_EQ(u"03 - A Test", m_parser.evaluate(QStringLiteral("$num($add(1,2),2) - %title%"), track));
+    EXPECT_EQ(u"true", m_parser.evaluate(QStringLiteral("[$if($strcmp(a,a),true)]"), track));
+    EXPECT_EQ(u"", m_parser.evaluate(QStringLiteral("[$if($strcmp(a,b),true)]"), track));
+}
+
+TEST_F(ScriptParserTest, CacheTest)
+{
+    ScriptCache cache;
+
+    Track track1;
+    track1.setTitle(QStringLiteral("First"));
+
+    EXPECT_EQ(u"First", m_parser.evaluate(QStringLiteral("$if2(%album%,%title%)"), track1, cache));
+    EXPECT_EQ(u"First - First", m_parser.evaluate(QStringLiteral("$if2(%album%,%title%) - %title%"), track1, cache));
+
+    Track track2;
+    track2.setTitle(QStringLiteral("Second"));
+
+    cache.clear();
+    EXPECT_EQ(u"Second", m_parser.evaluate(QStringLiteral("$if2(%album%,%title%)"), track2, cache));
+}
 } // namespace Fooyin::Testing
@@ -0,0 +1,106 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "library/trackavailability.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtConcurrent>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace Fooyin::Testing {
+class TrackAvailabilityTest : public ::testing::Test
+{
+protected:
+    [[nodiscard]] Track createTrack(int id, const QString& relativePath, bool create, bool enabled) const
+    {
+        const QString filepath = m_dir.filePath(relativePath);
+        if(create) {
+            QDir{}.mkpath(QFileInfo{filepath}.absolutePath());
+            QFile file{filepath};
+            file.open(QIODevice::WriteOnly);
+        }
+
+        Track track{filepath};
+        track.setId(id);
+        track.setIsEnabled(enabled);
+        return track;
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(TrackAvailabilityTest, ReportsChangedTracks)
+{
+    const TrackList tracks{
+        createTrack(1, QStringLiteral("a/1.flac"), true, true),   // Unchanged
+        createTrack(2, QStringLiteral("a/2.flac"), false, true),  // Removed
+        createTrack(3, QStringLiteral("b/3.flac"), true, false),  // Restored
+        createTrack(4, QStringLiteral("c/4.flac"), false, false), // Still missing
+        createTrack(5, QStringLiteral("d/5.flac"), false, true),  // Directory removed
+    };
+
+    auto future = QtConcurrent::run(
+        [&tracks](QPromise<TrackList>& promise) { TrackAvailability::checkTracks(promise, tracks); });
+
+    TrackList changedTracks;
+    for(const TrackList& batch : future.results()) {
+        changedTracks.insert(changedTracks.end(), batch.cbegin(), batch.cend());
+    }
+    std::ranges::sort(changedTracks, {}, &Track::id);
+
+    ASSERT_EQ(changedTracks.size(), 3);
+    EXPECT_EQ(changedTracks.at(0).id(), 2);
+    EXPECT_FALSE(changedTracks.at(0).isEnabled());
+    EXPECT_EQ(changedTracks.at(1).id(), 3);
+    EXPECT_TRUE(changedTracks.at(1).isEnabled());
+    EXPECT_EQ(changedTracks.at(2).id(), 5);
+    EXPECT_FALSE(changedTracks.at(2).isEnabled());
+}
+
+#ifdef Q_OS_UNIX
+TEST_F(TrackAvailabilityTest, BrokenSymlinkIsMissing)
+{
+    const Track target = createTrack(1, QStringLiteral("a/target.flac"), true, true);
+    const Track link   = createTrack(2, QStringLiteral("a/link.flac"), false, true);
+
+    ASSERT_TRUE(QFile::link(target.filepath(), link.filepath()));
+    ASSERT_TRUE(QFile::remove(target.filepath()));
+
+    const TrackList tracks{link};
+
+    auto future = QtConcurrent::run(
+        [&tracks](QPromise<TrackList>& promise) { TrackAvailability::checkTracks(promise, tracks); });
+
+    TrackList changedTracks;
+    for(const TrackList& batch : future.results()) {
+        changedTracks.insert(changedTracks.end(), batch.cbegin(), batch.cend());
+    }
+
+    ASSERT_EQ(changedTracks.size(), 1);
+    EXPECT_EQ(changedTracks.at(0).id(), 2);
+    EXPECT_FALSE(changedTracks.at(0).isEnabled());
+}
+#endif
+} // namespace Fooyin::Testing
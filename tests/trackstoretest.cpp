@@ -0,0 +1,120 @@
+/*
+ * Fooyin
+ * Copyright © 2024, Luke Taylor <LukeT1@proton.me>
+ *
+ * Fooyin is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Fooyin is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Fooyin.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "library/trackstore.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace {
+Fooyin::Track makeTrack(int id, const QString& hash)
+{
+    Fooyin::Track track{QStringLiteral("/music/%1.flac").arg(id)};
+    track.setId(id);
+    track.setHash(hash);
+    return track;
+}
+} // namespace
+
+namespace Fooyin::Testing {
+class TrackStoreTest : public ::testing::Test
+{
+protected:
+    TrackStoreTest()
+    {
+        m_store.setTracks({makeTrack(1, QStringLiteral("a")), makeTrack(2, QStringLiteral("b")),
+                           makeTrack(3, QStringLiteral("a"))});
+    }
+
+    TrackStore m_store;
+};
+
+TEST_F(TrackStoreTest, LookupById)
+{
+    EXPECT_EQ(m_store.trackForId(2).id(), 2);
+    EXPECT_FALSE(m_store.trackForId(4).isValid());
+
+    const TrackList tracks = m_store.tracksForIds({3, 4, 1});
+    ASSERT_EQ(tracks.size(), 2);
+    EXPECT_EQ(tracks.at(0).id(), 3);
+    EXPECT_EQ(tracks.at(1).id(), 1);
+}
+
+TEST_F(TrackStoreTest, LookupByHashAndPath)
+{
+    EXPECT_EQ(m_store.tracksForHash(QStringLiteral("a")).size(), 2);
+    EXPECT_TRUE(m_store.tracksForHash(QStringLiteral("c")).empty());
+    EXPECT_EQ(m_store.trackForFilepath(QStringLiteral("/music/2.flac")).id(), 2);
+}
+
+TEST_F(TrackStoreTest, UpdateReindexes)
+{
+    Track track = makeTrack(1, QStringLiteral("c"));
+    track.setFilePath(QStringLiteral("/music/moved.flac"));
+
+    EXPECT_EQ(m_store.updateTracks({track, makeTrack(5, QStringLiteral("d"))}).size(), 1);
+
+    EXPECT_EQ(m_store.tracks().front().filepath(), QStringLiteral("/music/moved.flac"));
+    EXPECT_EQ(m_store.tracksForHash(QStringLiteral("a")).size(), 1);
+    EXPECT_EQ(m_store.tracksForHash(QStringLiteral("c")).size(), 1);
+    EXPECT_FALSE(m_store.trackForFilepath(QStringLiteral("/music/1.flac")).isValid());
+    EXPECT_EQ(m_store.trackForFilepath(QStringLiteral("/music/moved.flac")).id(), 1);
+}
+
+TEST_F(TrackStoreTest, AddRemoveAndSort)
+{
+    m_store.addTracks({makeTrack(4, QStringLiteral("b"))});
+    EXPECT_EQ(m_store.tracksForHash(QStringLiteral("b")).size(), 2);
+
+    m_store.removeTracks({2});
+    EXPECT_EQ(m_store.size(), 3);
+    EXPECT_FALSE(m_store.contains(2));
+    EXPECT_EQ(m_store.trackForId(4).id(), 4);
+
+    TrackList reversed = m_store.tracks();
+    std::ranges::reverse(reversed);
+    m_store.setTracks(reversed);
+
+    EXPECT_EQ(m_store.tracks().front().id(), 4);
+    EXPECT_EQ(m_store.trackForId(1).id(), 1);
+    EXPECT_EQ(m_store.trackForFilepath(QStringLiteral("/music/3.flac")).id(), 3);
+}
+
+TEST_F(TrackStoreTest, SharesRepeatedStrings)
+{
+    // Built separately, so equal but not shared
+    Track track1 = makeTrack(5, QStringLiteral("e"));
+    track1.setAlbum(QString::fromLatin1("An Album"));
+    track1.setGenres({QString::fromLatin1("Rock")});
+
+    Track track2 = makeTrack(6, QStringLiteral("f"));
+    track2.setAlbum(QString::fromLatin1("An Album"));
+    track2.setGenres({QString::fromLatin1("Rock")});
+
+    ASSERT_FALSE(track1.album().isSharedWith(track2.album()));
+
+    const TrackList added = m_store.addTracks({track1, track2});
+    ASSERT_EQ(added.size(), 2);
+
+    EXPECT_TRUE(added.at(0).album().isSharedWith(added.at(1).album()));
+    EXPECT_TRUE(added.at(0).genres().isSharedWith(added.at(1).genres()));
+    EXPECT_EQ(m_store.trackForId(6).album(), u"An Album");
+}
+} // namespace Fooyin::Testing